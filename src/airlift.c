@@ -0,0 +1,513 @@
+/**
+ *  \file airlift.c (implementation file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  Embeddable simulation library (libairlift).
+ *
+ *  Defined operations:
+ *     \li filling a configuration with the default problem parameters
+ *     \li creation of a simulation from a configuration
+ *     \li registration of event callbacks
+ *     \li running the simulation with a selectable engine
+ *     \li fetching the results of the last run
+ *     \li destruction of a simulation.
+ *
+ *  Support operations for the engines (result and event recording, logging in the format of the generator)
+ *  are also implemented here.
+ */
+
+#define _GNU_SOURCE                                                                                /* fopencookie */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <errno.h>
+#include <zlib.h>
+
+#include "probConst.h"
+#include "airlift.h"
+#include "airliftInternal.h"
+
+/**
+ *  \brief Filling a configuration with the default problem parameters.
+ *
+ *  \param cfg pointer to the configuration to be filled
+ */
+
+void airliftDefaultConfig (AIRLIFT_CONFIG *cfg)
+{
+    memset (cfg, 0, sizeof (AIRLIFT_CONFIG));
+    cfg->nPassengers = N;
+    cfg->minFC       = MINFC;
+    cfg->maxFC       = MAXFC;
+    cfg->maxTravel   = MAXTRAVEL;
+    cfg->maxFlight   = MAXFLIGHT;
+    cfg->seed        = 1;
+    cfg->logFile     = NULL;
+    cfg->binDir      = NULL;
+    cfg->columnFile  = NULL;
+    cfg->logEventsOnly = 0;
+    cfg->samplePeriod = 0.0;
+    cfg->sampleFile  = NULL;
+}
+
+static char *dupString (const char *s)
+{
+    return (s == NULL) ? NULL : strdup (s);
+}
+
+/**
+ *  \brief Creation of a simulation.
+ *
+ *  \param cfg pointer to the configuration
+ *
+ *  \return simulation handle, upon success
+ *  \return NULL, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+AIRLIFT_SIM *airliftCreate (const AIRLIFT_CONFIG *cfg)
+{
+    AIRLIFT_SIM *sim;
+
+    unsigned int g;
+
+    if ((cfg == NULL) || (cfg->nPassengers == 0) || (cfg->maxFC == 0) || (cfg->minFC > cfg->maxFC) ||
+        (cfg->maxTravel < 0.0) || (cfg->maxFlight < 0.0) || (cfg->samplePeriod < 0.0) ||
+        ((cfg->samplePeriod > 0.0) && (cfg->sampleFile == NULL))) {
+        errno = EINVAL;
+        return NULL;
+    }
+    for (g = 0; g < AIRLIFT_MAXGROUP; g++)
+        if (!(cfg->groupDist[g] >= 0.0)) {
+            errno = EINVAL;
+            return NULL;
+        }
+    if ((sim = calloc (1, sizeof (AIRLIFT_SIM))) == NULL)
+        return NULL;
+    sim->cfg = *cfg;
+    sim->cfg.logFile = dupString (cfg->logFile);
+    sim->cfg.binDir = dupString (cfg->binDir);
+    sim->cfg.columnFile = NULL;
+    sim->cfg.sampleFile = dupString (cfg->sampleFile);
+    sim->rnd = cfg->seed;
+    sim->lastStat = malloc ((cfg->nPassengers + 2) * sizeof (unsigned int));
+    sim->passengerWait = calloc (cfg->nPassengers, sizeof (double));
+    sim->ops = airliftSelectOps (cfg);
+    if ((sim->lastStat == NULL) || (sim->passengerWait == NULL) || (airliftBuildLines (sim) == -1) ||
+        ((cfg->logFile != NULL) && (sim->cfg.logFile == NULL)) || ((cfg->binDir != NULL) && (sim->cfg.binDir == NULL)) ||
+        ((cfg->sampleFile != NULL) && (sim->cfg.sampleFile == NULL))) {
+        airliftDestroy (sim);
+        errno = ENOMEM;
+        return NULL;
+    }
+    if ((cfg->columnFile != NULL) && ((sim->col = airliftColCreate (cfg->columnFile)) == NULL)) {
+        int err = errno;
+
+        airliftDestroy (sim);
+        errno = err;
+        return NULL;
+    }
+
+    return sim;
+}
+
+/**
+ *  \brief Registration of the event callbacks.
+ *
+ *  \param sim simulation handle
+ *  \param cb pointer to the callbacks, NULL to remove them
+ */
+
+void airliftSetCallbacks (AIRLIFT_SIM *sim, const AIRLIFT_CALLBACKS *cb)
+{
+    if (cb == NULL)
+        memset (&sim->cb, 0, sizeof (AIRLIFT_CALLBACKS));
+    else sim->cb = *cb;
+}
+
+/**
+ *  \brief Running the simulation to its end.
+ *
+ *  \param sim simulation handle
+ *  \param engine engine to be used
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int airliftRun (AIRLIFT_SIM *sim, AIRLIFT_ENGINE engine)
+{
+    int stat;
+
+    if ((engine != AIRLIFT_ENGINE_EVENT) && (engine != AIRLIFT_ENGINE_PROCESS)) {  /* the last results are kept */
+        errno = EINVAL;
+        return -1;
+    }
+    airliftBeginRun (sim);
+    if (sim->col != NULL)
+        airliftColBeginRun (sim->col);
+    if (engine == AIRLIFT_ENGINE_EVENT)
+        stat = airliftRunEvent (sim);
+    else stat = airliftRunProcess (sim);
+    if ((stat == 0) && (sim->col != NULL))
+        stat = airliftColEndRun (sim->col);
+    if (stat == 0) {
+        sim->res.nPassengersInFlight = sim->nPassengersInFlight;
+        sim->res.passengerWait = sim->passengerWait;
+        sim->done = true;
+    }
+
+    return stat;
+}
+
+/**
+ *  \brief Fetching the results of the last run.
+ *
+ *  \param sim simulation handle
+ *  \param res pointer to the location where the results are stored
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when the simulation was not run (<tt>errno</tt> is set to <tt>EAGAIN</tt>)
+ */
+
+int airliftGetResult (const AIRLIFT_SIM *sim, AIRLIFT_RESULT *res)
+{
+    if (!sim->done) {
+        errno = EAGAIN;
+        return -1;
+    }
+    *res = sim->res;
+
+    return 0;
+}
+
+/**
+ *  \brief Destruction of a simulation.
+ *
+ *  \param sim simulation handle
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when the column file could not be completed (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int airliftDestroy (AIRLIFT_SIM *sim)
+{
+    int stat = 0;
+
+    if (sim == NULL)
+        return 0;
+    if (sim->log != NULL)
+        fclose (sim->log);
+    if (sim->samples != NULL)
+        fclose (sim->samples);
+    if (sim->col != NULL)
+        stat = airliftColFinish (sim->col);
+    free ((char *) sim->cfg.logFile);
+    free ((char *) sim->cfg.binDir);
+    free ((char *) sim->cfg.sampleFile);
+    free (sim->lastStat);
+    free (sim->passengerWait);
+    free (sim->nPassengersInFlight);
+    free (sim->header);
+    free (sim->line);
+    free (sim);
+
+    return stat;
+}
+
+/**
+ *  \brief Passengers travelling in groups.
+ *
+ *  \param cfg pointer to the configuration
+ *
+ *  \return true if some group size other than 1 has a weight
+ */
+
+bool airliftGrouped (const AIRLIFT_CONFIG *cfg)
+{
+    unsigned int g;
+
+    for (g = 1; g < AIRLIFT_MAXGROUP; g++)
+        if (cfg->groupDist[g] > 0.0)
+            return true;
+
+    return false;
+}
+
+/**
+ *  \brief Reset the results and the transition tracking before a run.
+ *
+ *  All entities start in state 0 (flying back, waiting for flight, going to airport).
+ *
+ *  \param sim simulation handle
+ */
+
+void airliftBeginRun (AIRLIFT_SIM *sim)
+{
+    memset (&sim->res, 0, sizeof (AIRLIFT_RESULT));
+    memset (sim->lastStat, 0, (sim->cfg.nPassengers + 2) * sizeof (unsigned int));
+    sim->done = false;
+}
+
+/**
+ *  \brief Record the number of passengers of a flight.
+ *
+ *  \param sim simulation handle
+ *  \param flight flight number (1 .. n)
+ *  \param nPassengers number of passengers on board
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when there is no memory to hold the flight
+ */
+
+int airliftRecordFlight (AIRLIFT_SIM *sim, unsigned int flight, unsigned int nPassengers)
+{
+    if (flight > sim->nFlightsCap) {
+        unsigned int cap = (sim->nFlightsCap == 0) ? 16 : sim->nFlightsCap;
+        unsigned int *arr;
+
+        while (cap < flight)
+            cap *= 2;
+        if ((arr = realloc (sim->nPassengersInFlight, cap * sizeof (unsigned int))) == NULL)
+            return -1;
+        sim->nPassengersInFlight = arr;
+        sim->nFlightsCap = cap;
+    }
+    sim->nPassengersInFlight[flight-1] = nPassengers;
+    if (flight > sim->res.nFlights)
+        sim->res.nFlights = flight;
+
+    return 0;
+}
+
+/**
+ *  \brief Report the state of one entity.
+ *
+ *  The state transition callback is called, and the event stored in the column file, only when the state of
+ *  the entity actually changed.
+ *
+ *  \param sim simulation handle
+ *  \param entity entity id
+ *  \param time time of the report (in microseconds), negative when not known
+ *  \param st pointer to the full state of the problem
+ */
+
+void airliftEmitState (AIRLIFT_SIM *sim, unsigned int entity, double time, const AIRLIFT_STATE *st)
+{
+    AIRLIFT_EVENT ev;
+    unsigned int state;
+
+    if (entity == AIRLIFT_PILOT)
+        state = st->pilotStat;
+    else if (entity == AIRLIFT_HOSTESS)
+        state = st->hostessStat;
+    else state = st->passengerStat[entity-AIRLIFT_PASSENGER (0)];
+
+    if (state == sim->lastStat[entity])
+        return;
+    sim->lastStat[entity] = state;
+    ev.seq = sim->res.nEvents++;
+    if ((sim->cb.stateChanged == NULL) && (sim->col == NULL))
+        return;
+
+    ev.time = time;
+    ev.entity = entity;
+    ev.state = state;
+    ev.nPassInQueue = st->nPassInQueue;
+    ev.nPassInFlight = st->nPassInFlight;
+    ev.totalPassBoarded = st->totalPassBoarded;
+    ev.nFlight = st->nFlight;
+    if (sim->col != NULL)
+        airliftColAppend (sim->col, &ev);
+    if (sim->cb.stateChanged != NULL)
+        sim->cb.stateChanged (sim->cb.ctx, &ev);
+}
+
+static void logHeader (AIRLIFT_SIM *sim)
+{
+    if (!sim->cfg.logEventsOnly)
+        fwrite (sim->header, 1, sim->headerLen, sim->log);
+}
+
+static ssize_t gzCookieWrite (void *cookie, const char *buf, size_t size)
+{
+    int n = gzwrite ((gzFile) cookie, buf, (unsigned int) size);
+
+    return (n <= 0) ? -1 : n;
+}
+
+static int gzCookieClose (void *cookie)
+{
+    return (gzclose ((gzFile) cookie) == Z_OK) ? 0 : -1;
+}
+
+/**
+ *  \brief Open the logging file, if any, and write its title and header.
+ *
+ *  A name ending in <tt>.gz</tt> gives a compressed (gzip) file.
+ *
+ *  \param sim simulation handle
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when the file can not be created (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int airliftLogOpen (AIRLIFT_SIM *sim)
+{
+    size_t len;
+
+    if (sim->cfg.logFile == NULL)
+        return 0;
+    len = strlen (sim->cfg.logFile);
+    if ((len > 3) && (strcmp (sim->cfg.logFile + len - 3, ".gz") == 0)) {
+        cookie_io_functions_t io = { NULL, gzCookieWrite, NULL, gzCookieClose };
+        gzFile gz;
+
+        if ((gz = gzopen (sim->cfg.logFile, "wb")) == NULL)
+            return -1;
+        if ((sim->log = fopencookie (gz, "w", io)) == NULL) {
+            gzclose (gz);
+            return -1;
+        }
+    }
+    else if ((sim->log = fopen (sim->cfg.logFile, "w")) == NULL)
+        return -1;
+    fprintf (sim->log, "%31cAir Lift - Description of the internal state\n\n", ' ');
+    logHeader (sim);
+
+    return 0;
+}
+
+/**
+ *  \brief Write the full state as a single line, unless the logging file holds only the events.
+ *
+ *  \param sim simulation handle
+ *  \param st pointer to the full state of the problem
+ */
+
+void airliftLogState (AIRLIFT_SIM *sim, const AIRLIFT_STATE *st)
+{
+    if ((sim->log != NULL) && !sim->cfg.logEventsOnly)
+        sim->ops->logState (sim, st);
+}
+
+/**
+ *  \brief Write an event line, optionally followed by the header.
+ *
+ *  \param sim simulation handle
+ *  \param header true if the header is to be written after the line
+ *  \param fmt format of the line (printf like)
+ */
+
+void airliftLogEvent (AIRLIFT_SIM *sim, bool header, const char *fmt, ...)
+{
+    va_list ap;
+
+    if (sim->log == NULL)
+        return;
+    va_start (ap, fmt);
+    vfprintf (sim->log, fmt, ap);
+    va_end (ap);
+    if (header)
+        logHeader (sim);
+}
+
+/**
+ *  \brief Write the summary of the air lift and close the logging file.
+ *
+ *  The duration of the air lift and the passenger waits are written, as the generator does, only when the
+ *  environment variable <tt>AIRLIFT_RESULT_TIMES</tt> is set (not empty).
+ *
+ *  \param sim simulation handle
+ */
+
+void airliftLogClose (AIRLIFT_SIM *sim)
+{
+    char *times = getenv ("AIRLIFT_RESULT_TIMES");
+    unsigned int f;
+
+    if (sim->log == NULL)
+        return;
+    fprintf (sim->log, "AirLift result\n");
+    fprintf (sim->log, "AirLift used %u Flights\n", sim->res.nFlights);
+    for (f = 0; f < sim->res.nFlights; f++)
+        fprintf (sim->log, "Flight %u took %2u passengers\n", f+1, sim->nPassengersInFlight[f]);
+    if ((times != NULL) && (*times != '\0')) {
+        fprintf (sim->log, "AirLift took %.0f us\n", sim->res.makespan);
+        for (f = 0; f < sim->cfg.nPassengers; f++)
+            fprintf (sim->log, "Passenger %02u waited %.0f us\n", f, sim->passengerWait[f]);
+    }
+    fclose (sim->log);
+    sim->log = NULL;
+}
+
+/**
+ *  \brief Open the samples file, if sampling is enabled, and write its header.
+ *
+ *  \param sim simulation handle
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when the file can not be created (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int airliftSampleOpen (AIRLIFT_SIM *sim)
+{
+    unsigned int p;
+
+    if (sim->cfg.samplePeriod <= 0.0)
+        return 0;
+    if ((sim->samples = fopen (sim->cfg.sampleFile, "w")) == NULL)
+        return -1;
+    fprintf (sim->samples, "# AirLift state samples, period %.0f us\n", sim->cfg.samplePeriod);
+    fprintf (sim->samples, "%10s %3s %3s %4s %4s %4s %3s ", "time", "PT", "HT", "InQ", "InF", "toB", "nF");
+    for (p = 0; p < sim->cfg.nPassengers; p++)
+        fprintf (sim->samples, " P%02u", p);
+    fprintf (sim->samples, "\n");
+    sim->nextSample = 0.0;
+
+    return 0;
+}
+
+/**
+ *  \brief Write a sample for every sampling instant before a given time.
+ *
+ *  The state holds since the last event, so every instant up to the next event is sampled from it.
+ *
+ *  \param sim simulation handle
+ *  \param time time of the next event (in microseconds)
+ *  \param st pointer to the full state of the problem
+ */
+
+void airliftSample (AIRLIFT_SIM *sim, double time, const AIRLIFT_STATE *st)
+{
+    unsigned int p;
+
+    if (sim->samples == NULL)
+        return;
+    for (; sim->nextSample < time; sim->nextSample += sim->cfg.samplePeriod) {
+        fprintf (sim->samples, "%10.0f %3u %3u %4u %4u %4u %3u ", sim->nextSample, st->pilotStat, st->hostessStat,
+                 st->nPassInQueue, st->nPassInFlight, st->totalPassBoarded, st->nFlight);
+        for (p = 0; p < sim->cfg.nPassengers; p++)
+            fprintf (sim->samples, "%4u", st->passengerStat[p]);
+        fprintf (sim->samples, "\n");
+    }
+}
+
+/**
+ *  \brief Write the samples up to the end of the run and close the samples file.
+ *
+ *  \param sim simulation handle
+ *  \param time end of the run (in microseconds)
+ *  \param st pointer to the full state of the problem
+ */
+
+void airliftSampleClose (AIRLIFT_SIM *sim, double time, const AIRLIFT_STATE *st)
+{
+    if (sim->samples == NULL)
+        return;
+    airliftSample (sim, time + sim->cfg.samplePeriod / 2, st);                      /* final state included */
+    fclose (sim->samples);
+    sim->samples = NULL;
+}
@@ -0,0 +1,282 @@
+/**
+ *  \file airlift.h (interface file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  Embeddable simulation library (libairlift).
+ *
+ *  The library allows a host process to run complete air lift simulations without going through the
+ *  <tt>probSemSharedMemAirLift</tt> generator.
+ *
+ *  Defined operations:
+ *     \li filling a configuration with the default problem parameters
+ *     \li creation of a simulation from a configuration
+ *     \li registration of event callbacks (state transition, flight departed, flight arrived)
+ *     \li running the simulation with a selectable engine
+ *     \li fetching the results of the last run
+ *     \li destruction of a simulation
+ *     \li running independent replications of a configuration with the vectorized engine.
+ *
+ *  Passengers may travel in groups (<tt>groupDist</tt>), the sizes of the groups being drawn at the start of each
+ *  run of the event engine: a group arrives as one unit, is checked by the hostess in a single handoff, boards only a
+ *  flight with room for all of it (groups are not larger than the flight capacity) and leaves the plane together.
+ *
+ *  Available engines:
+ *     \li <tt>AIRLIFT_ENGINE_EVENT</tt>: discrete event engine running the pilot, hostess and passengers life cycles
+ *         in the calling process, in simulated time
+ *     \li <tt>AIRLIFT_ENGINE_PROCESS</tt>: the SVIPC implementation, the intervening entities being generated as
+ *         separate processes (the problem size must match the one the entities were built with, and passengers travel
+ *         alone)
+ *     \li vectorized replication engine (<tt>airliftReplicate</tt>): many runs of the discrete event engine at once,
+ *         in the lanes of vector registers and in threads, giving only their results.
+ *
+ *  The state may also be sampled at a fixed period of simulated time by the event engine, as the SVIPC sampler
+ *  does in real time (<tt>AIRLIFT_SAMPLE</tt>); the process engine follows the environment of the SVIPC programs.
+ *
+ *  The header is self-contained and does not depend on the problem constants of the SVIPC implementation.
+ */
+
+#ifndef AIRLIFT_H_
+#define AIRLIFT_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \brief entity id of the pilot in events */
+#define  AIRLIFT_PILOT               0u
+
+/** \brief entity id of the hostess in events */
+#define  AIRLIFT_HOSTESS             1u
+
+/** \brief entity id of passenger <tt>p</tt> in events */
+#define  AIRLIFT_PASSENGER(p)        (2u + (unsigned int) (p))
+
+/** \brief largest group of passengers travelling together */
+#define  AIRLIFT_MAXGROUP            8u
+
+/**
+ *  \brief Simulation engine selector.
+ */
+typedef enum
+{ /** \brief in-process discrete event engine (simulated time) */
+    AIRLIFT_ENGINE_EVENT,
+    /** \brief SVIPC processes engine (real time) */
+    AIRLIFT_ENGINE_PROCESS
+
+} AIRLIFT_ENGINE;
+
+/**
+ *  \brief Definition of <em>simulation configuration</em> data type.
+ */
+typedef struct
+{ /** \brief number of passengers */
+    unsigned int nPassengers;
+    /** \brief min flight capacity */
+    unsigned int minFC;
+    /** \brief max flight capacity */
+    unsigned int maxFC;
+    /** \brief max travel time to the airport (in microseconds) */
+    double maxTravel;
+    /** \brief max flight time (in microseconds) */
+    double maxFlight;
+    /** \brief seed of the random generator (event engine) */
+    unsigned long seed;
+    /** \brief name of the logging file, written in the format of the generator (gzip compressed if it ends in .gz);
+     *         NULL for no log */
+    const char *logFile;
+    /** \brief directory holding the pilot, hostess and passenger programs (process engine); NULL for "." */
+    const char *binDir;
+    /** \brief name of the column file storing the events of every run (airliftColumns.h); NULL for none */
+    const char *columnFile;
+    /** \brief non zero for a logging file holding only the events and the summary, without the state lines */
+    int logEventsOnly;
+    /** \brief sampling period of the state (in microseconds of simulated time, event engine); 0 for none */
+    double samplePeriod;
+    /** \brief name of the file receiving the state samples, in the format of the SVIPC sampler */
+    const char *sampleFile;
+    /** \brief weight of each group size (1 .. AIRLIFT_MAXGROUP) of the passengers travelling together (event
+     *         engine); all 0 for passengers travelling alone */
+    double groupDist[AIRLIFT_MAXGROUP];
+
+} AIRLIFT_CONFIG;
+
+/**
+ *  \brief Definition of <em>state transition event</em> data type.
+ */
+typedef struct
+{ /** \brief sequence number of the event within the run */
+    unsigned long seq;
+    /** \brief time of the event since the start of the run (in microseconds), negative when not known */
+    double time;
+    /** \brief entity whose state changed (AIRLIFT_PILOT, AIRLIFT_HOSTESS or AIRLIFT_PASSENGER(p)) */
+    unsigned int entity;
+    /** \brief new state of the entity */
+    unsigned int state;
+    /** \brief number of passengers waiting */
+    unsigned int nPassInQueue;
+    /** \brief number of passengers flying */
+    unsigned int nPassInFlight;
+    /** \brief total number of passengers already boarded */
+    unsigned int totalPassBoarded;
+    /** \brief flight number */
+    unsigned int nFlight;
+
+} AIRLIFT_EVENT;
+
+/** \brief state transition callback */
+typedef void (*AIRLIFT_STATE_CB) (void *ctx, const AIRLIFT_EVENT *ev);
+
+/** \brief flight callback: flight number, number of passengers on board and time of the event */
+typedef void (*AIRLIFT_FLIGHT_CB) (void *ctx, unsigned int flight, unsigned int nPassengers, double time);
+
+/**
+ *  \brief Definition of <em>event callbacks</em> data type.
+ *
+ *  Any of the callbacks may be NULL.
+ */
+typedef struct
+{ /** \brief called on every state transition of an entity */
+    AIRLIFT_STATE_CB stateChanged;
+    /** \brief called when a flight departs */
+    AIRLIFT_FLIGHT_CB flightDeparted;
+    /** \brief called when a flight arrives at destination */
+    AIRLIFT_FLIGHT_CB flightArrived;
+    /** \brief user context passed to every callback */
+    void *ctx;
+
+} AIRLIFT_CALLBACKS;
+
+/**
+ *  \brief Definition of <em>simulation result</em> data type.
+ */
+typedef struct
+{ /** \brief number of flights used */
+    unsigned int nFlights;
+    /** \brief number of passengers at each flight (nFlights entries, owned by the simulation) */
+    const unsigned int *nPassengersInFlight;
+    /** \brief total number of passengers boarded */
+    unsigned int totalPassBoarded;
+    /** \brief duration of the run (in microseconds): simulated for the event engine, wall clock otherwise */
+    double makespan;
+    /** \brief number of state transition events */
+    unsigned long nEvents;
+    /** \brief time each passenger waited in queue, in microseconds (nPassengers entries, owned by the simulation) */
+    const double *passengerWait;
+    /** \brief number of groups checked by the hostess, each in a single handoff (nPassengers without groups) */
+    unsigned int nGroups;
+    /** \brief number of semaphore operations (event engine, 0 otherwise) */
+    unsigned long nSemOps;
+    /** \brief time spent boarding, from the pilot signaling ready for boarding to the departure, over every flight
+     *         (in microseconds; event and vectorized engines, 0 otherwise) */
+    double boardingTime;
+
+} AIRLIFT_RESULT;
+
+/** \brief replication callback: replication number (its seed being the one of the configuration plus it) and its
+ *         results, valid during the call only */
+typedef void (*AIRLIFT_REPLICATION_CB) (void *ctx, unsigned long run, const AIRLIFT_RESULT *res);
+
+/** \brief opaque simulation handle */
+typedef struct airliftSim AIRLIFT_SIM;
+
+/**
+ *  \brief Filling a configuration with the default problem parameters.
+ *
+ *  \param cfg pointer to the configuration to be filled
+ */
+
+extern void airliftDefaultConfig (AIRLIFT_CONFIG *cfg);
+
+/**
+ *  \brief Creation of a simulation.
+ *
+ *  The configuration is copied. The function fails if the configuration is not valid
+ *  (no passengers, <tt>minFC</tt> greater than <tt>maxFC</tt>, null capacity or negative group weights).
+ *
+ *  \param cfg pointer to the configuration
+ *
+ *  \return simulation handle, upon success
+ *  \return NULL, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+extern AIRLIFT_SIM *airliftCreate (const AIRLIFT_CONFIG *cfg);
+
+/**
+ *  \brief Registration of the event callbacks.
+ *
+ *  \param sim simulation handle
+ *  \param cb pointer to the callbacks, NULL to remove them
+ */
+
+extern void airliftSetCallbacks (AIRLIFT_SIM *sim, const AIRLIFT_CALLBACKS *cb);
+
+/**
+ *  \brief Running the simulation to its end.
+ *
+ *  The process engine delivers the callbacks after the entities terminated, in the order of the log.
+ *  Successive runs of the event engine on the same simulation continue its random sequence, so they differ;
+ *  each run is appended to the column file, if any. An unknown engine is refused (<tt>EINVAL</tt>) before anything
+ *  is changed, the results of the last run being kept.
+ *
+ *  \param sim simulation handle
+ *  \param engine engine to be used
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+extern int airliftRun (AIRLIFT_SIM *sim, AIRLIFT_ENGINE engine);
+
+/**
+ *  \brief Fetching the results of the last run.
+ *
+ *  \param sim simulation handle
+ *  \param res pointer to the location where the results are stored
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when the simulation was not run (<tt>errno</tt> is set to <tt>EAGAIN</tt>)
+ */
+
+extern int airliftGetResult (const AIRLIFT_SIM *sim, AIRLIFT_RESULT *res);
+
+/**
+ *  \brief Destruction of a simulation.
+ *
+ *  The column file, if any, is completed.
+ *
+ *  \param sim simulation handle
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when the column file could not be completed (the actual situation is reported in <tt>errno</tt>);
+ *          the simulation is destroyed anyway
+ */
+
+extern int airliftDestroy (AIRLIFT_SIM *sim);
+
+/**
+ *  \brief Running independent replications of a configuration with the vectorized engine.
+ *
+ *  Replication <tt>r</tt> gives the results of the discrete event engine run with seed <tt>cfg->seed + r</tt>
+ *  (without the state transition events, <tt>nEvents</tt> and <tt>nSemOps</tt> being 0); passengers travelling in
+ *  groups are not supported (<tt>EINVAL</tt>). The results are delivered in order of
+ *  replication, by the calling thread. The logging, column and samples files of the configuration are ignored.
+ *
+ *  \param cfg pointer to the configuration
+ *  \param nRuns number of replications
+ *  \param nThreads number of threads running them (at least one, the calling thread included)
+ *  \param cb callback receiving the results of each replication
+ *  \param ctx user context passed to the callback
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+extern int airliftReplicate (const AIRLIFT_CONFIG *cfg, unsigned long nRuns, unsigned int nThreads,
+                             AIRLIFT_REPLICATION_CB cb, void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AIRLIFT_H_ */
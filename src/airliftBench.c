@@ -0,0 +1,146 @@
+/**
+ *  \file airliftBench.c (implementation file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  Benchmark driver.
+ *
+ *  Runs a representative workload and reports the processor time it took:
+ *    \li simulations carried out by the discrete event engine of the library, writing their logging file
+ *    \li simulations carried out by the SVIPC processes engine of the library (pilot, hostess and passenger programs)
+ *    \li runs of the generator program.
+ *
+ *  Since the SVIPC simulations mostly sleep, processor time (of this process and of its children) is reported
+ *  rather than elapsed time. It is also the training workload of the profile guided build.
+ *
+ *  Options:
+ *    \li <tt>-n runs</tt>: number of event engine runs (default 2000)
+ *    \li <tt>-p runs</tt>: number of process engine runs (default 10)
+ *    \li <tt>-g runs</tt>: number of generator runs (default 10)
+ *    \li <tt>-N passengers -m min -M max</tt>: problem size of the event engine runs (default: probConst.h)
+ *    \li <tt>-l file</tt>: logging file of the event engine runs (default /dev/null).
+ *
+ *  It must be run in the directory holding the programs.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+
+#include "airlift.h"
+
+/** \brief name of generator program */
+#define   GENERATOR     "./probSemSharedMemAirLift"
+
+/** \brief processor time of this process (in seconds) */
+static double selfTime (void)
+{
+    struct timespec t;
+
+    clock_gettime (CLOCK_PROCESS_CPUTIME_ID, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+/** \brief processor time of the terminated children (in seconds) */
+static double childrenTime (void)
+{
+    struct rusage ru;
+
+    getrusage (RUSAGE_CHILDREN, &ru);
+    return ru.ru_utime.tv_sec + ru.ru_stime.tv_sec + (ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) * 1e-6;
+}
+
+/**
+ *  \brief Main program.
+ */
+
+int main (int argc, char *argv[])
+{
+    AIRLIFT_CONFIG cfg;
+    AIRLIFT_SIM *sim;
+    unsigned int nEvent = 2000, nProcess = 10, nGenerator = 10;
+    unsigned int i;
+    double t0, tEvent, tProcess, tGenerator;
+    int opt, status;
+    pid_t pid;
+
+    airliftDefaultConfig (&cfg);
+    cfg.logFile = "/dev/null";
+    while ((opt = getopt (argc, argv, "n:p:g:N:m:M:l:")) != -1) {
+        switch (opt) {
+            case 'n': nEvent = (unsigned int) atoi (optarg); break;
+            case 'p': nProcess = (unsigned int) atoi (optarg); break;
+            case 'g': nGenerator = (unsigned int) atoi (optarg); break;
+            case 'N': cfg.nPassengers = (unsigned int) atoi (optarg); break;
+            case 'm': cfg.minFC = (unsigned int) atoi (optarg); break;
+            case 'M': cfg.maxFC = (unsigned int) atoi (optarg); break;
+            case 'l': cfg.logFile = optarg; break;
+            default:
+                fprintf (stderr, "USAGE: %s [-n runs] [-p runs] [-g runs] [-N passengers] [-m min] [-M max] "
+                                 "[-l log]\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+
+    /* discrete event engine */
+
+    t0 = selfTime ();
+    for (i = 0; i < nEvent; i++) {
+        cfg.seed = i + 1;
+        if (((sim = airliftCreate (&cfg)) == NULL) || (airliftRun (sim, AIRLIFT_ENGINE_EVENT) == -1)) {
+            perror ("error on an event engine run");
+            return EXIT_FAILURE;
+        }
+        airliftDestroy (sim);
+    }
+    tEvent = selfTime () - t0;
+    printf ("event engine    : %6u runs  N=%-6u %9.3f s  %10.1f us/run\n", nEvent, cfg.nPassengers, tEvent,
+            (nEvent == 0) ? 0.0 : tEvent * 1e6 / nEvent);
+
+    /* SVIPC processes engine */
+
+    airliftDefaultConfig (&cfg);
+    cfg.logFile = "/dev/null";
+    t0 = selfTime () + childrenTime ();
+    for (i = 0; i < nProcess; i++) {
+        if (((sim = airliftCreate (&cfg)) == NULL) || (airliftRun (sim, AIRLIFT_ENGINE_PROCESS) == -1)) {
+            perror ("error on a process engine run");
+            return EXIT_FAILURE;
+        }
+        airliftDestroy (sim);
+    }
+    tProcess = selfTime () + childrenTime () - t0;
+    printf ("process engine  : %6u runs  N=%-6u %9.3f s  %10.1f us/run\n", nProcess, cfg.nPassengers, tProcess,
+            (nProcess == 0) ? 0.0 : tProcess * 1e6 / nProcess);
+
+    /* generator */
+
+    t0 = childrenTime ();
+    for (i = 0; i < nGenerator; i++) {
+        if ((pid = fork ()) < 0) {
+            perror ("error on the fork operation for the generator");
+            return EXIT_FAILURE;
+        }
+        if (pid == 0) {
+            execl (GENERATOR, GENERATOR, "/dev/null", NULL);
+            perror ("error on the generation of the generator process");
+            _exit (EXIT_FAILURE);
+        }
+        if ((waitpid (pid, &status, 0) == -1) || !WIFEXITED (status) || (WEXITSTATUS (status) != EXIT_SUCCESS)) {
+            fprintf (stderr, "generator run failed\n");
+            return EXIT_FAILURE;
+        }
+    }
+    tGenerator = childrenTime () - t0;
+    printf ("generator       : %6u runs  N=%-6u %9.3f s  %10.1f us/run\n", nGenerator, cfg.nPassengers, tGenerator,
+            (nGenerator == 0) ? 0.0 : tGenerator * 1e6 / nGenerator);
+
+    printf ("cpu time: %.6f s\n", tEvent + tProcess + tGenerator);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,174 @@
+/**
+ *  \file airliftCausal.c (implementation file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  Causal profiler.
+ *
+ *  Runs the air lift (the generator in the current directory) with every lifecycle phase, and the hold time of the
+ *  critical region, virtually sped up in turn (<tt>AIRLIFT_CAUSAL</tt>, see causal.h) by increasing amounts, and
+ *  reports the resulting makespan and throughput against a baseline run at a speedup of 0 (same instrumentation,
+ *  no delay), followed by the targets ranked by the makespan reduction they bring per percent of speedup: the
+ *  places where an optimization would actually pay off.
+ *
+ *  Usage: <tt>airliftCausal [-r runs per point] [-s speedup step (percent)] [-g generator]</tt>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "probConst.h"
+#include "phaseCounters.h"
+
+/** \brief number of targets: lifecycle phases and critical region */
+#define  NTARGETS        (NPHASES + 1)
+
+/** \brief maximum number of speedups per target */
+#define  MAXSPEEDUPS     100
+
+/**
+ *  \brief Definition of <em>target profile</em> data type.
+ */
+typedef struct
+{ /** \brief target name */
+    const char *name;
+    /** \brief mean virtual makespan at each speedup (microseconds) */
+    double makespan[MAXSPEEDUPS];
+    /** \brief mean throughput at each speedup (passengers per second) */
+    double throughput[MAXSPEEDUPS];
+    /** \brief makespan reduction (percent) per percent of speedup */
+    double slope;
+
+} PROFILE;
+
+static const char *gen = "./probSemSharedMemAirLift";
+
+/* one run of the air lift with a target sped up: virtual makespan and passengers taken, false on failure */
+static bool runOnce (const char *target, unsigned int speedup, unsigned long long *makespan,
+                     unsigned int *passengers)
+{
+    char nFic[] = "/tmp/airliftCausalXXXXXX", spec[64], line[256];
+    unsigned long long v;
+    unsigned int f, n;
+    int fd, status;
+    pid_t pid;
+    FILE *fic;
+
+    if ((fd = mkstemp (nFic)) == -1)
+        return false;
+    close (fd);
+    snprintf (spec, sizeof (spec), "%s:%u", target, speedup);
+    if ((pid = fork ()) == -1) {
+        unlink (nFic);
+        return false;
+    }
+    if (pid == 0) {
+        setenv ("AIRLIFT_CAUSAL", spec, 1);
+        execl (gen, gen, nFic, NULL);
+        perror (gen);
+        _exit (EXIT_FAILURE);
+    }
+    if ((waitpid (pid, &status, 0) == -1) || !WIFEXITED (status) || (WEXITSTATUS (status) != EXIT_SUCCESS) ||
+        ((fic = fopen (nFic, "r")) == NULL)) {
+        unlink (nFic);
+        return false;
+    }
+    *makespan = *passengers = 0;
+    while (fgets (line, sizeof (line), fic) != NULL)
+        if (sscanf (line, "AirLift virtual makespan %llu us", &v) == 1)
+            *makespan = v;
+        else if (sscanf (line, "Flight %u took %u passengers", &f, &n) == 2)
+            *passengers += n;
+    fclose (fic);
+    unlink (nFic);
+
+    return *makespan != 0;
+}
+
+/* mean makespan and throughput of a point */
+static bool runPoint (const char *target, unsigned int speedup, unsigned int nRuns, double *makespan,
+                      double *throughput)
+{
+    unsigned long long m;
+    unsigned int r, p;
+
+    *makespan = *throughput = 0.0;
+    for (r = 0; r < nRuns; r++) {
+        if (!runOnce (target, speedup, &m, &p)) {
+            fprintf (stderr, "error on the run of %s sped up %u%%\n", target, speedup);
+            return false;
+        }
+        *makespan += (double) m / nRuns;
+        *throughput += 1e6 * p / m / nRuns;
+    }
+
+    return true;
+}
+
+static int bySlope (const void *a, const void *b)
+{
+    double sa = ((const PROFILE *) a)->slope, sb = ((const PROFILE *) b)->slope;
+
+    return (sa < sb) - (sa > sb);
+}
+
+/**
+ *  \brief Main program.
+ */
+
+int main (int argc, char *argv[])
+{
+    static PROFILE prof[NTARGETS];
+    unsigned int nRuns = 5, step = 25, nSpeedups, t, k;
+    double base, baseThroughput, sxy, sxx;
+    int opt;
+
+    while ((opt = getopt (argc, argv, "r:s:g:")) != -1) {
+        switch (opt) {
+            case 'r': nRuns = (unsigned int) atoi (optarg); break;
+            case 's': step = (unsigned int) atoi (optarg); break;
+            case 'g': gen = optarg; break;
+            default:
+                fprintf (stderr, "USAGE: %s [-r runs per point] [-s speedup step (percent)] [-g generator]\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    if ((nRuns == 0) || (step == 0) || (step > 100)) {
+        fprintf (stderr, "%s: runs per point and speedup step (1 .. 100) must be positive\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    nSpeedups = 100 / step;
+
+    if (!runPoint (phaseName (0), 0, nRuns, &base, &baseThroughput))
+        return EXIT_FAILURE;
+    printf ("# causal profile: %u runs per point, baseline makespan %.0f us, throughput %.1f passengers/s\n", nRuns,
+            base, baseThroughput);
+    printf ("%-24s %7s %10s %8s %11s\n", "target", "speedup", "makespan", "change", "throughput");
+    for (t = 0; t < NTARGETS; t++) {
+        prof[t].name = (t < NPHASES) ? phaseName (t) : "mutex";
+        sxy = sxx = 0.0;
+        for (k = 0; k < nSpeedups; k++) {
+            unsigned int s = (k + 1) * step;
+
+            if (!runPoint (prof[t].name, s, nRuns, &prof[t].makespan[k], &prof[t].throughput[k]))
+                return EXIT_FAILURE;
+            printf ("%-24s %6u%% %10.0f %+7.1f%% %11.1f\n", prof[t].name, s, prof[t].makespan[k],
+                    100.0 * (prof[t].makespan[k] - base) / base, prof[t].throughput[k]);
+            sxy += s * 100.0 * (base - prof[t].makespan[k]) / base;
+            sxx += (double) s * s;
+        }
+        prof[t].slope = sxy / sxx;                                       /* least squares line through the origin */
+    }
+
+    qsort (prof, NTARGETS, sizeof (PROFILE), bySlope);
+    printf ("\n# ranking: makespan reduction (percent) per percent of virtual speedup\n");
+    for (t = 0; t < NTARGETS; t++)
+        printf ("%2u %-24s %+7.3f\n", t + 1, prof[t].name, prof[t].slope);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,594 @@
+/**
+ *  \file airliftCol.c (implementation file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  Column file tool.
+ *
+ *  Commands:
+ *    \li <tt>record file [-n runs] [-N passengers] [-m min] [-M max] [-s seed] [-p]</tt>: runs simulations with the
+ *        library (event engine, process engine with <tt>-p</tt>) storing their events in a column file
+ *    \li <tt>info file</tt>: lists the runs stored, with their rows, flights and encoded column sizes
+ *    \li <tt>stat file column [-r run] [-f flight]</tt>: count, mean, min and max of a column, over every run or a
+ *        single one and over every row or the rows of a single flight (e.g. <tt>stat runs.acol queue -f 3</tt> is the
+ *        mean queue depth during flight 3)
+ *    \li <tt>diff fileA fileB [-r run] [-n runs listed]</tt>: compares the timelines of two column files run by run
+ *        (e.g. recorded before and after a change, or by both engines, with the same seed), see below.
+ *
+ *  Aggregates only decode the column asked for (and the flight index), the other columns are not read.
+ *
+ *  The timelines compared are aligned by entity and transition: the <tt>k</tt>-th transition of an entity in one
+ *  is matched with its <tt>k</tt>-th transition in the other. For each run, the entities whose transitions diverge
+ *  (another state or flight, or a transition missing) are counted, the first divergence in the order of the first
+ *  timeline is shown, and so is the first aligned transition shifted in time; only the first <tt>-n</tt> runs (10
+ *  by default) are listed, whether they diverge or not, the others being only counted. Over every run, the mean
+ *  duration of each phase (the stay of a role in a state: boarding, flight, deboarding, queue wait, ...) and the
+ *  mean latency of each handoff (the transition of a role waking up another, from the latest transition of the
+ *  first into its state) are compared, the handoffs slowed down the most first. Events are timed in simulated time by the event
+ *  engine and in real time by the process engine; runs without times are only aligned.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <math.h>
+
+#include "probConst.h"
+#include "airlift.h"
+#include "airliftColumns.h"
+
+static int usage (const char *prog)
+{
+    fprintf (stderr, "USAGE: %s record file [-n runs] [-N passengers] [-m min] [-M max] [-s seed] [-p]\n"
+                     "       %s info file\n"
+                     "       %s stat file column [-r run] [-f flight]\n"
+                     "       %s diff fileA fileB [-r run] [-n runs listed]\n", prog, prog, prog, prog);
+    return EXIT_FAILURE;
+}
+
+static int cmdRecord (int argc, char *argv[], const char *file)
+{
+    AIRLIFT_CONFIG cfg;
+    AIRLIFT_SIM *sim;
+    AIRLIFT_ENGINE engine = AIRLIFT_ENGINE_EVENT;
+    unsigned int nRuns = 100, i;
+    int opt;
+
+    airliftDefaultConfig (&cfg);
+    while ((opt = getopt (argc, argv, "n:N:m:M:s:p")) != -1) {
+        switch (opt) {
+            case 'n': nRuns = (unsigned int) atoi (optarg); break;
+            case 'N': cfg.nPassengers = (unsigned int) atoi (optarg); break;
+            case 'm': cfg.minFC = (unsigned int) atoi (optarg); break;
+            case 'M': cfg.maxFC = (unsigned int) atoi (optarg); break;
+            case 's': cfg.seed = strtoul (optarg, NULL, 10); break;
+            case 'p': engine = AIRLIFT_ENGINE_PROCESS; break;
+            default: return usage (argv[0]);
+        }
+    }
+    cfg.columnFile = file;
+    if ((sim = airliftCreate (&cfg)) == NULL) {
+        perror (file);
+        return EXIT_FAILURE;
+    }
+    for (i = 0; i < nRuns; i++) {
+        if (airliftRun (sim, engine) == -1) {
+            perror ("error on a simulation run");
+            airliftDestroy (sim);
+            return EXIT_FAILURE;
+        }
+    }
+    if (airliftDestroy (sim) == -1) {
+        perror (file);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+static int cmdInfo (AIRLIFT_COL_READER *rd)
+{
+    AIRLIFT_COL_RUN ri;
+    unsigned int r, c;
+    uint64_t rows = 0, bytes = 0;
+
+    printf ("%5s %8s %7s", "run", "rows", "flights");
+    for (c = 0; c < AIRLIFT_NCOLS; c++)
+        printf (" %8s", airliftColName (c));
+    printf ("\n");
+    for (r = 0; r < airliftColRuns (rd); r++) {
+        airliftColRunInfo (rd, r, &ri);
+        printf ("%5u %8llu %7u", r, (unsigned long long) ri.nRows, ri.nFlights);
+        for (c = 0; c < AIRLIFT_NCOLS; c++) {
+            printf (" %8llu", (unsigned long long) ri.colBytes[c]);
+            bytes += ri.colBytes[c];
+        }
+        printf ("\n");
+        rows += ri.nRows;
+    }
+    printf ("%u runs, %llu rows, %llu encoded bytes (%.2f bytes/row, %zu raw)\n", airliftColRuns (rd),
+            (unsigned long long) rows, (unsigned long long) bytes, (rows == 0) ? 0.0 : (double) bytes / rows,
+            AIRLIFT_NCOLS * sizeof (int64_t));
+
+    return EXIT_SUCCESS;
+}
+
+static int cmdStat (int argc, char *argv[], AIRLIFT_COL_READER *rd, const char *column)
+{
+    AIRLIFT_COL_RUN ri;
+    int64_t *val = NULL, min = 0, max = 0;
+    uint64_t n = 0, first, count, k;
+    double sum = 0.0;
+    unsigned int col, r, rFirst = 0, rLast = airliftColRuns (rd), flight = 0;
+    int opt;
+
+    for (col = 0; col < AIRLIFT_NCOLS; col++)
+        if (strcmp (airliftColName (col), column) == 0)
+            break;
+    if (col == AIRLIFT_NCOLS) {
+        fprintf (stderr, "%s: unknown column\n", column);
+        return EXIT_FAILURE;
+    }
+    while ((opt = getopt (argc, argv, "r:f:")) != -1) {
+        switch (opt) {
+            case 'r': rFirst = (unsigned int) atoi (optarg); rLast = rFirst + 1; break;
+            case 'f': flight = (unsigned int) atoi (optarg); break;
+            default: return usage (argv[0]);
+        }
+    }
+
+    for (r = rFirst; r < rLast; r++) {
+        int64_t *v;
+
+        if (airliftColRunInfo (rd, r, &ri) == -1) {
+            perror ("error on the run number");
+            return EXIT_FAILURE;
+        }
+        if ((v = realloc (val, (ri.nRows + 1) * sizeof (int64_t))) == NULL) {
+            perror ("error on allocating the column");
+            free (val);
+            return EXIT_FAILURE;
+        }
+        val = v;
+        if (airliftColRead (rd, r, col, val) == -1) {
+            perror ("error on reading the column");
+            free (val);
+            return EXIT_FAILURE;
+        }
+        first = 0;
+        count = ri.nRows;
+        if ((flight != 0) && (airliftColFlight (rd, r, flight, &first, &count) == -1))
+            continue;                                                         /* run without such a flight */
+        for (k = first; k < first + count; k++) {
+            if ((n == 0) || (val[k] < min))
+                min = val[k];
+            if ((n == 0) || (val[k] > max))
+                max = val[k];
+            sum += val[k];
+            n++;
+        }
+    }
+    free (val);
+
+    printf ("%s: n %llu  mean %.3f  min %lld  max %lld\n", column, (unsigned long long) n, (n == 0) ? 0.0 : sum / n,
+            (long long) min, (long long) max);
+
+    return EXIT_SUCCESS;
+}
+
+/** \brief largest number of states of a role */
+#define  NSTATES         5
+
+/** \brief phases: stay of each role in each of its states, until its next transition (NULL for a final state) */
+static const char *phaseName[NROLES][NSTATES] = {
+    { "pilot: flight back", "pilot: ready for boarding", "pilot: boarding", "pilot: flight", "pilot: deboarding" },
+    { "hostess: wait for flight", "hostess: wait for passenger", "hostess: check passport", "hostess: ready to flight",
+      NULL },
+    { "passenger: travel", "passenger: queue wait", "passenger: on board", NULL, NULL }
+};
+
+/**
+ *  \brief Definition of <em>handoff</em> data type.
+ *
+ *  Transition of a role waking up another one, timed from the latest transition of the first into its state, or
+ *  from the previous transition of the entity woken up if later (it was busy, not waiting), to the transition of
+ *  the second.
+ */
+typedef struct
+{ /** \brief name */
+    const char *name;
+    /** \brief role and new state of the signalling transition */
+    unsigned int fromRole, fromState;
+    /** \brief role and new state of the transition woken up */
+    unsigned int toRole, toState;
+    /** \brief the signalling transition wakes up a single transition (else every one until the next signal) */
+    bool once;
+
+} HANDOFF;
+
+static const HANDOFF handoff[] = {
+    { "pilot -> hostess: ready for boarding",   0, READY_FOR_BOARDING, 1, WAIT_FOR_PASSENGER, true },
+    { "passenger -> hostess: in queue",         2, IN_QUEUE,           1, CHECK_PASSPORT,     false },
+    { "hostess -> passenger: passport checked", 1, CHECK_PASSPORT,     2, IN_FLIGHT,          true },
+    { "hostess -> pilot: ready to flight",      1, READY_TO_FLIGHT,    0, FLYING,             true },
+    { "pilot -> passenger: arrived",            0, DROPING_PASSENGERS, 2, AT_DESTINATION,     false },
+    { "passenger -> pilot: plane empty",        2, AT_DESTINATION,     0, FLYING_BACK,        true }
+};
+
+/** \brief number of handoffs */
+#define  NHANDOFFS       (sizeof (handoff) / sizeof (handoff[0]))
+
+/**
+ *  \brief Definition of <em>timeline</em> data type.
+ *
+ *  Every column of a stored run.
+ */
+typedef struct
+{ /** \brief number of rows */
+    uint64_t n;
+    /** \brief columns */
+    int64_t *col[AIRLIFT_NCOLS];
+    /** \brief number of entities (largest entity id + 1) */
+    unsigned int nEntities;
+
+} TIMELINE;
+
+/**
+ *  \brief Definition of <em>timeline profile</em> data type.
+ *
+ *  Sums over the runs compared, times in nanoseconds.
+ */
+typedef struct
+{ /** \brief stays of each role in each state: count and time */
+    double nPhase[NROLES][NSTATES], phase[NROLES][NSTATES];
+    /** \brief handoffs: count and latency */
+    double nHandoff[NHANDOFFS], handoff[NHANDOFFS];
+    /** \brief runs and makespans */
+    double nRuns, makespan;
+
+} PROFILE;
+
+static unsigned int role (int64_t entity)
+{
+    return (entity < AIRLIFT_PASSENGER (0)) ? (unsigned int) entity : 2;
+}
+
+static void entityName (int64_t entity, char name[], size_t size)
+{
+    if (entity == AIRLIFT_PILOT)
+        snprintf (name, size, "pilot");
+    else if (entity == AIRLIFT_HOSTESS)
+        snprintf (name, size, "hostess");
+    else snprintf (name, size, "passenger %02u", (unsigned int) (entity - AIRLIFT_PASSENGER (0)));
+}
+
+static void freeTimeline (TIMELINE *tl)
+{
+    unsigned int c;
+
+    for (c = 0; c < AIRLIFT_NCOLS; c++) {
+        free (tl->col[c]);
+        tl->col[c] = NULL;
+    }
+}
+
+static int loadTimeline (AIRLIFT_COL_READER *rd, unsigned int run, TIMELINE *tl)
+{
+    AIRLIFT_COL_RUN ri;
+    unsigned int c;
+    uint64_t k;
+
+    if (airliftColRunInfo (rd, run, &ri) == -1)
+        return -1;
+    tl->n = ri.nRows;
+    for (c = 0; c < AIRLIFT_NCOLS; c++)
+        if (((tl->col[c] = malloc ((ri.nRows + 1) * sizeof (int64_t))) == NULL) ||
+            (airliftColRead (rd, run, c, tl->col[c]) == -1)) {
+            freeTimeline (tl);
+            return -1;
+        }
+    tl->nEntities = 0;
+    for (k = 0; k < tl->n; k++)
+        if (tl->col[AIRLIFT_COL_ENTITY][k] >= tl->nEntities)
+            tl->nEntities = (unsigned int) tl->col[AIRLIFT_COL_ENTITY][k] + 1;
+
+    return 0;
+}
+
+/* phases and handoffs of a timeline added to a profile: -1 if its times are not known */
+static int profile (const TIMELINE *tl, PROFILE *pf)
+{
+    const int64_t *time = tl->col[AIRLIFT_COL_TIME], *entity = tl->col[AIRLIFT_COL_ENTITY],
+                  *state = tl->col[AIRLIFT_COL_STATE];
+    int64_t *last, latest[NHANDOFFS];
+    unsigned int *lastState, h, r, st;
+    uint64_t k;
+
+    for (k = 0; k < tl->n; k++)
+        if (time[k] < 0)
+            return -1;
+    if (((last = calloc (tl->nEntities + 1, sizeof (int64_t))) == NULL) ||
+        ((lastState = calloc (tl->nEntities + 1, sizeof (unsigned int))) == NULL)) {
+        free (last);
+        return -1;
+    }
+    for (h = 0; h < NHANDOFFS; h++)
+        latest[h] = -1;
+
+    /* every entity starts in state 0 at time 0 */
+
+    for (k = 0; k < tl->n; k++) {
+        r = role (entity[k]);
+        st = lastState[entity[k]];
+        if ((st < NSTATES) && (phaseName[r][st] != NULL)) {
+            pf->nPhase[r][st] += 1;
+            pf->phase[r][st] += time[k] - last[entity[k]];
+        }
+        for (h = 0; h < NHANDOFFS; h++)
+            if ((handoff[h].toRole == r) && (handoff[h].toState == state[k]) && (latest[h] >= 0)) {
+                pf->nHandoff[h] += 1;
+                pf->handoff[h] += time[k] - ((latest[h] > last[entity[k]]) ? latest[h] : last[entity[k]]);
+                if (handoff[h].once)
+                    latest[h] = -1;
+            }
+        last[entity[k]] = time[k];
+        lastState[entity[k]] = (unsigned int) state[k];
+        for (h = 0; h < NHANDOFFS; h++)
+            if ((handoff[h].fromRole == r) && (handoff[h].fromState == state[k]))
+                latest[h] = time[k];
+    }
+    pf->nRuns += 1;
+    pf->makespan += (tl->n == 0) ? 0 : time[tl->n - 1];
+    free (last);
+    free (lastState);
+
+    return 0;
+}
+
+static void printTransition (const TIMELINE *tl, uint64_t k, unsigned int nth)
+{
+    printf ("row %llu, transition %u: state %lld flight %lld", (unsigned long long) k, nth,
+            (long long) tl->col[AIRLIFT_COL_STATE][k], (long long) tl->col[AIRLIFT_COL_FLIGHT][k]);
+    if (tl->col[AIRLIFT_COL_TIME][k] >= 0)
+        printf (" at %.3f us", tl->col[AIRLIFT_COL_TIME][k] / 1000.0);
+}
+
+/* transitions of both timelines aligned by entity: first divergence reported, 1 if any, -1 on error */
+static int align (const TIMELINE *a, const TIMELINE *b, unsigned int run, bool report)
+{
+    unsigned int nEntities = (a->nEntities > b->nEntities) ? a->nEntities : b->nEntities, e, nth = 0;
+    uint64_t *first, *rows, *count, *seen, k, j = 0, iFirst = UINT64_MAX, jFirst = UINT64_MAX, shifted = 0,
+             iShift = UINT64_MAX, jShift = 0;
+    bool *diverged;
+    char name[32];
+    double maxShift = 0.0;
+    int64_t d, who;
+
+    first = calloc (nEntities + 1, sizeof (uint64_t));
+    count = calloc (nEntities + 1, sizeof (uint64_t));
+    seen = calloc (nEntities + 1, sizeof (uint64_t));
+    rows = malloc ((b->n + 1) * sizeof (uint64_t));
+    diverged = calloc (nEntities + 1, sizeof (bool));
+    if ((first == NULL) || (count == NULL) || (seen == NULL) || (rows == NULL) || (diverged == NULL)) {
+        free (first); free (count); free (seen); free (rows); free (diverged);
+        return -1;
+    }
+
+    /* rows of each entity in the second timeline, in order */
+
+    for (k = 0; k < b->n; k++)
+        count[b->col[AIRLIFT_COL_ENTITY][k]]++;
+    for (e = 1; e < nEntities; e++)
+        first[e] = first[e - 1] + count[e - 1];
+    for (k = 0; k < b->n; k++) {
+        e = (unsigned int) b->col[AIRLIFT_COL_ENTITY][k];
+        rows[first[e] + seen[e]++] = k;
+    }
+    memset (seen, 0, (nEntities + 1) * sizeof (uint64_t));
+
+    /* the first timeline walked in order, each transition matched with the same transition of its entity */
+
+    for (k = 0; k < a->n; k++) {
+        e = (unsigned int) a->col[AIRLIFT_COL_ENTITY][k];
+        if (diverged[e])
+            continue;
+        if ((seen[e] < count[e]) &&
+            (a->col[AIRLIFT_COL_STATE][k] == b->col[AIRLIFT_COL_STATE][rows[first[e] + seen[e]]]) &&
+            (a->col[AIRLIFT_COL_FLIGHT][k] == b->col[AIRLIFT_COL_FLIGHT][rows[first[e] + seen[e]]])) {
+            j = rows[first[e] + seen[e]++];
+            if ((d = b->col[AIRLIFT_COL_TIME][j] - a->col[AIRLIFT_COL_TIME][k]) != 0) {
+                if (shifted++ == 0) {
+                    iShift = k;
+                    jShift = j;
+                }
+                if (fabs ((double) d) > fabs (maxShift))
+                    maxShift = (double) d;
+            }
+            continue;
+        }
+        diverged[e] = true;
+        if (iFirst == UINT64_MAX) {
+            iFirst = k;
+            jFirst = (seen[e] < count[e]) ? rows[first[e] + seen[e]] : UINT64_MAX;
+            nth = (unsigned int) seen[e];
+        }
+    }
+    for (e = 0; e < nEntities; e++)
+        if (!diverged[e] && (seen[e] < count[e])) {                  /* transitions only in the second timeline */
+            diverged[e] = true;
+            if ((iFirst == UINT64_MAX) && (jFirst == UINT64_MAX || rows[first[e] + seen[e]] < jFirst)) {
+                jFirst = rows[first[e] + seen[e]];
+                nth = (unsigned int) seen[e];
+            }
+        }
+
+    if (report) {
+        for (e = 0, k = 0; e < nEntities; e++)
+            k += diverged[e];
+        if (k == 0)
+            printf ("run %u: same transitions", run);
+        else printf ("run %u: %llu entities diverge", run, (unsigned long long) k);
+        if (shifted == 0)
+            printf (", no time shifted\n");
+        else {
+            entityName (a->col[AIRLIFT_COL_ENTITY][iShift], name, sizeof (name));
+            printf (", %llu aligned transitions shifted (max %+.3f us), first %s at %.3f us (B %.3f us)\n",
+                    (unsigned long long) shifted, maxShift / 1000.0, name, a->col[AIRLIFT_COL_TIME][iShift] / 1000.0,
+                    b->col[AIRLIFT_COL_TIME][jShift] / 1000.0);
+        }
+        if (k != 0) {
+            who = (iFirst != UINT64_MAX) ? a->col[AIRLIFT_COL_ENTITY][iFirst] : b->col[AIRLIFT_COL_ENTITY][jFirst];
+            entityName (who, name, sizeof (name));
+            printf ("  first divergence, %s\n  A: ", name);
+            if (iFirst != UINT64_MAX)
+                printTransition (a, iFirst, nth);
+            else printf ("no transition %u", nth);
+            printf ("\n  B: ");
+            if (jFirst != UINT64_MAX)
+                printTransition (b, jFirst, nth);
+            else printf ("no transition %u", nth);
+            printf ("\n");
+        }
+    }
+    k = (iFirst != UINT64_MAX) || (jFirst != UINT64_MAX) || (shifted != 0);
+    free (first); free (count); free (seen); free (rows); free (diverged);
+
+    return (int) k;
+}
+
+static void compareMean (const char *name, double nA, double sumA, double nB, double sumB)
+{
+    double a = (nA == 0) ? 0.0 : sumA / nA / 1000.0, b = (nB == 0) ? 0.0 : sumB / nB / 1000.0;
+
+    printf ("%-40s %9.0f %9.0f %12.3f %12.3f %+9.1f%%\n", name, nA, nB, a, b, (a == 0.0) ? 0.0 : (b - a) * 100.0 / a);
+}
+
+static int cmdDiff (int argc, char *argv[], AIRLIFT_COL_READER *rdA, AIRLIFT_COL_READER *rdB)
+{
+    TIMELINE a = { 0 }, b = { 0 };
+    PROFILE pa = { { { 0 } } }, pb = { { { 0 } } };
+    unsigned int r, rFirst = 0, rLast, nListed = 10, nDiverged = 0, order[NHANDOFFS], h, i, t, nSlower = 0;
+    double delta[NHANDOFFS];
+    bool untimed = false;
+    int opt, d;
+
+    rLast = (airliftColRuns (rdA) < airliftColRuns (rdB)) ? airliftColRuns (rdA) : airliftColRuns (rdB);
+    while ((opt = getopt (argc, argv, "r:n:")) != -1) {
+        switch (opt) {
+            case 'r': rFirst = (unsigned int) atoi (optarg); rLast = rFirst + 1; break;
+            case 'n': nListed = (unsigned int) atoi (optarg); break;
+            default: return usage (argv[0]);
+        }
+    }
+    if (airliftColRuns (rdA) != airliftColRuns (rdB))
+        fprintf (stderr, "%u and %u runs stored, only the first %u compared\n", airliftColRuns (rdA),
+                 airliftColRuns (rdB), rLast);
+
+    /* runs paired by number: timelines aligned, phases and handoffs summed */
+
+    for (r = rFirst; r < rLast; r++) {
+        if ((loadTimeline (rdA, r, &a) == -1) || (loadTimeline (rdB, r, &b) == -1)) {
+            perror ("error on reading the runs");
+            freeTimeline (&a);
+            return EXIT_FAILURE;
+        }
+        if ((d = align (&a, &b, r, r - rFirst < nListed)) == -1) {
+            perror ("error on aligning the runs");
+            freeTimeline (&a);
+            freeTimeline (&b);
+            return EXIT_FAILURE;
+        }
+        nDiverged += d;
+        if ((profile (&a, &pa) == -1) || (profile (&b, &pb) == -1))
+            untimed = true;
+        freeTimeline (&a);
+        freeTimeline (&b);
+    }
+    printf ("%u of %u runs diverge\n\n", nDiverged, rLast - rFirst);
+    if (untimed)
+        printf ("runs without times left out of the durations: %.0f and %.0f runs timed\n\n",
+                pa.nRuns, pb.nRuns);
+
+    /* per phase durations */
+
+    printf ("%-40s %9s %9s %12s %12s %10s\n", "mean duration (us)", "n (A)", "n (B)", "A", "B", "change");
+    compareMean ("end to end (makespan)", pa.nRuns, pa.makespan, pb.nRuns, pb.makespan);
+    for (r = 0; r < NROLES; r++)
+        for (i = 0; i < NSTATES; i++)
+            if (phaseName[r][i] != NULL)
+                compareMean (phaseName[r][i], pa.nPhase[r][i], pa.phase[r][i], pb.nPhase[r][i], pb.phase[r][i]);
+
+    /* handoffs, the ones slowed down the most first */
+
+    for (h = 0; h < NHANDOFFS; h++) {
+        delta[h] = ((pb.nHandoff[h] == 0) ? 0.0 : pb.handoff[h] / pb.nHandoff[h]) -
+                   ((pa.nHandoff[h] == 0) ? 0.0 : pa.handoff[h] / pa.nHandoff[h]);
+        for (i = h; (i > 0) && (delta[order[i - 1]] < delta[h]); i--)
+            order[i] = order[i - 1];
+        order[i] = h;
+    }
+    printf ("\n%-40s %9s %9s %12s %12s %10s\n", "mean handoff latency (us)", "n (A)", "n (B)", "A", "B", "change");
+    for (i = 0; i < NHANDOFFS; i++) {
+        t = order[i];
+        compareMean (handoff[t].name, pa.nHandoff[t], pa.handoff[t], pb.nHandoff[t], pb.handoff[t]);
+    }
+    printf ("\nslower handoffs:");
+    for (i = 0; (i < NHANDOFFS) && (delta[order[i]] > 0.0); i++, nSlower++)
+        printf ("%s %s (%+.3f us)", (i == 0) ? "" : ",", handoff[order[i]].name, delta[order[i]] / 1000.0);
+    printf ("%s\n", (nSlower == 0) ? " none" : "");
+
+    return EXIT_SUCCESS;
+}
+
+/**
+ *  \brief Main program.
+ */
+
+int main (int argc, char *argv[])
+{
+    AIRLIFT_COL_READER *rd, *rdB;
+    int stat;
+
+    if (argc < 3)
+        return usage (argv[0]);
+    if (strcmp (argv[1], "record") == 0) {
+        optind = 3;
+        return cmdRecord (argc, argv, argv[2]);
+    }
+    if (strcmp (argv[1], "diff") == 0) {
+        if (argc < 4)
+            return usage (argv[0]);
+        if ((rd = airliftColOpen (argv[2])) == NULL) {
+            perror (argv[2]);
+            return EXIT_FAILURE;
+        }
+        if ((rdB = airliftColOpen (argv[3])) == NULL) {
+            perror (argv[3]);
+            airliftColClose (rd);
+            return EXIT_FAILURE;
+        }
+        optind = 4;
+        stat = cmdDiff (argc, argv, rd, rdB);
+        airliftColClose (rd);
+        airliftColClose (rdB);
+        return stat;
+    }
+    if ((strcmp (argv[1], "info") != 0) && ((strcmp (argv[1], "stat") != 0) || (argc < 4)))
+        return usage (argv[0]);
+    if ((rd = airliftColOpen (argv[2])) == NULL) {
+        perror (argv[2]);
+        return EXIT_FAILURE;
+    }
+    if (strcmp (argv[1], "info") == 0)
+        stat = cmdInfo (rd);
+    else {
+        optind = 4;
+        stat = cmdStat (argc, argv, rd, argv[3]);
+    }
+    airliftColClose (rd);
+
+    return stat;
+}
@@ -0,0 +1,708 @@
+/**
+ *  \file airliftColumns.c (implementation file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  Columnar store of the event history (libairlift).
+ *
+ *  Writer operations, used by the library front end:
+ *     \li creation of a column file
+ *     \li beginning a run
+ *     \li appending an event to the run
+ *     \li ending a run (its columns and flight index are encoded and written)
+ *     \li finishing the file (the footer is written).
+ *
+ *  Reader operations are described in airliftColumns.h.
+ *
+ *  Encoding of a column: each value is replaced by its difference to the previous one (the first one to 0), the
+ *  differences are zigzag mapped to unsigned integers and runs of equal differences are written as pairs
+ *  (difference, length), both as variable length integers (7 bits per byte, least significant first).
+ *  Counters that seldom change and evenly spaced times thus take a couple of bytes per run of rows.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+
+#include "airlift.h"
+#include "airliftColumns.h"
+#include "airliftInternal.h"
+
+/** \brief container magic */
+#define  MAGIC           "ACOL"
+
+/** \brief container version */
+#define  VERSION         1u
+
+/** \brief encoding of the columns: delta, zigzag, run-length, variable length integers */
+#define  ENC_DELTA_RLE   1u
+
+/** \brief column names */
+static const char *colName[AIRLIFT_NCOLS] = { "time", "entity", "state", "queue", "inflight", "boarded", "flight" };
+
+/**
+ *  \brief Definition of <em>growable byte buffer</em> data type.
+ */
+typedef struct
+{ /** \brief bytes */
+    uint8_t *buf;
+    /** \brief bytes in use */
+    size_t len;
+    /** \brief bytes allocated */
+    size_t cap;
+
+} BYTES;
+
+/**
+ *  \brief Definition of <em>column encoder</em> data type.
+ */
+typedef struct
+{ /** \brief encoded bytes */
+    BYTES out;
+    /** \brief last value appended */
+    int64_t prev;
+    /** \brief zigzag mapped difference of the current run */
+    uint64_t delta;
+    /** \brief length of the current run */
+    uint64_t count;
+
+} ENCODER;
+
+/**
+ *  \brief Definition of <em>stored run location</em> data type.
+ */
+typedef struct
+{ /** \brief number of rows */
+    uint64_t nRows;
+    /** \brief number of flights */
+    uint32_t nFlights;
+    /** \brief offset and length of the flight index */
+    uint64_t flightOff, flightLen;
+    /** \brief offset and length of each column */
+    uint64_t colOff[AIRLIFT_NCOLS], colLen[AIRLIFT_NCOLS];
+
+} RUNLOC;
+
+/**
+ *  \brief Definition of the column file writer.
+ */
+struct airliftColWriter
+{ /** \brief column file */
+    FILE *fic;
+    /** \brief column encoders of the current run */
+    ENCODER enc[AIRLIFT_NCOLS];
+    /** \brief rows of the current run */
+    uint64_t nRows;
+    /** \brief first row of each flight of the current run */
+    BYTES flights;
+    /** \brief flight number of the last row */
+    unsigned int lastFlight;
+    /** \brief location of the runs already written */
+    RUNLOC *runs;
+    /** \brief number of runs written */
+    unsigned int nRuns;
+    /** \brief allocated entries of runs */
+    unsigned int runsCap;
+    /** \brief out of memory during the current run */
+    bool failed;
+};
+
+/**
+ *  \brief Definition of the column file reader.
+ */
+struct airliftColReader
+{ /** \brief column file */
+    FILE *fic;
+    /** \brief location of the runs */
+    RUNLOC *runs;
+    /** \brief number of runs */
+    unsigned int nRuns;
+    /** \brief column of each stored column (AIRLIFT_NCOLS when not known) */
+    unsigned int colMap[AIRLIFT_NCOLS];
+};
+
+static int putBytes (BYTES *b, const void *src, size_t n)
+{
+    if (b->len + n > b->cap) {
+        size_t cap = (b->cap == 0) ? 256 : b->cap;
+        uint8_t *buf;
+
+        while (cap < b->len + n)
+            cap *= 2;
+        if ((buf = realloc (b->buf, cap)) == NULL)
+            return -1;
+        b->buf = buf;
+        b->cap = cap;
+    }
+    memcpy (b->buf + b->len, src, n);
+    b->len += n;
+
+    return 0;
+}
+
+static int putVarint (BYTES *b, uint64_t v)
+{
+    uint8_t tmp[10];
+    size_t n = 0;
+
+    while (v >= 0x80) {
+        tmp[n++] = (uint8_t) (v | 0x80);
+        v >>= 7;
+    }
+    tmp[n++] = (uint8_t) v;
+
+    return putBytes (b, tmp, n);
+}
+
+static int putLE (BYTES *b, uint64_t v, size_t n)
+{
+    uint8_t tmp[8];
+    size_t i;
+
+    for (i = 0; i < n; i++)
+        tmp[i] = (uint8_t) (v >> (8 * i));
+
+    return putBytes (b, tmp, n);
+}
+
+static uint64_t getLE (const uint8_t *p, size_t n)
+{
+    uint64_t v = 0;
+
+    while (n-- > 0)
+        v = (v << 8) | p[n];
+
+    return v;
+}
+
+static int flushRun (ENCODER *enc)
+{
+    if (enc->count == 0)
+        return 0;
+    if ((putVarint (&enc->out, enc->delta) == -1) || (putVarint (&enc->out, enc->count) == -1))
+        return -1;
+    enc->count = 0;
+
+    return 0;
+}
+
+static int encode (ENCODER *enc, int64_t v)
+{
+    int64_t d = (int64_t) ((uint64_t) v - (uint64_t) enc->prev);
+    uint64_t z = ((uint64_t) d << 1) ^ (uint64_t) (d >> 63);                                    /* zigzag */
+
+    enc->prev = v;
+    if ((enc->count != 0) && (z == enc->delta)) {
+        enc->count++;
+        return 0;
+    }
+    if (flushRun (enc) == -1)
+        return -1;
+    enc->delta = z;
+    enc->count = 1;
+
+    return 0;
+}
+
+/**
+ *  \brief Creation of a column file.
+ *
+ *  \param path name of the file
+ *
+ *  \return writer handle, upon success
+ *  \return NULL, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+AIRLIFT_COL_WRITER *airliftColCreate (const char *path)
+{
+    AIRLIFT_COL_WRITER *wr;
+    uint8_t head[8];
+
+    if ((wr = calloc (1, sizeof (AIRLIFT_COL_WRITER))) == NULL)
+        return NULL;
+    if ((wr->fic = fopen (path, "wb")) == NULL) {
+        free (wr);
+        return NULL;
+    }
+    memcpy (head, MAGIC, 4);
+    head[4] = VERSION; head[5] = head[6] = head[7] = 0;
+    if (fwrite (head, 1, sizeof (head), wr->fic) != sizeof (head)) {
+        fclose (wr->fic);
+        free (wr);
+        return NULL;
+    }
+
+    return wr;
+}
+
+/**
+ *  \brief Beginning a run: the encoders are reset.
+ *
+ *  \param wr writer handle
+ */
+
+void airliftColBeginRun (AIRLIFT_COL_WRITER *wr)
+{
+    unsigned int c;
+
+    for (c = 0; c < AIRLIFT_NCOLS; c++) {
+        wr->enc[c].out.len = 0;
+        wr->enc[c].prev = 0;
+        wr->enc[c].count = 0;
+    }
+    wr->nRows = 0;
+    wr->flights.len = 0;
+    wr->lastFlight = 0;
+    wr->failed = false;
+}
+
+/**
+ *  \brief Appending an event to the current run.
+ *
+ *  \param wr writer handle
+ *  \param ev pointer to the event
+ */
+
+void airliftColAppend (AIRLIFT_COL_WRITER *wr, const AIRLIFT_EVENT *ev)
+{
+    int64_t v[AIRLIFT_NCOLS];
+    unsigned int c;
+
+    if (wr->failed)
+        return;
+    v[AIRLIFT_COL_TIME] = (ev->time < 0.0) ? -1 : llround (ev->time * 1000.0);
+    v[AIRLIFT_COL_ENTITY] = ev->entity;
+    v[AIRLIFT_COL_STATE] = ev->state;
+    v[AIRLIFT_COL_QUEUE] = ev->nPassInQueue;
+    v[AIRLIFT_COL_INFLIGHT] = ev->nPassInFlight;
+    v[AIRLIFT_COL_BOARDED] = ev->totalPassBoarded;
+    v[AIRLIFT_COL_FLIGHT] = ev->nFlight;
+    for (c = 0; c < AIRLIFT_NCOLS; c++)
+        if (encode (&wr->enc[c], v[c]) == -1)
+            wr->failed = true;
+
+    /* flight numbers only grow: the first row of each new flight is recorded (missing flights get empty ranges) */
+
+    while (wr->lastFlight < ev->nFlight) {
+        if (putVarint (&wr->flights, wr->nRows) == -1)
+            wr->failed = true;
+        wr->lastFlight++;
+    }
+    wr->nRows++;
+}
+
+/**
+ *  \brief Ending a run: its columns and flight index are written.
+ *
+ *  \param wr writer handle
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int airliftColEndRun (AIRLIFT_COL_WRITER *wr)
+{
+    RUNLOC loc;
+    long off;
+    unsigned int c;
+
+    for (c = 0; c < AIRLIFT_NCOLS; c++)
+        if (flushRun (&wr->enc[c]) == -1)
+            wr->failed = true;
+    if (wr->failed) {
+        errno = ENOMEM;
+        return -1;
+    }
+    if (wr->nRuns == wr->runsCap) {
+        unsigned int cap = (wr->runsCap == 0) ? 16 : 2 * wr->runsCap;
+        RUNLOC *runs;
+
+        if ((runs = realloc (wr->runs, cap * sizeof (RUNLOC))) == NULL)
+            return -1;
+        wr->runs = runs;
+        wr->runsCap = cap;
+    }
+
+    if ((off = ftell (wr->fic)) == -1)
+        return -1;
+    loc.nRows = wr->nRows;
+    loc.nFlights = wr->lastFlight;
+    for (c = 0; c < AIRLIFT_NCOLS; c++) {
+        loc.colOff[c] = (uint64_t) off;
+        loc.colLen[c] = wr->enc[c].out.len;
+        if (fwrite (wr->enc[c].out.buf, 1, wr->enc[c].out.len, wr->fic) != wr->enc[c].out.len)
+            return -1;
+        off += (long) wr->enc[c].out.len;
+    }
+    loc.flightOff = (uint64_t) off;
+    loc.flightLen = wr->flights.len;
+    if (fwrite (wr->flights.buf, 1, wr->flights.len, wr->fic) != wr->flights.len)
+        return -1;
+    wr->runs[wr->nRuns++] = loc;
+
+    return 0;
+}
+
+/**
+ *  \brief Finishing a column file: the footer is written and the file closed.
+ *
+ *  \param wr writer handle
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int airliftColFinish (AIRLIFT_COL_WRITER *wr)
+{
+    BYTES foot = { NULL, 0, 0 };
+    long off;
+    unsigned int c, r;
+    int stat = -1;
+
+    if ((off = ftell (wr->fic)) == -1)
+        goto out;
+    if (putLE (&foot, AIRLIFT_NCOLS, 4) == -1)
+        goto out;
+    for (c = 0; c < AIRLIFT_NCOLS; c++) {
+        uint8_t len = (uint8_t) strlen (colName[c]), enc = ENC_DELTA_RLE;
+
+        if ((putBytes (&foot, &len, 1) == -1) || (putBytes (&foot, colName[c], len) == -1) ||
+            (putBytes (&foot, &enc, 1) == -1))
+            goto out;
+    }
+    if (putLE (&foot, wr->nRuns, 4) == -1)
+        goto out;
+    for (r = 0; r < wr->nRuns; r++) {
+        RUNLOC *loc = &wr->runs[r];
+
+        if ((putLE (&foot, loc->nRows, 8) == -1) || (putLE (&foot, loc->nFlights, 4) == -1) ||
+            (putLE (&foot, loc->flightOff, 8) == -1) || (putLE (&foot, loc->flightLen, 8) == -1))
+            goto out;
+        for (c = 0; c < AIRLIFT_NCOLS; c++)
+            if ((putLE (&foot, loc->colOff[c], 8) == -1) || (putLE (&foot, loc->colLen[c], 8) == -1))
+                goto out;
+    }
+    if ((putLE (&foot, (uint64_t) off, 8) == -1) || (putBytes (&foot, MAGIC, 4) == -1))
+        goto out;
+    if (fwrite (foot.buf, 1, foot.len, wr->fic) == foot.len)
+        stat = 0;
+
+out:
+    if ((fclose (wr->fic) == EOF) && (stat == 0))
+        stat = -1;
+    for (c = 0; c < AIRLIFT_NCOLS; c++)
+        free (wr->enc[c].out.buf);
+    free (wr->flights.buf);
+    free (wr->runs);
+    free (wr);
+    free (foot.buf);
+
+    return stat;
+}
+
+/**
+ *  \brief Name of a column.
+ *
+ *  \param col column
+ *
+ *  \return name of the column, NULL if it does not exist
+ */
+
+const char *airliftColName (AIRLIFT_COLUMN col)
+{
+    return ((unsigned int) col < AIRLIFT_NCOLS) ? colName[col] : NULL;
+}
+
+/** \brief reading n bytes at an offset of the file */
+static int readAt (FILE *fic, uint64_t off, void *buf, size_t n)
+{
+    if (fseek (fic, (long) off, SEEK_SET) == -1)
+        return -1;
+    if (fread (buf, 1, n, fic) != n) {
+        errno = EILSEQ;
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ *  \brief Opening a column file.
+ *
+ *  \param path name of the file
+ *
+ *  \return reader handle, upon success
+ *  \return NULL, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+AIRLIFT_COL_READER *airliftColOpen (const char *path)
+{
+    AIRLIFT_COL_READER *rd;
+    uint8_t tail[12], *foot = NULL, *p, *end;
+    long size;
+    uint64_t footOff;
+    unsigned int nCols, c, k, r;
+    int err;
+
+    if ((rd = calloc (1, sizeof (AIRLIFT_COL_READER))) == NULL)
+        return NULL;
+    if ((rd->fic = fopen (path, "rb")) == NULL) {
+        free (rd);
+        return NULL;
+    }
+    if ((fseek (rd->fic, 0, SEEK_END) == -1) || ((size = ftell (rd->fic)) == -1))
+        goto fail;
+    errno = EILSEQ;
+    if ((size < 8 + 4 + 4 + (long) sizeof (tail)) || (readAt (rd->fic, (uint64_t) size - sizeof (tail), tail,
+                                                               sizeof (tail)) == -1))
+        goto fail;
+    footOff = getLE (tail, 8);
+    if ((memcmp (tail + 8, MAGIC, 4) != 0) || (footOff < 8) || (footOff > (uint64_t) size - sizeof (tail)))
+        goto fail;
+    if ((foot = malloc ((size_t) ((uint64_t) size - sizeof (tail) - footOff))) == NULL)
+        goto fail;
+    if (readAt (rd->fic, footOff, foot, (size_t) ((uint64_t) size - sizeof (tail) - footOff)) == -1)
+        goto fail;
+    p = foot;
+    end = foot + ((uint64_t) size - sizeof (tail) - footOff);
+
+    /* column descriptors, matched by name */
+
+    errno = EILSEQ;
+    if (end - p < 4)
+        goto fail;
+    nCols = (unsigned int) getLE (p, 4);
+    p += 4;
+    if (nCols > AIRLIFT_NCOLS)
+        goto fail;
+    for (c = 0; c < AIRLIFT_NCOLS; c++)
+        rd->colMap[c] = AIRLIFT_NCOLS;
+    for (k = 0; k < nCols; k++) {
+        unsigned int len;
+
+        if ((end - p < 1) || (end - p < 2 + (len = p[0])))
+            goto fail;
+        for (c = 0; c < AIRLIFT_NCOLS; c++)
+            if ((strlen (colName[c]) == len) && (memcmp (p + 1, colName[c], len) == 0))
+                break;
+        if ((c < AIRLIFT_NCOLS) && (p[1+len] == ENC_DELTA_RLE))
+            rd->colMap[c] = k;
+        p += 2 + len;
+    }
+
+    /* run locations */
+
+    if (end - p < 4)
+        goto fail;
+    rd->nRuns = (unsigned int) getLE (p, 4);
+    p += 4;
+    if ((uint64_t) (end - p) < (uint64_t) rd->nRuns * (28 + 16 * nCols))
+        goto fail;
+    if ((rd->nRuns > 0) && ((rd->runs = calloc (rd->nRuns, sizeof (RUNLOC))) == NULL))
+        goto fail;
+    for (r = 0; r < rd->nRuns; r++) {
+        RUNLOC *loc = &rd->runs[r];
+        uint64_t off[AIRLIFT_NCOLS], len[AIRLIFT_NCOLS];
+
+        loc->nRows = getLE (p, 8);
+        loc->nFlights = (uint32_t) getLE (p + 8, 4);
+        loc->flightOff = getLE (p + 12, 8);
+        loc->flightLen = getLE (p + 20, 8);
+        p += 28;
+        for (k = 0; k < nCols; k++) {
+            off[k] = getLE (p, 8);
+            len[k] = getLE (p + 8, 8);
+            p += 16;
+        }
+        for (c = 0; c < AIRLIFT_NCOLS; c++)
+            if (rd->colMap[c] < nCols) {
+                loc->colOff[c] = off[rd->colMap[c]];
+                loc->colLen[c] = len[rd->colMap[c]];
+            }
+    }
+    free (foot);
+
+    return rd;
+
+fail:
+    err = errno;
+    free (foot);
+    free (rd->runs);
+    fclose (rd->fic);
+    free (rd);
+    errno = err;
+    return NULL;
+}
+
+/**
+ *  \brief Number of runs stored.
+ *
+ *  \param rd reader handle
+ *
+ *  \return number of runs
+ */
+
+unsigned int airliftColRuns (const AIRLIFT_COL_READER *rd)
+{
+    return rd->nRuns;
+}
+
+/**
+ *  \brief Description of a stored run.
+ *
+ *  \param rd reader handle
+ *  \param run run number (0 .. n-1)
+ *  \param info pointer to the location where the description is stored
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when the run does not exist (<tt>errno</tt> is set to <tt>EINVAL</tt>)
+ */
+
+int airliftColRunInfo (const AIRLIFT_COL_READER *rd, unsigned int run, AIRLIFT_COL_RUN *info)
+{
+    unsigned int c;
+
+    if (run >= rd->nRuns) {
+        errno = EINVAL;
+        return -1;
+    }
+    info->nRows = rd->runs[run].nRows;
+    info->nFlights = rd->runs[run].nFlights;
+    for (c = 0; c < AIRLIFT_NCOLS; c++)
+        info->colBytes[c] = rd->runs[run].colLen[c];
+
+    return 0;
+}
+
+/** \brief reading a block of a run and decoding its variable length integers; returns the number decoded */
+static int64_t readVarints (AIRLIFT_COL_READER *rd, uint64_t off, uint64_t len, uint64_t *out, uint64_t max)
+{
+    uint8_t *buf, *p, *end;
+    uint64_t n = 0;
+
+    if (len == 0)
+        return 0;
+    if ((buf = malloc ((size_t) len)) == NULL)
+        return -1;
+    if (readAt (rd->fic, off, buf, (size_t) len) == -1) {
+        free (buf);
+        return -1;
+    }
+    for (p = buf, end = buf + len; (p < end) && (n < max); n++) {
+        uint64_t v = 0;
+        unsigned int shift = 0;
+
+        do {
+            v |= (uint64_t) (*p & 0x7f) << shift;
+            shift += 7;
+        } while ((*p++ & 0x80) && (p < end) && (shift < 64));
+        out[n] = v;
+    }
+    free (buf);
+
+    return (int64_t) n;
+}
+
+/**
+ *  \brief Decoding a column of a run.
+ *
+ *  \param rd reader handle
+ *  \param run run number (0 .. n-1)
+ *  \param col column
+ *  \param val array where the <tt>nRows</tt> values of the column are stored
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int airliftColRead (AIRLIFT_COL_READER *rd, unsigned int run, AIRLIFT_COLUMN col, int64_t *val)
+{
+    RUNLOC *loc;
+    uint64_t *pair, row = 0;
+    int64_t n, k, prev = 0;
+
+    if ((run >= rd->nRuns) || ((unsigned int) col >= AIRLIFT_NCOLS) || (rd->colMap[col] == AIRLIFT_NCOLS)) {
+        errno = EINVAL;
+        return -1;
+    }
+    loc = &rd->runs[run];
+    if ((pair = malloc ((size_t) (loc->colLen[col] + 1) * sizeof (uint64_t))) == NULL)
+        return -1;
+    if ((n = readVarints (rd, loc->colOff[col], loc->colLen[col], pair, loc->colLen[col])) == -1) {
+        free (pair);
+        return -1;
+    }
+    for (k = 0; k + 1 < n; k += 2) {
+        int64_t d = (int64_t) (pair[k] >> 1) ^ -(int64_t) (pair[k] & 1);
+        uint64_t c;
+
+        for (c = 0; (c < pair[k+1]) && (row < loc->nRows); c++)
+            val[row++] = prev = (int64_t) ((uint64_t) prev + (uint64_t) d);
+    }
+    free (pair);
+    if (row != loc->nRows) {
+        errno = EILSEQ;
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ *  \brief Range of rows of a flight.
+ *
+ *  \param rd reader handle
+ *  \param run run number (0 .. n-1)
+ *  \param flight flight number (1 .. nFlights)
+ *  \param first pointer to the location where the first row is stored
+ *  \param count pointer to the location where the number of rows is stored
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int airliftColFlight (AIRLIFT_COL_READER *rd, unsigned int run, unsigned int flight, uint64_t *first,
+                      uint64_t *count)
+{
+    RUNLOC *loc;
+    uint64_t *start;
+    int64_t n;
+
+    if ((run >= rd->nRuns) || (flight == 0) || (flight > rd->runs[run].nFlights)) {
+        errno = EINVAL;
+        return -1;
+    }
+    loc = &rd->runs[run];
+    if ((start = malloc ((size_t) (loc->nFlights + 1) * sizeof (uint64_t))) == NULL)
+        return -1;
+    if ((n = readVarints (rd, loc->flightOff, loc->flightLen, start, loc->nFlights)) != (int64_t) loc->nFlights) {
+        free (start);
+        if (n != -1)
+            errno = EILSEQ;
+        return -1;
+    }
+    start[loc->nFlights] = loc->nRows;
+    *first = start[flight-1];
+    *count = start[flight] - start[flight-1];
+    free (start);
+
+    return 0;
+}
+
+/**
+ *  \brief Closing a column file.
+ *
+ *  \param rd reader handle
+ */
+
+void airliftColClose (AIRLIFT_COL_READER *rd)
+{
+    if (rd == NULL)
+        return;
+    fclose (rd->fic);
+    free (rd->runs);
+    free (rd);
+}
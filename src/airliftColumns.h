@@ -0,0 +1,170 @@
+/**
+ *  \file airliftColumns.h (interface file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  Columnar store of the event history (libairlift).
+ *
+ *  When a simulation is configured with a column file, every state transition event of every run is stored
+ *  field by field in a single self-describing container:
+ *     \li one column per event field (time, entity, state and the queue, flight and boarding counters)
+ *     \li every column delta encoded, then run-length encoded, in variable length integers
+ *     \li a footer holding the column descriptors and, for each run, the location of its columns and the range
+ *         of rows of each flight.
+ *
+ *  Container layout (integers little endian):
+ *     \li <tt>"ACOL"</tt>, version (u32)
+ *     \li for each run: its encoded columns, its flight index (first row of each flight, in variable length
+ *         integers; the number of rows of a flight is where the next one starts, or the number of rows of the run)
+ *     \li footer: number of columns (u32) and, for each column, its name (u8 length and chars) and encoding (u8);
+ *         number of runs (u32) and, for each run, its number of rows (u64), number of flights (u32), offset and
+ *         length of its flight index (u64, u64) and offset and length of each column (u64, u64)
+ *     \li offset of the footer (u64), <tt>"ACOL"</tt>.
+ *
+ *  Reader operations, touching only the bytes of the columns requested:
+ *     \li opening and closing a column file
+ *     \li fetching the number of runs and the description of a run
+ *     \li decoding a column of a run
+ *     \li fetching the range of rows of a flight.
+ */
+
+#ifndef AIRLIFTCOLUMNS_H_
+#define AIRLIFTCOLUMNS_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ *  \brief Columns of the store.
+ */
+typedef enum
+{ /** \brief time of the event, in nanoseconds (-1 when not known) */
+    AIRLIFT_COL_TIME,
+    /** \brief entity id */
+    AIRLIFT_COL_ENTITY,
+    /** \brief new state of the entity */
+    AIRLIFT_COL_STATE,
+    /** \brief number of passengers waiting */
+    AIRLIFT_COL_QUEUE,
+    /** \brief number of passengers flying */
+    AIRLIFT_COL_INFLIGHT,
+    /** \brief total number of passengers boarded */
+    AIRLIFT_COL_BOARDED,
+    /** \brief flight number */
+    AIRLIFT_COL_FLIGHT,
+    /** \brief number of columns */
+    AIRLIFT_NCOLS
+
+} AIRLIFT_COLUMN;
+
+/**
+ *  \brief Definition of <em>stored run description</em> data type.
+ */
+typedef struct
+{ /** \brief number of rows (events) */
+    uint64_t nRows;
+    /** \brief number of flights */
+    uint32_t nFlights;
+    /** \brief encoded size of each column (in bytes) */
+    uint64_t colBytes[AIRLIFT_NCOLS];
+
+} AIRLIFT_COL_RUN;
+
+/** \brief opaque column file reader */
+typedef struct airliftColReader AIRLIFT_COL_READER;
+
+/**
+ *  \brief Name of a column.
+ *
+ *  \param col column
+ *
+ *  \return name of the column, NULL if it does not exist
+ */
+
+extern const char *airliftColName (AIRLIFT_COLUMN col);
+
+/**
+ *  \brief Opening a column file.
+ *
+ *  Only the footer is read.
+ *
+ *  \param path name of the file
+ *
+ *  \return reader handle, upon success
+ *  \return NULL, when an error occurs (the actual situation is reported in <tt>errno</tt>; <tt>EILSEQ</tt> if
+ *          the file is not a column file)
+ */
+
+extern AIRLIFT_COL_READER *airliftColOpen (const char *path);
+
+/**
+ *  \brief Number of runs stored.
+ *
+ *  \param rd reader handle
+ *
+ *  \return number of runs
+ */
+
+extern unsigned int airliftColRuns (const AIRLIFT_COL_READER *rd);
+
+/**
+ *  \brief Description of a stored run.
+ *
+ *  \param rd reader handle
+ *  \param run run number (0 .. n-1)
+ *  \param info pointer to the location where the description is stored
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when the run does not exist (<tt>errno</tt> is set to <tt>EINVAL</tt>)
+ */
+
+extern int airliftColRunInfo (const AIRLIFT_COL_READER *rd, unsigned int run, AIRLIFT_COL_RUN *info);
+
+/**
+ *  \brief Decoding a column of a run.
+ *
+ *  \param rd reader handle
+ *  \param run run number (0 .. n-1)
+ *  \param col column
+ *  \param val array where the <tt>nRows</tt> values of the column are stored
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+extern int airliftColRead (AIRLIFT_COL_READER *rd, unsigned int run, AIRLIFT_COLUMN col, int64_t *val);
+
+/**
+ *  \brief Range of rows of a flight.
+ *
+ *  The rows of a flight are the events whose flight number is the one of the flight.
+ *
+ *  \param rd reader handle
+ *  \param run run number (0 .. n-1)
+ *  \param flight flight number (1 .. nFlights)
+ *  \param first pointer to the location where the first row is stored
+ *  \param count pointer to the location where the number of rows is stored
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+extern int airliftColFlight (AIRLIFT_COL_READER *rd, unsigned int run, unsigned int flight, uint64_t *first,
+                             uint64_t *count);
+
+/**
+ *  \brief Closing a column file.
+ *
+ *  \param rd reader handle
+ */
+
+extern void airliftColClose (AIRLIFT_COL_READER *rd);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AIRLIFTCOLUMNS_H_ */
@@ -0,0 +1,609 @@
+/**
+ *  \file airliftEvent.c (implementation file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  Embeddable simulation library (libairlift).
+ *
+ *  Discrete event engine.
+ *
+ *  The life cycles of the pilot, the hostess and the passengers are run in the calling process as resumable
+ *  state machines, following the operations of the SVIPC implementation step by step.
+ *  Semaphores are simulated as counters with a FIFO queue of blocked entities and the passage of time as a
+ *  priority queue of wake up events. Since a single entity runs at a time, the critical regions protected by
+ *  <tt>mutex</tt> are atomic by construction and the mutex itself is not simulated.
+ *
+ *  Time is simulated, so a run takes no longer than its processing; travel and flight times follow the same
+ *  distributions as the SVIPC implementation, drawn from a seeded generator.
+ *
+ *  A group of passengers travelling together is run by the entity of its first passenger (its leader), the others
+ *  being done from the start: the leader queues, shows the ids and leaves the plane for the whole group, in single
+ *  semaphore operations. The hostess lets a flight depart before the group at the head of the queue when it does
+ *  not fit, even below the minimum when the flight waited for it.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include <errno.h>
+
+#include "probConst.h"
+#include "airlift.h"
+#include "airliftInternal.h"
+
+/* simulated semaphores */
+
+/** \brief semaphore used by hostess to wait for passengers */
+#define  S_PASSENGERSINQUEUE          0
+/** \brief semaphore used by passengers to wait for hostess */
+#define  S_PASSENGERSWAITINQUEUE      1
+/** \brief semaphore used by passengers to wait for flight to end */
+#define  S_PASSENGERSWAITINFLIGHT     2
+/** \brief semaphore used by hostess to wait for starting boarding */
+#define  S_READYFORBOARDING           3
+/** \brief semaphore used by pilot to wait for boarding to complete */
+#define  S_READYTOFLIGHT              4
+/** \brief semaphore used by hostess to wait for passenger identification */
+#define  S_IDSHOWN                    5
+/** \brief semaphore used by pilot to wait for last passenger to leave plane */
+#define  S_PLANEEMPTY                 6
+/** \brief number of simulated semaphores */
+#define  S_NU                         7
+
+/* resume points of the life cycles */
+
+/** \brief pilot: flight back to the starting airport */
+#define  PT_FLIGHT_BACK               0
+/** \brief pilot: signal ready for boarding and wait for boarding to complete */
+#define  PT_BOARDING                  1
+/** \brief pilot: flight to destination */
+#define  PT_FLIGHT_GO                 2
+/** \brief pilot: drop passengers at destination */
+#define  PT_DROP                      3
+/** \brief pilot: last passenger left the plane */
+#define  PT_EMPTY                     4
+
+/** \brief hostess: wait for next flight */
+#define  HT_NEXT_FLIGHT               0
+/** \brief hostess: wait for passenger */
+#define  HT_WAIT_PASSENGER            1
+/** \brief hostess: passenger in queue, check passport */
+#define  HT_CHECK                     2
+/** \brief hostess: id shown */
+#define  HT_CHECKED                   3
+
+/** \brief passenger: travel to airport */
+#define  PG_TRAVEL                    0
+/** \brief passenger: enter the queue */
+#define  PG_QUEUE                     1
+/** \brief passenger: called by hostess */
+#define  PG_CALLED                    2
+/** \brief passenger: flight ended */
+#define  PG_LANDED                    3
+
+/** \brief any entity: life cycle over */
+#define  DONE                         99
+
+/**
+ *  \brief Definition of <em>simulated entity</em> data type.
+ */
+typedef struct
+{ /** \brief entity id (AIRLIFT_PILOT, AIRLIFT_HOSTESS or AIRLIFT_PASSENGER(p)) */
+    unsigned int id;
+    /** \brief resume point of the life cycle */
+    unsigned int pc;
+    /** \brief next entity blocked on the same semaphore */
+    int next;
+    /** \brief hostess: number of passengers checked */
+    unsigned int nChecked;
+    /** \brief passenger: time of arrival at the queue */
+    double tInQueue;
+    /** \brief passenger: size of the group it leads (0 if it is not a leader) */
+    unsigned int size;
+
+} ENTITY;
+
+/**
+ *  \brief Definition of <em>simulated semaphore</em> data type.
+ */
+typedef struct
+{ /** \brief semaphore value */
+    unsigned int val;
+    /** \brief first and last entities blocked on the semaphore (-1 if none) */
+    int head, tail;
+
+} SEM;
+
+/**
+ *  \brief Definition of <em>wake up event</em> data type.
+ */
+typedef struct
+{ /** \brief time of the event */
+    double time;
+    /** \brief insertion order, breaks ties in FIFO order */
+    unsigned long seq;
+    /** \brief entity to be resumed */
+    int ent;
+
+} WAKEUP;
+
+/**
+ *  \brief Definition of <em>discrete event engine</em> data type.
+ */
+typedef struct
+{ /** \brief simulation handle */
+    AIRLIFT_SIM *sim;
+    /** \brief full state of the problem */
+    AIRLIFT_STATE st;
+    /** \brief entities: pilot, hostess, passengers */
+    ENTITY *ent;
+    /** \brief simulated semaphores */
+    SEM sem[S_NU];
+    /** \brief wake up events (binary heap) */
+    WAKEUP *heap;
+    /** \brief number of pending wake up events */
+    unsigned int nHeap;
+    /** \brief wake up events inserted so far */
+    unsigned long nPushed;
+    /** \brief current simulated time (in microseconds) */
+    double now;
+    /** \brief state of the random generator */
+    unsigned long long rnd;
+    /** \brief start of the boarding of the current flight */
+    double tBoarding;
+    /** \brief run aborted for lack of memory */
+    bool failed;
+
+} ENGINE;
+
+/**
+ *  \brief Uniformly distributed random number in [0, 1] (splitmix64).
+ */
+
+static double uniform (ENGINE *e)
+{
+    unsigned long long z = (e->rnd += 0x9e3779b97f4a7c15ULL);
+
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    z ^= z >> 31;
+    return (double) (z >> 11) / (double) ((1ULL << 53) - 1);
+}
+
+static bool before (const WAKEUP *a, const WAKEUP *b)
+{
+    return (a->time < b->time) || ((a->time == b->time) && (a->seq < b->seq));
+}
+
+static void wakeAt (ENGINE *e, int ent, double time)
+{
+    unsigned int i = e->nHeap++;
+
+    e->heap[i].time = time;
+    e->heap[i].seq = e->nPushed++;
+    e->heap[i].ent = ent;
+    while ((i > 0) && before (&e->heap[i], &e->heap[(i-1)/2])) {
+        WAKEUP t = e->heap[i];
+
+        e->heap[i] = e->heap[(i-1)/2];
+        e->heap[(i-1)/2] = t;
+        i = (i - 1) / 2;
+    }
+}
+
+static WAKEUP nextWakeup (ENGINE *e)
+{
+    WAKEUP top = e->heap[0];
+    unsigned int i = 0;
+
+    e->heap[0] = e->heap[--e->nHeap];
+    for (;;) {
+        unsigned int l = 2 * i + 1, m = i;
+
+        if ((l < e->nHeap) && before (&e->heap[l], &e->heap[m]))
+            m = l;
+        if ((l + 1 < e->nHeap) && before (&e->heap[l+1], &e->heap[m]))
+            m = l + 1;
+        if (m == i)
+            break;
+        WAKEUP t = e->heap[i];
+        e->heap[i] = e->heap[m];
+        e->heap[m] = t;
+        i = m;
+    }
+
+    return top;
+}
+
+/**
+ *  \brief <em>Down</em> of a simulated semaphore.
+ *
+ *  \return true if the entity may proceed, false if it got blocked
+ */
+
+static bool down (ENGINE *e, unsigned int s, int ent)
+{
+    SEM *sem = &e->sem[s];
+
+    e->sim->res.nSemOps++;
+    if (sem->val > 0) {
+        sem->val--;
+        return true;
+    }
+    e->ent[ent].next = -1;
+    if (sem->tail == -1)
+        sem->head = ent;
+    else e->ent[sem->tail].next = ent;
+    sem->tail = ent;
+
+    return false;
+}
+
+/**
+ *  \brief <em>Up</em> of a simulated semaphore, the first blocked entity (if any) being resumed now.
+ */
+
+static void up (ENGINE *e, unsigned int s)
+{
+    SEM *sem = &e->sem[s];
+    int ent = sem->head;
+
+    e->sim->res.nSemOps++;
+    if (ent == -1) {
+        sem->val++;
+        return;
+    }
+    if ((sem->head = e->ent[ent].next) == -1)
+        sem->tail = -1;
+    wakeAt (e, ent, e->now);
+}
+
+static void saveState (ENGINE *e, unsigned int entity)
+{
+    airliftLogState (e->sim, &e->st);
+    airliftEmitState (e->sim, entity, e->now, &e->st);
+}
+
+/** \brief state of every passenger of a group saved in a single line */
+static void saveGroup (ENGINE *e, const ENTITY *leader)
+{
+    unsigned int k;
+
+    airliftLogState (e->sim, &e->st);
+    for (k = 0; k < leader->size; k++)
+        airliftEmitState (e->sim, leader->id + k, e->now, &e->st);
+}
+
+/** \brief size of the group at the head of the queue (0 if the queue is empty) */
+static unsigned int nextGroup (ENGINE *e)
+{
+    int ent = e->sem[S_PASSENGERSWAITINQUEUE].head;
+
+    return (ent == -1) ? 0 : e->ent[ent].size;
+}
+
+/**
+ *  \brief Size of a group, drawn from the configured distribution, within the capacity and the passengers left.
+ */
+
+static unsigned int drawGroup (ENGINE *e, unsigned int left)
+{
+    const double *dist = e->sim->cfg.groupDist;
+    double total = 0.0, u;
+    unsigned int g, k;
+
+    for (k = 0; k < AIRLIFT_MAXGROUP; k++)
+        total += dist[k];
+    for (g = AIRLIFT_MAXGROUP - 1; dist[g] == 0.0; g--)                        /* largest size with a weight */
+        ;
+    u = uniform (e) * total;
+    for (k = 0; (k < g) && ((dist[k] == 0.0) || (u >= dist[k])); k++)
+        u -= dist[k];
+    if (++k > e->sim->cfg.maxFC)
+        k = e->sim->cfg.maxFC;
+
+    return (k < left) ? k : left;
+}
+
+/**
+ *  \brief Pilot life cycle, resumed at its current point.
+ */
+
+static void pilot (ENGINE *e)
+{
+    ENTITY *me = &e->ent[0];
+    AIRLIFT_SIM *sim = e->sim;
+
+    switch (me->pc) {
+        case PT_FLIGHT_BACK:
+            if (e->st.finished) {
+                me->pc = DONE;
+                return;
+            }
+            e->st.pilotStat = FLYING_BACK;
+            saveState (e, AIRLIFT_PILOT);
+            me->pc = PT_BOARDING;
+            wakeAt (e, 0, e->now + floor (sim->cfg.maxFlight * uniform (e) + 100.0));
+            return;
+
+        case PT_BOARDING:
+            e->st.pilotStat = READY_FOR_BOARDING;
+            e->st.nFlight++;
+            e->tBoarding = e->now;
+            saveState (e, AIRLIFT_PILOT);
+            airliftLogEvent (sim, true, "Flight %u : Boarding Started\n", e->st.nFlight);
+            up (e, S_READYFORBOARDING);
+            e->st.pilotStat = WAITING_FOR_BOARDING;
+            saveState (e, AIRLIFT_PILOT);
+            me->pc = PT_FLIGHT_GO;
+            if (!down (e, S_READYTOFLIGHT, 0))
+                return;
+            /* falls through */
+
+        case PT_FLIGHT_GO:
+            e->st.pilotStat = FLYING;
+            saveState (e, AIRLIFT_PILOT);
+            me->pc = PT_DROP;
+            wakeAt (e, 0, e->now + floor (sim->cfg.maxFlight * uniform (e) + 100.0));
+            return;
+
+        case PT_DROP:
+            e->st.pilotStat = DROPING_PASSENGERS;
+            airliftLogEvent (sim, true, "Flight %u : Arrived \n", e->st.nFlight);
+            if (sim->cb.flightArrived != NULL)
+                sim->cb.flightArrived (sim->cb.ctx, e->st.nFlight, e->st.nPassInFlight, e->now);
+            saveState (e, AIRLIFT_PILOT);
+            up (e, S_PASSENGERSWAITINFLIGHT);
+            me->pc = PT_EMPTY;
+            if (!down (e, S_PLANEEMPTY, 0))
+                return;
+            /* falls through */
+
+        case PT_EMPTY:
+            airliftLogEvent (sim, true, "Flight %u : Returning \n", e->st.nFlight);
+            me->pc = PT_FLIGHT_BACK;
+            wakeAt (e, 0, e->now);
+            return;
+    }
+}
+
+/**
+ *  \brief Departure of the flight boarded, signaled by the hostess.
+ */
+
+static void depart (ENGINE *e)
+{
+    ENTITY *me = &e->ent[1];
+    AIRLIFT_SIM *sim = e->sim;
+
+    e->st.hostessStat = READY_TO_FLIGHT;
+    if (airliftRecordFlight (sim, e->st.nFlight, e->st.nPassInFlight) == -1) {
+        e->failed = true;
+        return;
+    }
+    if (e->st.totalPassBoarded == sim->cfg.nPassengers)
+        e->st.finished = true;
+    sim->res.boardingTime += e->now - e->tBoarding;
+    saveState (e, AIRLIFT_HOSTESS);
+    airliftLogEvent (sim, true, "Flight %u : Departed with %u passengers\n", e->st.nFlight, e->st.nPassInFlight);
+    if (sim->cb.flightDeparted != NULL)
+        sim->cb.flightDeparted (sim->cb.ctx, e->st.nFlight, e->st.nPassInFlight, e->now);
+    up (e, S_READYTOFLIGHT);
+    me->pc = HT_NEXT_FLIGHT;
+    wakeAt (e, 1, e->now);
+}
+
+/**
+ *  \brief Hostess life cycle, resumed at its current point.
+ */
+
+static void hostess (ENGINE *e)
+{
+    ENTITY *me = &e->ent[1];
+    AIRLIFT_SIM *sim = e->sim;
+    unsigned int size, k;
+    bool last;
+
+    switch (me->pc) {
+        case HT_NEXT_FLIGHT:
+            if (me->nChecked >= sim->cfg.nPassengers) {
+                me->pc = DONE;
+                return;
+            }
+            e->st.hostessStat = WAIT_FOR_FLIGHT;
+            saveState (e, AIRLIFT_HOSTESS);
+            me->pc = HT_WAIT_PASSENGER;
+            if (!down (e, S_READYFORBOARDING, 1))
+                return;
+            /* falls through */
+
+        case HT_WAIT_PASSENGER:
+            e->st.hostessStat = WAIT_FOR_PASSENGER;
+            saveState (e, AIRLIFT_HOSTESS);
+            me->pc = HT_CHECK;
+            if (!down (e, S_PASSENGERSINQUEUE, 1))
+                return;
+            /* falls through */
+
+        case HT_CHECK:
+            if (e->st.nPassInFlight + nextGroup (e) > sim->cfg.maxFC) {     /* the group waited for does not fit */
+                e->sem[S_PASSENGERSINQUEUE].val++;
+                depart (e);
+                return;
+            }
+            up (e, S_PASSENGERSWAITINQUEUE);
+            e->st.hostessStat = CHECK_PASSPORT;
+            saveState (e, AIRLIFT_HOSTESS);
+            me->pc = HT_CHECKED;
+            if (!down (e, S_IDSHOWN, 1))
+                return;
+            /* falls through */
+
+        case HT_CHECKED:
+            size = e->ent[AIRLIFT_PASSENGER (e->st.passengerChecked)].size;
+            e->st.totalPassBoarded += size;
+            e->st.nPassInQueue -= size;
+            e->st.nPassInFlight += size;
+            sim->res.nGroups++;
+            last = sim->ops->isLast (sim, &e->st) ||
+                   ((e->st.nPassInQueue > 0) && (e->st.nPassInFlight + nextGroup (e) > sim->cfg.maxFC));
+            saveState (e, AIRLIFT_HOSTESS);
+            for (k = 0; k < size; k++)
+                airliftLogEvent (sim, false, "Flight %u : Passenger %d checked\n", e->st.nFlight,
+                                 e->st.passengerChecked + (int) k);
+            me->nChecked += size;
+            if (!last) {
+                me->pc = HT_WAIT_PASSENGER;
+                wakeAt (e, 1, e->now);
+                return;
+            }
+            depart (e);
+            return;
+    }
+}
+
+/**
+ *  \brief Passenger life cycle, resumed at its current point; a leader runs it for its whole group.
+ */
+
+static void passenger (ENGINE *e, int ent)
+{
+    ENTITY *me = &e->ent[ent];
+    unsigned int p = me->id - AIRLIFT_PASSENGER (0), k;
+
+    switch (me->pc) {
+        case PG_TRAVEL:
+            me->pc = PG_QUEUE;
+            wakeAt (e, ent, e->now + floor (e->sim->cfg.maxTravel * uniform (e) + 1000.0));
+            return;
+
+        case PG_QUEUE:
+            up (e, S_PASSENGERSINQUEUE);
+            e->st.nPassInQueue += me->size;
+            for (k = 0; k < me->size; k++)
+                e->st.passengerStat[p + k] = IN_QUEUE;
+            me->tInQueue = e->now;
+            saveGroup (e, me);
+            me->pc = PG_CALLED;
+            if (!down (e, S_PASSENGERSWAITINQUEUE, ent))
+                return;
+            /* falls through */
+
+        case PG_CALLED:
+            e->st.passengerChecked = (int) p;
+            for (k = 0; k < me->size; k++) {
+                e->st.passengerStat[p + k] = IN_FLIGHT;
+                e->sim->passengerWait[p + k] = e->now - me->tInQueue;
+            }
+            saveGroup (e, me);
+            up (e, S_IDSHOWN);
+            me->pc = PG_LANDED;
+            if (!down (e, S_PASSENGERSWAITINFLIGHT, ent))
+                return;
+            /* falls through */
+
+        case PG_LANDED:
+            e->st.nPassInFlight -= me->size;
+            for (k = 0; k < me->size; k++)
+                e->st.passengerStat[p + k] = AT_DESTINATION;
+            if (e->st.nPassInFlight == 0)
+                up (e, S_PLANEEMPTY);
+            else up (e, S_PASSENGERSWAITINFLIGHT);
+            saveGroup (e, me);
+            me->pc = DONE;
+            return;
+    }
+}
+
+/**
+ *  \brief Run the discrete event engine.
+ *
+ *  \param sim simulation handle
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int airliftRunEvent (AIRLIFT_SIM *sim)
+{
+    ENGINE e;
+    unsigned int nEnt = sim->cfg.nPassengers + 2;
+    unsigned int i, k;
+    int stat = 0;
+
+    memset (&e, 0, sizeof (ENGINE));
+    e.sim = sim;
+    e.rnd = sim->rnd;
+    e.st.passengerStat = calloc (sim->cfg.nPassengers, sizeof (unsigned int));
+    e.ent = calloc (nEnt, sizeof (ENTITY));
+    e.heap = malloc (nEnt * sizeof (WAKEUP));
+    if ((e.st.passengerStat == NULL) || (e.ent == NULL) || (e.heap == NULL)) {
+        stat = -1;
+        goto out;
+    }
+    if ((airliftLogOpen (sim) == -1) || (airliftSampleOpen (sim) == -1)) {
+        stat = -1;
+        goto out;
+    }
+    for (i = 0; i < S_NU; i++)
+        e.sem[i].head = e.sem[i].tail = -1;
+
+    /* same initial state as the generator, entities started in the same order */
+
+    e.st.pilotStat = FLYING_BACK;
+    e.st.hostessStat = WAIT_FOR_FLIGHT;
+    for (i = 0; i < nEnt; i++) {
+        e.ent[i].id = i;
+        e.ent[i].next = -1;
+        e.ent[i].size = 1;
+    }
+    if (airliftGrouped (&sim->cfg))                            /* groups of consecutive passengers, led by the first */
+        for (i = 2; i < nEnt; i += e.ent[i].size) {
+            e.ent[i].size = drawGroup (&e, nEnt - i);
+            for (k = 1; k < e.ent[i].size; k++) {
+                e.ent[i + k].size = 0;
+                e.ent[i + k].pc = DONE;
+            }
+        }
+    for (i = 2; i < nEnt; i++)
+        if (e.ent[i].size != 0)
+            wakeAt (&e, (int) i, 0.0);
+    wakeAt (&e, 1, 0.0);
+    wakeAt (&e, 0, 0.0);
+
+    while ((e.nHeap > 0) && !e.failed) {
+        WAKEUP w = nextWakeup (&e);
+
+        airliftSample (sim, w.time, &e.st);
+        e.now = w.time;
+        if (w.ent == 0)
+            pilot (&e);
+        else if (w.ent == 1)
+            hostess (&e);
+        else passenger (&e, w.ent);
+    }
+
+    if (e.failed) {
+        errno = ENOMEM;
+        stat = -1;
+    }
+    else for (i = 0; i < nEnt; i++)
+             if (e.ent[i].pc != DONE) {                              /* some entity remained blocked forever */
+                 errno = EDEADLK;
+                 stat = -1;
+             }
+    sim->res.totalPassBoarded = e.st.totalPassBoarded;
+    sim->res.makespan = e.now;
+    sim->rnd = e.rnd;
+    airliftLogClose (sim);
+    airliftSampleClose (sim, e.now, &e.st);
+
+out:
+    free (e.st.passengerStat);
+    free (e.ent);
+    free (e.heap);
+
+    return stat;
+}
@@ -0,0 +1,737 @@
+/**
+ *  \file airliftExplore.c (implementation file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  State space explorer of the synchronization protocol.
+ *
+ *  The life cycles of the pilot, the hostess and the passengers are modelled, following the operations of the
+ *  SVIPC implementation step by step, as a transition system whose every reachable state is visited: each
+ *  semaphore operation outside the critical region is a transition of its own, each critical region (from the
+ *  <em>down</em> on <tt>mutex</tt> to the <em>up</em>) a single one, as nothing else can interleave with it but
+ *  operations on other data. Every interleaving is thus covered, where random runs only sample a few. Reported:
+ *    \li deadlocks: states other than the end of the air lift with no transition enabled
+ *    \li lost wakeups: <em>up</em> operations never matched by a <em>down</em> one by the end of the air lift
+ *    \li capacity rule violations: flights over the maximum capacity, or under the minimum one but for the last
+ *        flight, more flights than <tt>MAXNF</tt>, negative counters and air lifts ending with passengers not taken
+ *    \li the best and worst case numbers of handoffs (<em>up</em> operations on the semaphores other than
+ *        <tt>mutex</tt>, each passing control to another entity) per boarded passenger.
+ *
+ *  For every kind of violation found, the sequence of states leading to the first one is printed.
+ *
+ *  The passengers being identical, a state holds the number of passengers at each point of their life cycle rather
+ *  than the point of each one (symmetry reduction). Out of every state, a single transition is taken when it is
+ *  independent of every transition the other entities may ever execute (partial order reduction by persistent
+ *  sets: a critical region touching only the state of its entity, an <em>up</em> operation, a <em>down</em> one on
+ *  a semaphore no other entity may wait on), preserving every deadlock and every end state. The search is run by
+ *  several threads, each with a deque of states to expand, taking work from the others when out of it, the visited
+ *  states being kept in a lock free hash table shared by all.
+ *
+ *  Usage: <tt>airliftExplore [-n passengers] [-m min capacity] [-M max capacity] [-f max flights] [-j threads]
+ *  [-t log2 of the table size] [-r]</tt>, <tt>-r</tt> disabling the partial order reduction.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <sched.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "probConst.h"
+
+/* modelled semaphores (the critical regions being single transitions, mutex is not modelled) */
+
+/** \brief semaphore used by hostess to wait for passengers */
+#define  S_PASSENGERSINQUEUE          0
+/** \brief semaphore used by passengers to wait for hostess */
+#define  S_PASSENGERSWAITINQUEUE      1
+/** \brief semaphore used by passengers to wait for flight to end */
+#define  S_PASSENGERSWAITINFLIGHT     2
+/** \brief semaphore used by hostess to wait for starting boarding */
+#define  S_READYFORBOARDING           3
+/** \brief semaphore used by pilot to wait for boarding to complete */
+#define  S_READYTOFLIGHT              4
+/** \brief semaphore used by hostess to wait for passenger identification */
+#define  S_IDSHOWN                    5
+/** \brief semaphore used by pilot to wait for last passenger to leave plane */
+#define  S_PLANEEMPTY                 6
+/** \brief number of modelled semaphores */
+#define  S_NU                         7
+
+/* points of the life cycle of the pilot */
+
+/** \brief test of the end of the air lift (outside the critical region) */
+#define  PT_ISFINISHED                0
+/** \brief flight back (critical region) */
+#define  PT_FLIGHT_BACK               1
+/** \brief ready for boarding (critical region) */
+#define  PT_BOARDING                  2
+/** \brief up on readyForBoarding */
+#define  PT_UP_BOARDING               3
+/** \brief wait until ready to flight (critical region) */
+#define  PT_WAIT_FLIGHT               4
+/** \brief down on readyToFlight */
+#define  PT_DOWN_FLIGHT               5
+/** \brief flight (critical region) */
+#define  PT_FLIGHT_GO                 6
+/** \brief drop of the passengers (critical region) */
+#define  PT_DROP                      7
+/** \brief up on passengersWaitInFlight */
+#define  PT_UP_DROP                   8
+/** \brief down on planeEmpty */
+#define  PT_DOWN_EMPTY                9
+/** \brief flight returning (critical region) */
+#define  PT_RETURNING                10
+/** \brief end of the life cycle */
+#define  PT_END                      11
+
+/* points of the life cycle of the hostess */
+
+/** \brief test of the number of passengers checked */
+#define  HT_LOOP                      0
+/** \brief wait for next flight (critical region) */
+#define  HT_NEXT_FLIGHT               1
+/** \brief down on readyForBoarding */
+#define  HT_DOWN_BOARDING             2
+/** \brief wait for passenger (critical region) */
+#define  HT_WAIT_PASSENGER            3
+/** \brief down on passengersInQueue */
+#define  HT_DOWN_QUEUE                4
+/** \brief up on passengersWaitInQueue */
+#define  HT_UP_CALL                   5
+/** \brief passport check (critical region) */
+#define  HT_CHECK                     6
+/** \brief down on idShown */
+#define  HT_DOWN_ID                   7
+/** \brief passenger checked (critical region) */
+#define  HT_CHECKED                   8
+/** \brief ready to flight (critical region) */
+#define  HT_READY                     9
+/** \brief up on readyToFlight */
+#define  HT_UP_FLIGHT                10
+/** \brief end of the life cycle */
+#define  HT_END                      11
+
+/* points of the life cycle of a passenger */
+
+/** \brief up on passengersInQueue */
+#define  PG_UP_QUEUE                  0
+/** \brief in queue (critical region) */
+#define  PG_QUEUE                     1
+/** \brief down on passengersWaitInQueue */
+#define  PG_DOWN_CALL                 2
+/** \brief called (critical region) */
+#define  PG_CALLED                    3
+/** \brief up on idShown */
+#define  PG_UP_ID                     4
+/** \brief down on passengersWaitInFlight */
+#define  PG_DOWN_FLIGHT               5
+/** \brief landed (critical region) */
+#define  PG_LANDED                    6
+/** \brief end of the life cycle */
+#define  PG_END                       7
+/** \brief number of points of the life cycle of a passenger */
+#define  PG_NU                        8
+
+/* kinds of violation */
+
+/** \brief deadlock */
+#define  V_DEADLOCK                   0
+/** \brief up operations never matched by the end of the air lift */
+#define  V_LOST_WAKEUP                1
+/** \brief flight over the maximum capacity or under the minimum one */
+#define  V_CAPACITY                   2
+/** \brief more flights than the maximum */
+#define  V_FLIGHTS                    3
+/** \brief negative counter */
+#define  V_COUNTER                    4
+/** \brief air lift over with passengers not taken */
+#define  V_INCOMPLETE                 5
+/** \brief number of kinds of violation */
+#define  V_NU                         6
+
+/** \brief largest number of passengers */
+#define  MAXPG                      100
+
+/**
+ *  \brief Definition of <em>model state</em> data type.
+ */
+typedef struct
+{ /** \brief point of the life cycle of the pilot */
+    unsigned char pilot;
+    /** \brief point of the life cycle of the hostess */
+    unsigned char hostess;
+    /** \brief passengers checked by the hostess (local to the hostess) */
+    unsigned char nPassengers;
+    /** \brief value of the semaphores */
+    unsigned char sem[S_NU];
+    /** \brief number of passengers in queue */
+    unsigned char nPassInQueue;
+    /** \brief number of passengers in flight */
+    unsigned char nPassInFlight;
+    /** \brief number of passengers boarded */
+    unsigned char totalPassBoarded;
+    /** \brief number of flights */
+    unsigned char nFlight;
+    /** \brief air lift finished */
+    unsigned char finished;
+    /** \brief number of passengers at each point of their life cycle */
+    unsigned char pass[PG_NU];
+    /** \brief handoffs so far */
+    unsigned short handoffs;
+
+} STATE;
+
+/**
+ *  \brief Definition of <em>visited state</em> data type.
+ */
+typedef struct
+{ /** \brief state */
+    STATE st;
+    /** \brief slot of the state it was first reached from (its own for the initial state) */
+    unsigned int parent;
+    /** \brief 0 (free), 1 (being stored) or 2 (stored) */
+    unsigned char status;
+
+} SLOT;
+
+/**
+ *  \brief Definition of <em>work deque</em> data type.
+ *
+ *  Slots of the states to expand by a thread: taken by it at the bottom, by the others at the top.
+ */
+typedef struct
+{ /** \brief access protection */
+    pthread_mutex_t lock;
+    /** \brief slots (circular buffer) */
+    unsigned int *item;
+    /** \brief capacity (a power of 2) */
+    unsigned int cap;
+    /** \brief position of the oldest slot */
+    unsigned int top;
+    /** \brief position past the newest slot */
+    unsigned int bottom;
+    /** \brief seed of the choice of the threads to take work from */
+    unsigned int seed;
+
+} DEQUE;
+
+static const char *ptName[] = { "isFinished", "flight back", "signalReadyForBoarding", "up readyForBoarding",
+                                "waitUntilReadyToFlight", "down readyToFlight", "flight", "dropPassengersAtTarget",
+                                "up passengersWaitInFlight", "down planeEmpty", "flight returning", "end" };
+static const char *htName[] = { "loop", "waitForNextFlight", "down readyForBoarding", "waitForPassenger",
+                                "down passengersInQueue", "up passengersWaitInQueue", "checkPassport", "down idShown",
+                                "passenger checked", "signalReadyToFlight", "up readyToFlight", "end" };
+static const char *vName[] = { "deadlock", "lost wakeup", "capacity violation", "flight limit violation",
+                               "negative counter", "incomplete air lift" };
+
+/* model parameters */
+static unsigned int nPass = N, minFC = MINFC, maxFC = MAXFC, maxNF = MAXNF;
+static bool reduce = true;
+
+/* visited states */
+static SLOT *table;
+static unsigned int mask;
+static unsigned long long nStates = 0, nTrans = 0;
+
+/* search */
+static DEQUE *deque;
+static unsigned int nThreads;
+static long long pending = 0;
+
+/* results, protected by resLock */
+static pthread_mutex_t resLock = PTHREAD_MUTEX_INITIALIZER;
+static unsigned long long nViol[V_NU], nEnd = 0;
+static unsigned int firstViol[V_NU];
+static unsigned int minHandoffs = ~0U, maxHandoffs = 0, minFlights = ~0U, maxFlights = 0;
+
+static unsigned long long hash (const STATE *s)
+{
+    const unsigned char *p = (const unsigned char *) s;
+    unsigned long long h = 0xcbf29ce484222325ULL;
+    size_t k;
+
+    for (k = 0; k < sizeof (STATE); k++)
+        h = (h ^ p[k]) * 0x100000001b3ULL;
+    return h ^ (h >> 29);
+}
+
+/* a state stored, if not yet visited: true if new, its slot in idx */
+static bool visit (const STATE *s, unsigned int parent, unsigned int *idx)
+{
+    unsigned int i = (unsigned int) hash (s) & mask, n;
+    unsigned char st, free;
+
+    for (n = 0; n <= mask; n++, i = (i + 1) & mask) {
+        st = __atomic_load_n (&table[i].status, __ATOMIC_ACQUIRE);
+        if (st == 0) {
+            free = 0;
+            if (__atomic_compare_exchange_n (&table[i].status, &free, 1, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+                table[i].st = *s;
+                table[i].parent = (parent == ~0U) ? i : parent;
+                __atomic_store_n (&table[i].status, 2, __ATOMIC_RELEASE);
+                if (__atomic_add_fetch (&nStates, 1, __ATOMIC_RELAXED) > (mask / 10) * 9) {
+                    fprintf (stderr, "state table full: raise its size (-t)\n");
+                    exit (EXIT_FAILURE);
+                }
+                *idx = i;
+                return true;
+            }
+            st = free;
+        }
+        while (st == 1)
+            st = __atomic_load_n (&table[i].status, __ATOMIC_ACQUIRE);
+        if (memcmp (&table[i].st, s, sizeof (STATE)) == 0) {
+            *idx = i;
+            return false;
+        }
+    }
+    return false;
+}
+
+static void push (DEQUE *d, unsigned int idx)
+{
+    unsigned int *item, k;
+
+    pthread_mutex_lock (&d->lock);
+    if (d->bottom - d->top == d->cap) {
+        if ((item = malloc (2 * d->cap * sizeof (unsigned int))) == NULL) {
+            perror ("error on growing a work deque");
+            exit (EXIT_FAILURE);
+        }
+        for (k = d->top; k != d->bottom; k++)
+            item[k & (2 * d->cap - 1)] = d->item[k & (d->cap - 1)];
+        free (d->item);
+        d->item = item;
+        d->cap *= 2;
+    }
+    d->item[d->bottom++ & (d->cap - 1)] = idx;
+    pthread_mutex_unlock (&d->lock);
+}
+
+static bool pop (DEQUE *d, unsigned int *idx)
+{
+    bool found;
+
+    pthread_mutex_lock (&d->lock);
+    if ((found = (d->bottom != d->top)))
+        *idx = d->item[--d->bottom & (d->cap - 1)];
+    pthread_mutex_unlock (&d->lock);
+
+    return found;
+}
+
+/* half of the work of another thread taken */
+static bool steal (DEQUE *self)
+{
+    unsigned int v = (unsigned int) rand_r (&self->seed) % nThreads, k, n, taken[256];
+    DEQUE *d = &deque[v];
+
+    if (d == self)
+        return false;
+    pthread_mutex_lock (&d->lock);
+    n = (d->bottom - d->top + 1) / 2;
+    if (n > 256)
+        n = 256;
+    for (k = 0; k < n; k++)
+        taken[k] = d->item[d->top++ & (d->cap - 1)];
+    pthread_mutex_unlock (&d->lock);
+    for (k = 0; k < n; k++)
+        push (self, taken[k]);
+
+    return n > 0;
+}
+
+static void violation (unsigned int kind, unsigned int idx)
+{
+    pthread_mutex_lock (&resLock);
+    if (nViol[kind]++ == 0)
+        firstViol[kind] = idx;
+    pthread_mutex_unlock (&resLock);
+}
+
+/* transition of the pilot: false if not enabled, violation in viol */
+static bool stepPilot (const STATE *s, STATE *t, int *viol)
+{
+    *t = *s;
+    switch (s->pilot) {
+        case PT_ISFINISHED:  t->pilot = s->finished ? PT_END : PT_FLIGHT_BACK; break;
+        case PT_BOARDING:    if (++t->nFlight > maxNF)
+                                 *viol = V_FLIGHTS;
+                             t->pilot = PT_UP_BOARDING;
+                             break;
+        case PT_UP_BOARDING: t->sem[S_READYFORBOARDING]++;
+                             t->handoffs++;
+                             t->pilot = PT_WAIT_FLIGHT;
+                             break;
+        case PT_DOWN_FLIGHT: if (s->sem[S_READYTOFLIGHT] == 0)
+                                 return false;
+                             t->sem[S_READYTOFLIGHT]--;
+                             t->pilot = PT_FLIGHT_GO;
+                             break;
+        case PT_UP_DROP:     t->sem[S_PASSENGERSWAITINFLIGHT]++;
+                             t->handoffs++;
+                             t->pilot = PT_DOWN_EMPTY;
+                             break;
+        case PT_DOWN_EMPTY:  if (s->sem[S_PLANEEMPTY] == 0)
+                                 return false;
+                             t->sem[S_PLANEEMPTY]--;
+                             t->pilot = PT_RETURNING;
+                             break;
+        case PT_RETURNING:   t->pilot = PT_ISFINISHED; break;
+        case PT_END:         return false;
+        default:             t->pilot++;                           /* critical regions on the pilot state only */
+    }
+    return true;
+}
+
+/* transition of the hostess: false if not enabled, violation in viol */
+static bool stepHostess (const STATE *s, STATE *t, int *viol)
+{
+    bool last;
+
+    *t = *s;
+    switch (s->hostess) {
+        case HT_LOOP:           t->hostess = (s->nPassengers < nPass) ? HT_NEXT_FLIGHT : HT_END; break;
+        case HT_DOWN_BOARDING:  if (s->sem[S_READYFORBOARDING] == 0)
+                                    return false;
+                                t->sem[S_READYFORBOARDING]--;
+                                t->hostess = HT_WAIT_PASSENGER;
+                                break;
+        case HT_DOWN_QUEUE:     if (s->sem[S_PASSENGERSINQUEUE] == 0)
+                                    return false;
+                                t->sem[S_PASSENGERSINQUEUE]--;
+                                t->hostess = HT_UP_CALL;
+                                break;
+        case HT_UP_CALL:        t->sem[S_PASSENGERSWAITINQUEUE]++;
+                                t->handoffs++;
+                                t->hostess = HT_CHECK;
+                                break;
+        case HT_DOWN_ID:        if (s->sem[S_IDSHOWN] == 0)
+                                    return false;
+                                t->sem[S_IDSHOWN]--;
+                                t->hostess = HT_CHECKED;
+                                break;
+        case HT_CHECKED:        if (s->nPassInQueue == 0)
+                                    *viol = V_COUNTER;
+                                t->totalPassBoarded++;
+                                t->nPassInQueue--;
+                                if (++t->nPassInFlight > maxFC)
+                                    *viol = V_CAPACITY;
+                                last = (t->nPassInFlight == maxFC) ||
+                                       ((t->nPassInFlight >= minFC) && (t->nPassInQueue == 0)) ||
+                                       (t->totalPassBoarded == nPass);
+                                t->nPassengers++;
+                                t->hostess = last ? HT_READY : HT_WAIT_PASSENGER;
+                                break;
+        case HT_READY:          if ((s->nPassInFlight > maxFC) ||
+                                    ((s->nPassInFlight < minFC) && (s->totalPassBoarded != nPass)))
+                                    *viol = V_CAPACITY;
+                                t->finished = (s->totalPassBoarded == nPass);
+                                t->hostess = HT_UP_FLIGHT;
+                                break;
+        case HT_UP_FLIGHT:      t->sem[S_READYTOFLIGHT]++;
+                                t->handoffs++;
+                                t->hostess = HT_LOOP;
+                                break;
+        case HT_END:            return false;
+        default:                t->hostess++;                   /* critical regions on the hostess state only */
+    }
+    return true;
+}
+
+/* transition of a passenger at point p: false if not enabled, violation in viol */
+static bool stepPassenger (const STATE *s, unsigned int p, STATE *t, int *viol)
+{
+    if ((p == PG_END) || (s->pass[p] == 0))
+        return false;
+    *t = *s;
+    switch (p) {
+        case PG_UP_QUEUE:    t->sem[S_PASSENGERSINQUEUE]++;
+                             t->handoffs++;
+                             break;
+        case PG_QUEUE:       t->nPassInQueue++; break;
+        case PG_DOWN_CALL:   if (s->sem[S_PASSENGERSWAITINQUEUE] == 0)
+                                 return false;
+                             t->sem[S_PASSENGERSWAITINQUEUE]--;
+                             break;
+        case PG_UP_ID:       t->sem[S_IDSHOWN]++;
+                             t->handoffs++;
+                             break;
+        case PG_DOWN_FLIGHT: if (s->sem[S_PASSENGERSWAITINFLIGHT] == 0)
+                                 return false;
+                             t->sem[S_PASSENGERSWAITINFLIGHT]--;
+                             break;
+        case PG_LANDED:      if (s->nPassInFlight == 0) {
+                                 *viol = V_COUNTER;
+                                 break;
+                             }
+                             if (--t->nPassInFlight == 0)
+                                 t->sem[S_PLANEEMPTY]++;
+                             else t->sem[S_PASSENGERSWAITINFLIGHT]++;
+                             t->handoffs++;
+                             break;
+    }
+    t->pass[p]--;
+    t->pass[p + 1]++;
+
+    return true;
+}
+
+/* passengers that may still reach point p */
+static unsigned int reaching (const STATE *s, unsigned int p)
+{
+    unsigned int k, n = 0;
+
+    for (k = 0; k <= p; k++)
+        n += s->pass[k];
+    return n;
+}
+
+/*
+ * Transition of entity e (0 the pilot, 1 the hostess, 2 + p a passenger at point p) independent of every transition
+ * the other entities may ever execute, so a persistent set by itself when enabled.
+ */
+static bool independent (const STATE *s, unsigned int e)
+{
+    if (e == 0)                                                          /* finished is written by the hostess */
+        return (s->pilot != PT_ISFINISHED) || (s->hostess == HT_END);
+    if (e == 1)                                        /* passengers counters, read by the passengers */
+        return (s->hostess != HT_CHECKED) && (s->hostess != HT_READY);
+    switch (e - 2) {
+        case PG_QUEUE:       return s->hostess == HT_END;
+        case PG_DOWN_CALL:   return reaching (s, PG_DOWN_CALL) == 1;          /* no other passenger may wait */
+        case PG_DOWN_FLIGHT: return reaching (s, PG_DOWN_FLIGHT) == 1;
+        case PG_LANDED:      return (reaching (s, PG_LANDED) == 1) && (s->hostess == HT_END);
+        default:             return true;
+    }
+}
+
+static bool step (const STATE *s, unsigned int e, STATE *t, int *viol)
+{
+    *viol = -1;
+    if (e == 0)
+        return stepPilot (s, t, viol);
+    if (e == 1)
+        return stepHostess (s, t, viol);
+    return stepPassenger (s, e - 2, t, viol);
+}
+
+/* end of the air lift, or deadlock */
+static void stuck (const STATE *s, unsigned int idx)
+{
+    unsigned int k;
+    bool lost = false;
+
+    if ((s->pilot != PT_END) || (s->hostess != HT_END) || (s->pass[PG_END] != nPass)) {
+        violation (V_DEADLOCK, idx);
+        return;
+    }
+    for (k = 0; k < S_NU; k++)
+        lost |= (s->sem[k] != 0);
+    if (lost)
+        violation (V_LOST_WAKEUP, idx);
+    if ((s->totalPassBoarded != nPass) || (s->nPassInQueue != 0) || (s->nPassInFlight != 0))
+        violation (V_INCOMPLETE, idx);
+    pthread_mutex_lock (&resLock);
+    nEnd++;
+    if (s->handoffs < minHandoffs)
+        minHandoffs = s->handoffs;
+    if (s->handoffs > maxHandoffs)
+        maxHandoffs = s->handoffs;
+    if (s->nFlight < minFlights)
+        minFlights = s->nFlight;
+    if (s->nFlight > maxFlights)
+        maxFlights = s->nFlight;
+    pthread_mutex_unlock (&resLock);
+}
+
+/* a successor reached: queued for expansion if new and not violating any rule */
+static void reach (DEQUE *d, unsigned int idx, const STATE *t, int viol)
+{
+    unsigned int tIdx;
+
+    if (!visit (t, idx, &tIdx))
+        return;
+    if (viol != -1)
+        violation ((unsigned int) viol, tIdx);                                    /* not explored any further */
+    else {
+        __atomic_add_fetch (&pending, 1, __ATOMIC_RELAXED);
+        push (d, tIdx);
+    }
+}
+
+static void expand (DEQUE *d, unsigned int idx)
+{
+    STATE s = table[idx].st, t;
+    unsigned int e, nEnabled = 0;
+    int viol;
+
+    if (reduce)
+        for (e = 0; e < 2 + PG_NU; e++)
+            if (step (&s, e, &t, &viol) && independent (&s, e)) {
+                nEnabled = 1;
+                reach (d, idx, &t, viol);
+                break;
+            }
+    if (nEnabled == 0)
+        for (e = 0; e < 2 + PG_NU; e++)
+            if (step (&s, e, &t, &viol)) {
+                nEnabled++;
+                reach (d, idx, &t, viol);
+            }
+    if (nEnabled == 0)
+        stuck (&s, idx);
+    __atomic_add_fetch (&nTrans, nEnabled, __ATOMIC_RELAXED);
+}
+
+static void *worker (void *arg)
+{
+    DEQUE *d = arg;
+    unsigned int idx;
+
+    while (true) {
+        if (pop (d, &idx)) {
+            expand (d, idx);
+            __atomic_sub_fetch (&pending, 1, __ATOMIC_RELAXED);
+        }
+        else if (!steal (d)) {
+            if (__atomic_load_n (&pending, __ATOMIC_RELAXED) == 0)
+                break;
+            sched_yield ();
+        }
+    }
+    return NULL;
+}
+
+static void printState (const STATE *s)
+{
+    unsigned int k;
+
+    printf ("  pilot %-25s hostess %-25s passengers", ptName[s->pilot], htName[s->hostess]);
+    for (k = 0; k < PG_NU; k++)
+        printf (" %2u", s->pass[k]);
+    printf ("  sems");
+    for (k = 0; k < S_NU; k++)
+        printf (" %u", s->sem[k]);
+    printf ("  InQ %u InF %u toB %u flights %u\n", s->nPassInQueue, s->nPassInFlight, s->totalPassBoarded,
+            s->nFlight);
+}
+
+/* states leading to a slot */
+static void printTrace (unsigned int idx)
+{
+    unsigned int len = 0, k, n, *path;
+
+    for (k = idx; table[k].parent != k; k = table[k].parent)
+        len++;
+    if ((path = malloc ((len + 1) * sizeof (unsigned int))) == NULL)
+        return;
+    for (k = idx, n = len; ; k = table[k].parent, n--) {
+        path[n] = k;
+        if (n == 0)
+            break;
+    }
+    for (n = 0; n <= len; n++)
+        printState (&table[path[n]].st);
+    free (path);
+}
+
+/**
+ *  \brief Main program.
+ */
+
+int main (int argc, char *argv[])
+{
+    unsigned int logSize = 22, k, idx, nViolTotal = 0;
+    pthread_t *thread;
+    struct timespec t0, t1;
+    double elapsed;
+    STATE init;
+    int opt;
+
+    nThreads = (unsigned int) sysconf (_SC_NPROCESSORS_ONLN);
+    while ((opt = getopt (argc, argv, "n:m:M:f:j:t:r")) != -1) {
+        switch (opt) {
+            case 'n': nPass = (unsigned int) atoi (optarg); break;
+            case 'm': minFC = (unsigned int) atoi (optarg); break;
+            case 'M': maxFC = (unsigned int) atoi (optarg); break;
+            case 'f': maxNF = (unsigned int) atoi (optarg); break;
+            case 'j': nThreads = (unsigned int) atoi (optarg); break;
+            case 't': logSize = (unsigned int) atoi (optarg); break;
+            case 'r': reduce = false; break;
+            default:
+                fprintf (stderr, "USAGE: %s [-n passengers] [-m min capacity] [-M max capacity] [-f max flights] "
+                                 "[-j threads] [-t log2 of the table size] [-r]\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    if ((nPass == 0) || (nPass > MAXPG) || (minFC == 0) || (minFC > maxFC) || (maxFC > MAXPG) || (maxNF > 255) ||
+        (nThreads == 0) || (logSize < 10) || (logSize > 31)) {
+        fprintf (stderr, "%s: passengers (1 .. %d), capacities (1 <= min <= max), flights (up to 255), threads "
+                         "and table size (10 .. 31) out of range\n", argv[0], MAXPG);
+        return EXIT_FAILURE;
+    }
+
+    mask = (1U << logSize) - 1;
+    if (((table = calloc ((size_t) mask + 1, sizeof (SLOT))) == NULL) ||
+        ((deque = calloc (nThreads, sizeof (DEQUE))) == NULL) ||
+        ((thread = calloc (nThreads, sizeof (pthread_t))) == NULL)) {
+        perror ("error on allocating the state table");
+        return EXIT_FAILURE;
+    }
+    for (k = 0; k < nThreads; k++) {
+        pthread_mutex_init (&deque[k].lock, NULL);
+        deque[k].cap = 1024;
+        deque[k].seed = k + 1;
+        if ((deque[k].item = malloc (deque[k].cap * sizeof (unsigned int))) == NULL) {
+            perror ("error on allocating the work deques");
+            return EXIT_FAILURE;
+        }
+    }
+
+    memset (&init, 0, sizeof (STATE));                              /* padding included, states being compared */
+    init.pilot = PT_ISFINISHED;
+    init.hostess = HT_LOOP;
+    init.pass[PG_UP_QUEUE] = (unsigned char) nPass;
+    visit (&init, ~0U, &idx);
+    pending = 1;
+    push (&deque[0], idx);
+
+    clock_gettime (CLOCK_MONOTONIC, &t0);
+    for (k = 0; k < nThreads; k++)
+        if (pthread_create (&thread[k], NULL, worker, &deque[k]) != 0) {
+            perror ("error on creating a search thread");
+            return EXIT_FAILURE;
+        }
+    for (k = 0; k < nThreads; k++)
+        pthread_join (thread[k], NULL);
+    clock_gettime (CLOCK_MONOTONIC, &t1);
+    elapsed = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+
+    printf ("# state space: %u passengers, flight capacity %u .. %u, at most %u flights, %u threads, %s\n", nPass,
+            minFC, maxFC, maxNF, nThreads, reduce ? "partial order reduction" : "no reduction");
+    printf ("states %llu  transitions %llu  end states %llu  time %.3f s (%.0f states/s)\n", nStates, nTrans, nEnd,
+            elapsed, nStates / ((elapsed > 0.0) ? elapsed : 1e-9));
+    if (nEnd > 0) {
+        printf ("flights per air lift: %u .. %u\n", minFlights, maxFlights);
+        printf ("handoffs per boarded passenger: best %.2f  worst %.2f (%u .. %u per air lift)\n",
+                (double) minHandoffs / nPass, (double) maxHandoffs / nPass, minHandoffs, maxHandoffs);
+    }
+    for (k = 0; k < V_NU; k++) {
+        printf ("%s%ss %llu", (k == 0) ? "" : "  ", vName[k], nViol[k]);
+        nViolTotal += (nViol[k] != 0);
+    }
+    printf ("\n");
+    for (k = 0; k < V_NU; k++)
+        if (nViol[k] != 0) {
+            printf ("\n# first %s (passengers per point: queue up, in queue, wait call, called, id shown, wait in "
+                    "flight, landed, at destination)\n", vName[k]);
+            printTrace (firstViol[k]);
+        }
+
+    return (nViolTotal == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,173 @@
+/**
+ *  \file airliftInternal.h (interface file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  Embeddable simulation library (libairlift).
+ *
+ *  Internal definitions shared between the library front end and its engines:
+ *     \li the simulation handle
+ *     \li the run-time sized state of the problem
+ *     \li result and event recording
+ *     \li writing the logging file in the format of the generator
+ *     \li writing the column file of the event history
+ *     \li sampling the state at a fixed period of simulated time.
+ */
+
+#ifndef AIRLIFTINTERNAL_H_
+#define AIRLIFTINTERNAL_H_
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "airlift.h"
+
+/**
+ *  \brief Definition of <em>full state of the problem</em> data type, sized at run time.
+ *
+ *  Counterpart of FULL_STAT for a configurable number of passengers.
+ */
+typedef struct
+{ /** \brief pilot state */
+    unsigned int pilotStat;
+    /** \brief hostess state */
+    unsigned int hostessStat;
+    /** \brief passengers state array (nPassengers entries) */
+    unsigned int *passengerStat;
+    /** \brief flight number */
+    unsigned int nFlight;
+    /** \brief number of passengers waiting */
+    unsigned int nPassInQueue;
+    /** \brief number of passengers flying */
+    unsigned int nPassInFlight;
+    /** \brief total number of passengers already boarded in every flight */
+    unsigned int totalPassBoarded;
+    /** \brief air lift finished */
+    bool finished;
+    /** \brief passenger id of last passenger to check passport */
+    int passengerChecked;
+
+} AIRLIFT_STATE;
+
+/**
+ *  \brief Definition of <em>problem size dependent code paths</em> data type.
+ */
+typedef struct
+{ /** \brief number of passengers the paths are specialized for (0 for the generic paths) */
+    unsigned int nPassengers;
+    /** \brief min flight capacity the paths are specialized for */
+    unsigned int minFC;
+    /** \brief max flight capacity the paths are specialized for */
+    unsigned int maxFC;
+    /** \brief write the full state as a single line of the logging file */
+    void (*logState) (struct airliftSim *sim, const AIRLIFT_STATE *st);
+    /** \brief hostess capacity rule: true if the passenger just checked is the last one of the flight */
+    bool (*isLast) (const struct airliftSim *sim, const AIRLIFT_STATE *st);
+
+} AIRLIFT_OPS;
+
+/** \brief column file writer (airliftColumns.c) */
+typedef struct airliftColWriter AIRLIFT_COL_WRITER;
+
+/**
+ *  \brief Definition of the simulation handle.
+ */
+struct airliftSim
+{ /** \brief configuration (strings are owned copies) */
+    AIRLIFT_CONFIG cfg;
+    /** \brief registered callbacks */
+    AIRLIFT_CALLBACKS cb;
+    /** \brief last known state of every entity, used to detect transitions */
+    unsigned int *lastStat;
+    /** \brief number of passengers at each flight */
+    unsigned int *nPassengersInFlight;
+    /** \brief time each passenger waited in queue */
+    double *passengerWait;
+    /** \brief allocated entries of nPassengersInFlight */
+    unsigned int nFlightsCap;
+    /** \brief results of the last run */
+    AIRLIFT_RESULT res;
+    /** \brief results are available */
+    bool done;
+    /** \brief logging file, open during a run */
+    FILE *log;
+    /** \brief samples file, open during a run */
+    FILE *samples;
+    /** \brief next sampling instant */
+    double nextSample;
+    /** \brief problem size dependent code paths, selected on creation */
+    const AIRLIFT_OPS *ops;
+    /** \brief header line of the logging file */
+    char *header;
+    /** \brief length of the header line */
+    size_t headerLen;
+    /** \brief state line buffer of the generic paths */
+    char *line;
+    /** \brief state of the random generator of the event engine, carried over successive runs */
+    unsigned long long rnd;
+    /** \brief column file writer, NULL when there is no column file */
+    AIRLIFT_COL_WRITER *col;
+};
+
+/** \brief select the code paths for a configuration */
+extern const AIRLIFT_OPS *airliftSelectOps (const AIRLIFT_CONFIG *cfg);
+
+/** \brief build the header line and the state line buffer of a simulation */
+extern int airliftBuildLines (AIRLIFT_SIM *sim);
+
+/** \brief run the discrete event engine */
+extern int airliftRunEvent (AIRLIFT_SIM *sim);
+
+/** \brief run the SVIPC processes engine */
+extern int airliftRunProcess (AIRLIFT_SIM *sim);
+
+/** \brief passengers travelling in groups */
+extern bool airliftGrouped (const AIRLIFT_CONFIG *cfg);
+
+/** \brief reset the results and the transition tracking before a run */
+extern void airliftBeginRun (AIRLIFT_SIM *sim);
+
+/** \brief record the number of passengers of a flight (1 .. n) */
+extern int airliftRecordFlight (AIRLIFT_SIM *sim, unsigned int flight, unsigned int nPassengers);
+
+/** \brief report the state of one entity, the state transition callback being called when it changed */
+extern void airliftEmitState (AIRLIFT_SIM *sim, unsigned int entity, double time, const AIRLIFT_STATE *st);
+
+/** \brief open the logging file, if any, and write its title and header */
+extern int airliftLogOpen (AIRLIFT_SIM *sim);
+
+/** \brief write the full state as a single line */
+extern void airliftLogState (AIRLIFT_SIM *sim, const AIRLIFT_STATE *st);
+
+/** \brief write an event line, optionally followed by the header */
+extern void airliftLogEvent (AIRLIFT_SIM *sim, bool header, const char *fmt, ...)
+                            __attribute__ ((format (printf, 3, 4)));
+
+/** \brief write the summary of the air lift and close the logging file */
+extern void airliftLogClose (AIRLIFT_SIM *sim);
+
+/** \brief open the samples file, if sampling is enabled, and write its header */
+extern int airliftSampleOpen (AIRLIFT_SIM *sim);
+
+/** \brief write a sample for every sampling instant before a given time */
+extern void airliftSample (AIRLIFT_SIM *sim, double time, const AIRLIFT_STATE *st);
+
+/** \brief write the samples up to the end of the run and close the samples file */
+extern void airliftSampleClose (AIRLIFT_SIM *sim, double time, const AIRLIFT_STATE *st);
+
+/** \brief create a column file */
+extern AIRLIFT_COL_WRITER *airliftColCreate (const char *path);
+
+/** \brief begin a run of the column file */
+extern void airliftColBeginRun (AIRLIFT_COL_WRITER *wr);
+
+/** \brief append an event to the current run of the column file */
+extern void airliftColAppend (AIRLIFT_COL_WRITER *wr, const AIRLIFT_EVENT *ev);
+
+/** \brief end the current run of the column file, writing its columns */
+extern int airliftColEndRun (AIRLIFT_COL_WRITER *wr);
+
+/** \brief write the footer of the column file and close it */
+extern int airliftColFinish (AIRLIFT_COL_WRITER *wr);
+
+#endif /* AIRLIFTINTERNAL_H_ */
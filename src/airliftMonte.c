@@ -0,0 +1,271 @@
+/**
+ *  \file airliftMonte.c (implementation file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  Monte Carlo driver.
+ *
+ *  Runs many replications of a configuration with the vectorized replication engine of the library, replication
+ *  <tt>r</tt> with seed <tt>seed + r</tt>, and writes the summary of each of them in the format of the generator
+ *  (<tt>saveAirLiftResult</tt>), so the output may be fed to <tt>airliftStats</tt>. The replication rate is reported
+ *  on the standard error; optionally, every replication is also run by the discrete event engine, both results
+ *  being compared and both rates reported.
+ *
+ *  Given the weights of the group sizes, it studies passengers travelling in groups instead: every replication is
+ *  run by the discrete event engine with the passengers alone and in groups, and the means of both are compared
+ *  (handoffs and semaphore operations per passenger, boarding time and occupancy per flight, makespan and wait).
+ *
+ *  Options:
+ *    \li <tt>-r runs</tt>: number of replications (default 10000)
+ *    \li <tt>-j threads</tt>: number of threads (default: the processors online)
+ *    \li <tt>-s seed</tt>: seed of the first replication (default 1)
+ *    \li <tt>-N passengers -m min -M max</tt>: problem size (default: probConst.h)
+ *    \li <tt>-q</tt>: no summaries, only the means over the replications
+ *    \li <tt>-c</tt>: check every replication against the discrete event engine
+ *    \li <tt>-g w1,w2,...</tt>: weights of the group sizes 1, 2, ... (up to <tt>AIRLIFT_MAXGROUP</tt>).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+
+#include "airlift.h"
+
+/**
+ *  \brief Definition of <em>driver state</em> data type.
+ */
+typedef struct
+{ /** \brief configuration */
+    AIRLIFT_CONFIG cfg;
+    /** \brief summaries not written */
+    bool quiet;
+    /** \brief sums over the replications: flights, makespan and passenger waits */
+    double flights, makespan, wait;
+    /** \brief results kept for the check against the event engine (NULL if none) */
+    unsigned int *nFlights;
+    double *makespans, *waits;
+
+} DRIVER;
+
+/** \brief elapsed time (in seconds) */
+static double now (void)
+{
+    struct timespec t;
+
+    clock_gettime (CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+static void replication (void *ctx, unsigned long run, const AIRLIFT_RESULT *res)
+{
+    DRIVER *d = ctx;
+    unsigned int n = d->cfg.nPassengers, f, p;
+
+    d->flights += res->nFlights;
+    d->makespan += res->makespan;
+    for (p = 0; p < n; p++)
+        d->wait += res->passengerWait[p];
+    if (d->nFlights != NULL) {
+        d->nFlights[run] = res->nFlights;
+        d->makespans[run] = res->makespan;
+        for (p = 0; p < n; p++)
+            d->waits[run * n + p] = res->passengerWait[p];
+    }
+    if (d->quiet)
+        return;
+    printf ("AirLift result\n");
+    printf ("AirLift used %u Flights\n", res->nFlights);
+    for (f = 0; f < res->nFlights; f++)
+        printf ("Flight %u took %2u passengers\n", f + 1, res->nPassengersInFlight[f]);
+    printf ("AirLift took %.0f us\n", res->makespan);
+    for (p = 0; p < n; p++)
+        printf ("Passenger %02u waited %.0f us\n", p, res->passengerWait[p]);
+}
+
+/* every replication run by the event engine: number of mismatches, -1 on error */
+static long check (DRIVER *d, unsigned long nRuns, double *elapsed)
+{
+    AIRLIFT_CONFIG cfg = d->cfg;
+    AIRLIFT_SIM *sim;
+    AIRLIFT_RESULT res;
+    unsigned long r, bad = 0;
+    unsigned int p;
+    bool same;
+    double t0 = now ();
+
+    for (r = 0; r < nRuns; r++) {
+        cfg.seed = d->cfg.seed + r;
+        if (((sim = airliftCreate (&cfg)) == NULL) || (airliftRun (sim, AIRLIFT_ENGINE_EVENT) == -1) ||
+            (airliftGetResult (sim, &res) == -1))
+            return -1;
+        same = (res.nFlights == d->nFlights[r]) && (res.makespan == d->makespans[r]);
+        for (p = 0; same && (p < cfg.nPassengers); p++)
+            same = (res.passengerWait[p] == d->waits[r * cfg.nPassengers + p]);
+        if (!same && (bad++ < 10))
+            fprintf (stderr, "replication %lu (seed %lu) differs from the event engine\n", r, cfg.seed);
+        airliftDestroy (sim);
+    }
+    *elapsed = now () - t0;
+
+    return (long) bad;
+}
+
+/**
+ *  \brief Definition of <em>group study figures</em> data type.
+ *
+ *  Sums over the replications run with the passengers alone or in groups.
+ */
+typedef struct
+{ /** \brief handoffs (groups checked) and semaphore operations */
+    double handoffs, semOps;
+    /** \brief flights and time spent boarding */
+    double flights, boarding;
+    /** \brief makespan and passenger waits */
+    double makespan, wait;
+
+} FIGURES;
+
+static int study (AIRLIFT_CONFIG *cfg, unsigned long run, FIGURES *fig)
+{
+    AIRLIFT_SIM *sim;
+    AIRLIFT_RESULT res;
+    unsigned int p;
+
+    cfg->seed += run;
+    if (((sim = airliftCreate (cfg)) == NULL) || (airliftRun (sim, AIRLIFT_ENGINE_EVENT) == -1) ||
+        (airliftGetResult (sim, &res) == -1))
+        return -1;
+    cfg->seed -= run;
+    fig->handoffs += res.nGroups;
+    fig->semOps += res.nSemOps;
+    fig->flights += res.nFlights;
+    fig->boarding += res.boardingTime;
+    fig->makespan += res.makespan;
+    for (p = 0; p < cfg->nPassengers; p++)
+        fig->wait += res.passengerWait[p];
+    airliftDestroy (sim);
+
+    return 0;
+}
+
+static void compare (const char *name, double alone, double grouped)
+{
+    printf ("%-34s %12.3f %12.3f %+9.1f%%\n", name, alone, grouped,
+            (alone == 0.0) ? 0.0 : (grouped - alone) * 100.0 / alone);
+}
+
+/* every replication with the passengers alone and in groups, means compared */
+static int groups (DRIVER *d, unsigned long nRuns, const double *dist)
+{
+    AIRLIFT_CONFIG cfg = d->cfg;
+    FIGURES alone = { 0 }, grouped = { 0 };
+    double n = (double) nRuns * cfg.nPassengers;
+    unsigned long r;
+
+    for (r = 0; r < nRuns; r++) {
+        memset (cfg.groupDist, 0, sizeof (cfg.groupDist));
+        if (study (&cfg, r, &alone) == -1)
+            return -1;
+        memcpy (cfg.groupDist, dist, sizeof (cfg.groupDist));
+        if (study (&cfg, r, &grouped) == -1)
+            return -1;
+    }
+    printf ("%-34s %12s %12s %10s\n", "means over the replications", "alone", "groups", "change");
+    compare ("handoffs per passenger", alone.handoffs / n, grouped.handoffs / n);
+    compare ("semaphore operations per passenger", alone.semOps / n, grouped.semOps / n);
+    compare ("boarding time per flight (us)", alone.boarding / alone.flights, grouped.boarding / grouped.flights);
+    compare ("passengers per flight", n / alone.flights, n / grouped.flights);
+    compare ("flights per run", alone.flights / nRuns, grouped.flights / nRuns);
+    compare ("makespan (us)", alone.makespan / nRuns, grouped.makespan / nRuns);
+    compare ("passenger wait (us)", alone.wait / n, grouped.wait / n);
+
+    return 0;
+}
+
+/**
+ *  \brief Main program.
+ */
+
+int main (int argc, char *argv[])
+{
+    DRIVER d = { 0 };
+    unsigned long nRuns = 10000;
+    long nThreads = sysconf (_SC_NPROCESSORS_ONLN), bad;
+    bool verify = false, grouped = false;
+    double t0, tVector, tEvent, dist[AIRLIFT_MAXGROUP] = { 0.0 };
+    char *w;
+    unsigned int g;
+    int opt;
+
+    airliftDefaultConfig (&d.cfg);
+    while ((opt = getopt (argc, argv, "r:j:s:N:m:M:qcg:")) != -1) {
+        switch (opt) {
+            case 'r': nRuns = strtoul (optarg, NULL, 10); break;
+            case 'j': nThreads = atol (optarg); break;
+            case 's': d.cfg.seed = strtoul (optarg, NULL, 10); break;
+            case 'N': d.cfg.nPassengers = (unsigned int) atoi (optarg); break;
+            case 'm': d.cfg.minFC = (unsigned int) atoi (optarg); break;
+            case 'M': d.cfg.maxFC = (unsigned int) atoi (optarg); break;
+            case 'q': d.quiet = true; break;
+            case 'c': verify = true; break;
+            case 'g':
+                for (g = 0, w = strtok (optarg, ","); (w != NULL) && (g < AIRLIFT_MAXGROUP); w = strtok (NULL, ","))
+                    dist[g++] = strtod (w, NULL);
+                grouped = true;
+                break;
+            default:
+                fprintf (stderr, "USAGE: %s [-r runs] [-j threads] [-s seed] [-N passengers] [-m min] [-M max] "
+                                 "[-q] [-c] [-g w1,w2,...]\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    if ((nRuns == 0) || (nThreads < 1)) {
+        fprintf (stderr, "%s: at least one replication and one thread are required\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (grouped) {
+        if (groups (&d, nRuns, dist) == -1) {
+            perror ("error on a group study run");
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+    if (verify && (((d.nFlights = malloc (nRuns * sizeof (unsigned int))) == NULL) ||
+                   ((d.makespans = malloc (nRuns * sizeof (double))) == NULL) ||
+                   ((d.waits = malloc (nRuns * d.cfg.nPassengers * sizeof (double))) == NULL))) {
+        perror ("error on allocating the results checked");
+        return EXIT_FAILURE;
+    }
+
+    t0 = now ();
+    if (airliftReplicate (&d.cfg, nRuns, (unsigned int) nThreads, replication, &d) == -1) {
+        perror ("error on the replications");
+        return EXIT_FAILURE;
+    }
+    tVector = now () - t0;
+    if (fflush (stdout) == EOF) {
+        perror ("error on writing the summaries");
+        return EXIT_FAILURE;
+    }
+    fprintf (stderr, "vector engine : %lu runs  N=%u  %ld threads  %.3f s  %.0f runs/s\n", nRuns,
+             d.cfg.nPassengers, nThreads, tVector, nRuns / tVector);
+    fprintf (stderr, "means per run : %.3f flights  makespan %.1f us  passenger wait %.1f us\n", d.flights / nRuns,
+             d.makespan / nRuns, d.wait / nRuns / d.cfg.nPassengers);
+
+    if (verify) {
+        if ((bad = check (&d, nRuns, &tEvent)) == -1) {
+            perror ("error on an event engine run");
+            return EXIT_FAILURE;
+        }
+        fprintf (stderr, "event engine  : %lu runs  %.3f s  %.0f runs/s  (vector engine %.1fx)\n", nRuns, tEvent,
+                 nRuns / tEvent, tEvent / tVector);
+        fprintf (stderr, "%ld replications differ from the event engine\n", bad);
+        if (bad != 0)
+            return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
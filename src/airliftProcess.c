@@ -0,0 +1,342 @@
+/**
+ *  \file airliftProcess.c (implementation file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  Embeddable simulation library (libairlift).
+ *
+ *  SVIPC processes engine.
+ *
+ *  The run is carried out exactly as by the generator: the shared memory region and the semaphore set are created,
+ *  the pilot, hostess and passenger programs are generated as separate processes and their termination is waited
+ *  for. A private access key is used on each run and the logging state is kept per thread, so several simulations
+ *  may run concurrently, in separate host processes or in threads of the same one.
+ *
+ *  Since the entities are separate programs, the events are only known through the logging file; when callbacks
+ *  are registered, the logging file (a temporary one if none was configured) is read back after the run, its state
+ *  lines timed.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/time.h>
+#include <zlib.h>
+
+#include "probConst.h"
+#include "probDataStruct.h"
+#include "logging.h"
+#include "sharedDataSync.h"
+#include "semaphore.h"
+#include "sharedMemory.h"
+#include "airlift.h"
+#include "airliftInternal.h"
+#include "journal.h"
+#include "control.h"
+
+/** \brief name of pilot program */
+#define   PILOT         "pilot"
+
+/** \brief name of hostess program */
+#define   HOSTESS       "hostess"
+
+/** \brief name of passenger program */
+#define   PASSENGER     "passenger"
+
+/** \brief runs started by this process, in any of its threads, used to build private access keys */
+static unsigned int nRuns = 0;
+
+/**
+ *  \brief Generation of one intervening entity process.
+ *
+ *  The state lines are timed (<tt>AIRLIFT_LOG_TIME</tt>) only when <tt>timed</tt> is set, the environment being
+ *  left alone otherwise.
+ *
+ *  \return process identifier, upon success
+ *  \return -\c 1, when the fork fails
+ */
+
+static pid_t spawn (const char *binDir, const char *prog, char *const args[], bool timed)
+{
+    char path[512];
+    pid_t pid;
+
+    snprintf (path, sizeof (path), "%s/%s", (binDir == NULL) ? "." : binDir, prog);
+    if ((pid = fork ()) == 0) {
+        if (timed)
+            setenv ("AIRLIFT_LOG_TIME", "1", 1);                   /* state lines timed, for the replay of the log */
+        execv (path, args);
+        perror ("error on the generation of an intervening entity process");
+        _exit (EXIT_FAILURE);
+    }
+
+    return pid;
+}
+
+/**
+ *  \brief Reading the logging file back, delivering the callbacks in its order.
+ *
+ *  Compressed logging files are read transparently. The entities time their state lines (<tt>AIRLIFT_LOG_TIME</tt>),
+ *  so the events carry the time they were logged at, and the flight events the time of the latest state line.
+ */
+
+static void replayLog (AIRLIFT_SIM *sim, const char *nFic)
+{
+    gzFile fic;
+    char line[16 * (N + 8)];
+    AIRLIFT_STATE st;
+    unsigned int passengerStat[N];
+    unsigned int flight, n;
+    double t = -1.0;                                              /* time of the latest state line, -1 if unknown */
+
+    if ((fic = gzopen (nFic, "r")) == NULL)
+        return;
+    memset (&st, 0, sizeof (AIRLIFT_STATE));
+    st.passengerStat = passengerStat;
+    while (gzgets (fic, line, sizeof (line)) != NULL) {
+        unsigned int v[N + 5];
+        unsigned int k = 0, p;
+        char *s = line, *end;
+
+        if (sscanf (line, "Flight %u : Departed with %u passengers", &flight, &n) == 2) {
+            if (sim->cb.flightDeparted != NULL)
+                sim->cb.flightDeparted (sim->cb.ctx, flight, n, t);
+            continue;
+        }
+        if ((sscanf (line, "Flight %u : Arrived", &flight) == 1) && (strstr (line, "Arrived") != NULL)) {
+            if (sim->cb.flightArrived != NULL)
+                sim->cb.flightArrived (sim->cb.ctx, flight, st.nPassInFlight, t);
+            continue;
+        }
+        if (sscanf (line, "Flight %u : Boarding Started", &flight) == 1)
+            st.nFlight = flight;
+        while (k < N + 5) {
+            v[k] = (unsigned int) strtoul (s, &end, 10);
+            if (end == s)
+                break;
+            s = end;
+            k++;
+        }
+        if (k != N + 5)                                                   /* not a state line */
+            continue;
+        t = strtod (s, &end);                                           /* time elapsed, when the lines are timed */
+        if (end == s)
+            t = -1.0;
+        if ((v[0] == READY_FOR_BOARDING) && (st.pilotStat != READY_FOR_BOARDING))
+            st.nFlight++;                              /* the boarding line comes after the state line of the pilot */
+        st.pilotStat = v[0];
+        st.hostessStat = v[1];
+        for (p = 0; p < N; p++)
+            passengerStat[p] = v[2+p];
+        st.nPassInQueue = v[N+2];
+        st.nPassInFlight = v[N+3];
+        st.totalPassBoarded = v[N+4];
+        airliftEmitState (sim, AIRLIFT_PILOT, t, &st);
+        airliftEmitState (sim, AIRLIFT_HOSTESS, t, &st);
+        for (p = 0; p < N; p++)
+            airliftEmitState (sim, AIRLIFT_PASSENGER (p), t, &st);
+    }
+    gzclose (fic);
+}
+
+/**
+ *  \brief Run the SVIPC processes engine.
+ *
+ *  The entity programs are built with fixed problem parameters, so the configuration must match them.
+ *
+ *  \param sim simulation handle
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int airliftRunProcess (AIRLIFT_SIM *sim)
+{
+    char nFic[51];                                                                             /* name of logging file */
+    char nFicErr[] = "/dev/null";                                                      /* error files are discarded */
+    char num[2][12];                                                     /* numeric value conversion (up to 10 digits) */
+    int shmid, semgid = -1, key = -1;
+    SHARED_DATA *sh;
+    pid_t pid[N+2], pidMG = 0;
+    struct timeval t0, t1;
+    unsigned int p, f, run, nSpawned = 0;
+    int status, err = 0;
+    bool tmpLog = false, replay;
+
+    if ((sim->cfg.nPassengers != N) || (sim->cfg.minFC != MINFC) || (sim->cfg.maxFC != MAXFC) ||
+        airliftGrouped (&sim->cfg)) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    /* logging file: the configured one, a temporary one if callbacks or the column file need it, none otherwise */
+
+    replay = (sim->cb.stateChanged != NULL) || (sim->cb.flightDeparted != NULL) || (sim->cb.flightArrived != NULL) ||
+             (sim->col != NULL);
+    if (sim->cfg.logFile != NULL) {
+        if (strlen (sim->cfg.logFile) >= sizeof (nFic)) {
+            errno = ENAMETOOLONG;
+            return -1;
+        }
+        strcpy (nFic, sim->cfg.logFile);
+    }
+    else if (replay) {
+        int fd;
+
+        strcpy (nFic, "/tmp/airliftXXXXXX");
+        if ((fd = mkstemp (nFic)) == -1)
+            return -1;
+        close (fd);
+        tmpLog = true;
+    }
+    else strcpy (nFic, "/dev/null");
+
+    /* creating the shared memory region and the semaphore set under a private access key, the next one being
+       tried while either is taken */
+
+    do {
+        run = __atomic_fetch_add (&nRuns, 1, __ATOMIC_RELAXED);
+        key = (int) (((getpid () & 0x7fff) << 16) | ((run & 0xfff) << 4) | 0xa);
+        if (((shmid = shmemCreate (key, sizeof (SHARED_DATA))) != -1) &&
+            ((semgid = semCreate (key, SEM_NU)) == -1)) {
+            int semErr = errno;
+
+            shmemDestroy (shmid);
+            shmid = -1;
+            errno = semErr;
+        }
+    } while ((shmid == -1) && (errno == EEXIST));
+    if (shmid == -1)
+        return -1;
+    if (shmemAttach (shmid, (void **) &sh) == -1) {
+        err = errno;
+        semDestroy (semgid);
+        shmemDestroy (shmid);
+        errno = err;
+        return -1;
+    }
+    setLogBuffer (&sh->logBuf);
+    sprintf (num[1], "%d", key);
+
+    /* initialize problem internal status, as the generator does */
+
+    memset (sh, 0, sizeof (SHARED_DATA));
+    sh->fSt.st.pilotStat   = FLYING_BACK;
+    sh->fSt.st.hostessStat = WAIT_FOR_FLIGHT;
+    for (p = 0; p < N; p++)
+        sh->fSt.st.passengerStat[p] = GOING_TO_AIRPORT;
+    sh->fSt.finished = false;
+    controlSelect (&sh->control);
+    setLogControl (&sh->control);
+    createLog (nFic);
+
+    sh->mutex = MUTEX;
+    sh->passengersInQueue = PASSENGERSINQUEUE;
+    sh->passengersWaitInQueue = PASSENGERSWAITINQUEUE;
+    sh->passengersWaitInFlight = PASSENGERSWAITINFLIGHT;
+    sh->readyForBoarding = READYFORBOARDING;
+    sh->readyToFlight = READYTOFLIGHT;
+    sh->idShown = IDSHOWN;
+    sh->planeEmpty = PLANEEMPTY;
+
+    if (semUp (semgid, sh->mutex) == -1) {
+        err = errno;
+        goto out;
+    }
+
+    /* merger of the journals of the intervening entities, when enabled */
+
+    if ((pidMG = startMerger (sh, nFic)) == -1) {
+        pidMG = 0;
+        err = errno;
+        goto out;
+    }
+
+    /* generation of intervening entities processes */
+
+    gettimeofday (&t0, NULL);
+    startClock (&sh->fSt);
+    for (p = 0; p < N; p++) {
+        sprintf (num[0], "%u", p);
+        char *args[] = { PASSENGER, num[0], nFic, num[1], nFicErr, NULL };
+
+        if ((pid[nSpawned] = spawn (sim->cfg.binDir, PASSENGER, args, replay)) == -1) {
+            err = errno;
+            break;
+        }
+        nSpawned++;
+    }
+    if (err == 0) {
+        char *args[] = { HOSTESS, nFic, num[1], nFicErr, NULL };
+
+        if ((pid[nSpawned] = spawn (sim->cfg.binDir, HOSTESS, args, replay)) == -1)
+            err = errno;
+        else nSpawned++;
+    }
+    if (err == 0) {
+        char *args[] = { PILOT, nFic, num[1], nFicErr, NULL };
+
+        if ((pid[nSpawned] = spawn (sim->cfg.binDir, PILOT, args, replay)) == -1)
+            err = errno;
+        else nSpawned++;
+    }
+
+    /* signaling start of operations; on failure, removing the semaphore set releases the entities */
+
+    if ((err == 0) && (semSignal (semgid) == -1))
+        err = errno;
+    if (err != 0) {
+        semDestroy (semgid);
+        semgid = -1;
+    }
+
+    /* waiting for the termination of the intervening entities processes */
+
+    for (p = 0; p < nSpawned; p++)
+        if ((waitpid (pid[p], &status, 0) == -1) ||
+            (!WIFEXITED (status) || (WEXITSTATUS (status) != EXIT_SUCCESS))) {
+            if (err == 0)
+                err = ECHILD;
+        }
+    gettimeofday (&t1, NULL);
+    if ((stopMerger (sh, pidMG) == -1) && (err == 0))
+        err = errno;
+
+    if (err == 0) {
+        sh->fSt.makespan = elapsedTime (&sh->fSt);
+        saveAirLiftResult (nFic, &sh->fSt);
+        for (p = 0; p < N; p++)
+            sim->passengerWait[p] = sh->fSt.wait[p];
+        sim->res.totalPassBoarded = sh->fSt.totalPassBoarded;
+        sim->res.makespan = (t1.tv_sec - t0.tv_sec) * 1e6 + (t1.tv_usec - t0.tv_usec);
+        for (f = 0; (f < sh->fSt.nFlight) && (f < MAXNF); f++)
+            if (airliftRecordFlight (sim, f + 1, sh->fSt.nPassengersInFlight[f]) == -1) {
+                err = ENOMEM;
+                break;
+            }
+    }
+
+out:
+    if (semgid != -1)
+        semDestroy (semgid);
+    setLogBuffer (NULL);
+    setLogControl (NULL);
+    shmemDettach (sh);
+    shmemDestroy (shmid);
+
+    if ((err == 0) && (strcmp (nFic, "/dev/null") != 0))
+        replayLog (sim, nFic);
+    if (tmpLog)
+        unlink (nFic);
+    if (err != 0) {
+        errno = err;
+        return -1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,729 @@
+/**
+ *  \file airliftScale.c (implementation file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  Scaling suite.
+ *
+ *  Runs the simulation at growing numbers of passengers with every engine and logging backend:
+ *    \li the generator program, with plain, compressed, io_uring and journal logging files
+ *    \li the discrete event engine of the library, with a plain logging file
+ *    \li the vectorized replication engine of the library (one replication, no logging file)
+ *    \li the SVIPC processes engine of the library, with a plain logging file.
+ *
+ *  Every run is a child process in a process group of its own, sampled through <tt>/proc</tt> while it lasts. It
+ *  measures the startup time (until the process group reached its largest number of processes), the wall time, the
+ *  peak total resident set size of the group, the processes and the semaphores it used, the context switches
+ *  (of the run and of the processes it waited for) and the bytes of the logging file, both per passenger.
+ *
+ *  A run fails when it does not exit successfully, when it outlasts the time limit, when its logging file grows
+ *  beyond the size limit (the state lines hold every passenger, so the file grows with the square of the size) or
+ *  when an entity wrote to its error file; the last line written on the standard error is kept as the reason.
+ *  Larger sizes are then skipped for that engine and backend, so the report flags the first size at which each of
+ *  them stops scaling, along with the kernel limits in force (processes per user, <tt>SEMMSL</tt>, <tt>SEMMNS</tt>,
+ *  <tt>SEMMNI</tt>).
+ *
+ *  The generator runs use the SVIPC programs built for each size in <tt>N<size></tt> (<tt>make sized SIZE=size</tt>
+ *  or <tt>make scaling</tt>), the problem size being fixed when they are compiled; the processes engine of the
+ *  library runs them from there too.
+ *
+ *  Options:
+ *    \li <tt>-s sizes</tt>: numbers of passengers, separated by commas or spaces (default 10,100,1000,10000,100000)
+ *    \li <tt>-e engines</tt>: engines or engine:backend pairs run, separated by commas (default: all of them)
+ *    \li <tt>-t seconds</tt>: time limit of a run (default 600)
+ *    \li <tt>-l MiB</tt>: size limit of the logging file of a run (default 1024)
+ *    \li <tt>-o file</tt>: report in CSV format (default: the standard output)
+ *    \li <tt>-H file</tt>: report in HTML format, with log-log curves of every measure.
+ *
+ *  It must be run in the directory holding the programs.
+ */
+
+#define _GNU_SOURCE                                                                                    /* seminfo */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <signal.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <errno.h>
+#include <math.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/ipc.h>
+#include <sys/sem.h>
+
+#include "probConst.h"
+#include "sharedDataSync.h"
+#include "semaphore.h"
+#include "sharedMemory.h"
+#include "airlift.h"
+
+/** \brief name of generator program */
+#define   GENERATOR     "./probSemSharedMemAirLift"
+
+/** \brief largest number of sizes */
+#define   MAXSIZES      16
+
+/** \brief sampling period of a run (us) */
+#define   PERIOD        5000
+
+/* engines */
+
+/** \brief generator program */
+#define   ENG_GENERATOR 0
+/** \brief discrete event engine of the library */
+#define   ENG_EVENT     1
+/** \brief vectorized replication engine of the library */
+#define   ENG_VECTOR    2
+/** \brief SVIPC processes engine of the library */
+#define   ENG_PROCESS   3
+
+/* outcomes of a run */
+
+/** \brief not run */
+#define   SKIPPED       0
+/** \brief run successfully */
+#define   PASSED        1
+/** \brief run failed */
+#define   FAILED        2
+/** \brief run outlasted the time limit */
+#define   TIMEOUT       3
+
+/**
+ *  \brief Definition of <em>engine and backend</em> data type.
+ */
+typedef struct
+{ /** \brief engine */
+    unsigned int engine;
+    /** \brief names of the engine and of the logging backend */
+    const char *name, *backend;
+    /** \brief logging sink (<tt>AIRLIFT_LOG_SINK</tt>, NULL for the default one) */
+    const char *sink;
+    /** \brief name of the logging file (NULL if there is none) */
+    const char *log;
+
+} CASE;
+
+/** \brief engines and backends run */
+static const CASE cases[] = {
+    { ENG_GENERATOR, "generator", "plain", NULL, "scale.log" },
+    { ENG_GENERATOR, "generator", "gzip", NULL, "scale.log.gz" },
+    { ENG_GENERATOR, "generator", "uring", "uring", "scale.log" },
+    { ENG_GENERATOR, "generator", "journal", "journal", "scale.log" },
+    { ENG_EVENT, "event", "plain", NULL, "scale.log" },
+    { ENG_VECTOR, "vector", "none", NULL, NULL },
+    { ENG_PROCESS, "process", "plain", NULL, "scale.log" }
+};
+
+/** \brief number of engines and backends */
+#define   NCASES        (sizeof (cases) / sizeof (cases[0]))
+
+/**
+ *  \brief Definition of <em>measures of a run</em> data type.
+ */
+typedef struct
+{ /** \brief outcome */
+    unsigned int outcome;
+    /** \brief startup and wall times (s) */
+    double startup, wall;
+    /** \brief peak total resident set size (KiB) */
+    double rss;
+    /** \brief processes and semaphores used */
+    double procs, sems;
+    /** \brief context switches and bytes of the logging file, per passenger */
+    double csw, logBytes;
+    /** \brief reason of a failure */
+    char reason[160];
+
+} MEASURE;
+
+/** \brief number of measures plotted */
+#define   NMEASURES     7
+
+/** \brief names of the measures plotted */
+static const char *measureNames[NMEASURES] = { "startup time (s)", "wall time (s)", "peak total RSS (KiB)",
+                                               "processes", "semaphores", "context switches per passenger",
+                                               "log bytes per passenger" };
+
+/** \brief sizes run, ascending */
+static unsigned int sizes[MAXSIZES], nSizes = 0;
+
+/** \brief engines and backends selected */
+static bool selected[NCASES];
+
+/** \brief measures of every run */
+static MEASURE res[NCASES][MAXSIZES];
+
+/** \brief elapsed time (in seconds) */
+static double now (void)
+{
+    struct timespec t;
+
+    clock_gettime (CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+static double measureOf (const MEASURE *m, unsigned int k)
+{
+    switch (k) {
+        case 0: return m->startup;
+        case 1: return m->wall;
+        case 2: return m->rss;
+        case 3: return m->procs;
+        case 4: return m->sems;
+        case 5: return m->csw;
+        default: return m->logBytes;
+    }
+}
+
+/* semaphores in use in the system */
+static double semaphoresInUse (void)
+{
+    struct seminfo info;
+
+    return (semctl (0, 0, SEM_INFO, (struct seminfo *) &info) == -1) ? 0.0 : info.semaem;
+}
+
+/* processes of a group and their total resident set size (KiB) */
+static void scan (pid_t pgrp, double *procs, double *rss)
+{
+    DIR *dir;
+    struct dirent *d;
+    char name[300], buf[512], *p;
+    long pageKiB = sysconf (_SC_PAGESIZE) / 1024, pages;
+    int pg, fd;
+    ssize_t len;
+
+    *procs = *rss = 0.0;
+    if ((dir = opendir ("/proc")) == NULL)
+        return;
+    while ((d = readdir (dir)) != NULL) {
+        if ((d->d_name[0] < '0') || (d->d_name[0] > '9'))
+            continue;
+        snprintf (name, sizeof (name), "/proc/%s/stat", d->d_name);
+        if ((fd = open (name, O_RDONLY)) == -1)
+            continue;
+        len = read (fd, buf, sizeof (buf) - 1);
+        close (fd);
+        if ((len <= 0) || ((p = strrchr ((buf[len] = '\0', buf), ')')) == NULL))
+            continue;
+        /* fields after the command: state ppid pgrp session tty tpgid flags minflt cminflt majflt cmajflt utime
+           stime cutime cstime priority nice threads itrealvalue starttime vsize rss */
+        if ((sscanf (p + 1, " %*c %*d %d %*d %*d %*d %*u %*u %*u %*u %*u %*u %*u %*d %*d %*d %*d %*d %*d %*u %*u "
+                     "%ld", &pg, &pages) == 2) && (pg == pgrp)) {
+            *procs += 1.0;
+            *rss += (double) (pages * pageKiB);
+        }
+    }
+    closedir (dir);
+}
+
+static void discard (void *ctx, unsigned long run, const AIRLIFT_RESULT *res)
+{
+    (void) ctx;
+    (void) run;
+    (void) res;
+}
+
+/* the run of an engine, in the child process */
+static void child (const CASE *c, unsigned int n, const char *dir)
+{
+    AIRLIFT_CONFIG cfg;
+    AIRLIFT_SIM *sim;
+    char log[64];
+    int fd;
+
+    setpgid (0, 0);
+    if ((fd = open ("/dev/null", O_WRONLY)) != -1)
+        dup2 (fd, STDOUT_FILENO);
+    if (c->sink != NULL)
+        setenv ("AIRLIFT_LOG_SINK", c->sink, 1);
+    else unsetenv ("AIRLIFT_LOG_SINK");
+    if (c->engine == ENG_GENERATOR) {
+        snprintf (log, sizeof (log), "../%s", c->log);
+        if (chdir (dir) == -1) {
+            fprintf (stderr, "programs not built for N=%u (make sized SIZE=%u)\n", n, n);
+            _exit (EXIT_FAILURE);
+        }
+        execl (GENERATOR, GENERATOR, log, NULL);
+        perror ("error on the generation of the generator process");
+        _exit (EXIT_FAILURE);
+    }
+
+    airliftDefaultConfig (&cfg);
+    cfg.nPassengers = n;
+    cfg.logFile = c->log;
+    cfg.binDir = dir;
+    if (c->engine == ENG_VECTOR) {
+        if (airliftReplicate (&cfg, 1, 1, discard, NULL) == -1) {
+            perror ("error on the replication");
+            exit (EXIT_FAILURE);
+        }
+        exit (EXIT_SUCCESS);
+    }
+    if ((c->engine == ENG_PROCESS) && (n != N)) {
+        fprintf (stderr, "the processes engine of the library is built for N=%d\n", N);
+        exit (EXIT_FAILURE);
+    }
+    if (((sim = airliftCreate (&cfg)) == NULL) ||
+        (airliftRun (sim, (c->engine == ENG_EVENT) ? AIRLIFT_ENGINE_EVENT : AIRLIFT_ENGINE_PROCESS) == -1)) {
+        perror ("error on the run");
+        exit (EXIT_FAILURE);
+    }
+    airliftDestroy (sim);
+    exit (EXIT_SUCCESS);
+}
+
+/* last line of a file, at most size - 1 characters */
+static void lastLine (const char *name, char *line, size_t size)
+{
+    FILE *fic;
+    char buf[256];
+
+    if ((fic = fopen (name, "r")) == NULL)
+        return;
+    while (fgets (buf, sizeof (buf), fic) != NULL)
+        if (buf[strspn (buf, " \t\r\n")] != '\0') {
+            buf[strcspn (buf, "\r\n")] = '\0';
+            snprintf (line, size, "%s", buf);
+        }
+    fclose (fic);
+}
+
+/* error files of the entities written to */
+static unsigned int errorFiles (const char *dir, char *first, size_t size)
+{
+    DIR *d;
+    struct dirent *e;
+    struct stat st;
+    char name[PATH_MAX];
+    unsigned int k = 0;
+
+    if ((d = opendir (dir)) == NULL)
+        return 0;
+    while ((e = readdir (d)) != NULL) {
+        if (strncmp (e->d_name, "error_", 6) != 0)
+            continue;
+        snprintf (name, sizeof (name), "%s/%s", dir, e->d_name);
+        if ((stat (name, &st) == 0) && (st.st_size > 0) && (k++ == 0))
+            lastLine (name, first, size);
+    }
+    closedir (d);
+
+    return k;
+}
+
+/* leftover processes and IPC resources of a run that failed */
+static void release (const CASE *c, const char *dir, pid_t pid)
+{
+    struct timespec nap = { 0, PERIOD * 1000L };
+    double procs, rss;
+    unsigned int k;
+    int key, id;
+    SHARED_DATA *sh;
+
+    kill (-pid, SIGKILL);
+    for (k = 0; k < 1000000 / PERIOD; k++) {                              /* gone within a second, as a rule */
+        scan (pid, &procs, &rss);
+        if (procs == 0.0)
+            break;
+        nanosleep (&nap, NULL);
+    }
+    if (c->engine == ENG_GENERATOR)
+        key = ftok (dir, 'a');
+    else if (c->engine == ENG_PROCESS)
+        key = (int) (((pid & 0x7fff) << 16) | 0xa);                          /* first key tried by the engine */
+    else return;
+    if (key == -1)
+        return;
+    if ((id = semget (key, 1, 0600)) != -1)
+        semSignal (id);                                          /* start of operations, if it was not yet signalled */
+    if ((id = semConnect (key)) != -1)
+        semDestroy (id);
+    if ((id = shmemConnect (key)) != -1) {
+        if (shmemAttach (id, (void **) &sh) != -1) {          /* the journals first in the region, whatever the size */
+            if (sh->journals)
+                shmemDestroy (sh->journalShmid);
+            shmemDettach (sh);
+        }
+        shmemDestroy (id);
+    }
+}
+
+/**
+ *  \brief Run of an engine and backend at a size.
+ */
+
+static void measure (const CASE *c, unsigned int n, unsigned int timeout, double maxLog, MEASURE *m)
+{
+    char dir[32], err[] = "scale.err";
+    double t0, t, base, procs, rss, sems;
+    struct rusage ru;
+    struct stat st;
+    struct timespec nap = { 0, PERIOD * 1000L };
+    unsigned int k;
+    pid_t pid, w;
+    int status, fd;
+
+    snprintf (dir, sizeof (dir), "N%u", n);
+    memset (m, 0, sizeof (MEASURE));
+    if (c->log != NULL)
+        unlink (c->log);
+    if ((fd = open (err, O_WRONLY | O_CREAT | O_TRUNC, 0600)) == -1) {
+        snprintf (m->reason, sizeof (m->reason), "error file: %s", strerror (errno));
+        m->outcome = FAILED;
+        return;
+    }
+    fflush (NULL);
+    base = semaphoresInUse ();
+    t0 = now ();
+    if ((pid = fork ()) < 0) {
+        snprintf (m->reason, sizeof (m->reason), "fork: %s", strerror (errno));
+        m->outcome = FAILED;
+        close (fd);
+        return;
+    }
+    if (pid == 0) {
+        dup2 (fd, STDERR_FILENO);
+        close (fd);
+        child (c, n, dir);
+    }
+    close (fd);
+    setpgid (pid, pid);
+    m->outcome = PASSED;
+    while ((w = wait4 (pid, &status, WNOHANG, &ru)) == 0) {
+        t = now () - t0;
+        scan (pid, &procs, &rss);
+        if (procs > m->procs) {
+            m->procs = procs;
+            m->startup = t;
+        }
+        if (rss > m->rss)
+            m->rss = rss;
+        if ((sems = semaphoresInUse () - base) > m->sems)
+            m->sems = sems;
+        if (t > timeout) {
+            kill (-pid, SIGKILL);
+            w = wait4 (pid, &status, 0, &ru);
+            m->outcome = TIMEOUT;
+            snprintf (m->reason, sizeof (m->reason), "still running after %u s", timeout);
+            break;
+        }
+        if ((c->log != NULL) && (stat (c->log, &st) == 0) && (st.st_size > maxLog)) {
+            kill (-pid, SIGKILL);
+            w = wait4 (pid, &status, 0, &ru);
+            m->outcome = FAILED;
+            snprintf (m->reason, sizeof (m->reason), "logging file beyond %.0f MiB", maxLog / 1048576);
+            break;
+        }
+        nanosleep (&nap, NULL);
+    }
+    m->wall = now () - t0;
+    if (w == -1) {
+        snprintf (m->reason, sizeof (m->reason), "wait: %s", strerror (errno));
+        m->outcome = FAILED;
+    }
+    else {
+        m->csw = (double) (ru.ru_nvcsw + ru.ru_nivcsw) / n;
+        if (ru.ru_maxrss > m->rss)                                  /* runs too short to be sampled: their peak */
+            m->rss = (double) ru.ru_maxrss;
+        if (m->outcome != PASSED)
+            ;
+        else if (WIFSIGNALED (status)) {
+            snprintf (m->reason, sizeof (m->reason), "killed by signal %d (%s)", WTERMSIG (status),
+                      strsignal (WTERMSIG (status)));
+            m->outcome = FAILED;
+        }
+        else if (WEXITSTATUS (status) != EXIT_SUCCESS) {
+            snprintf (m->reason, sizeof (m->reason), "exit status %d", WEXITSTATUS (status));
+            lastLine (err, m->reason, sizeof (m->reason));
+            m->outcome = FAILED;
+        }
+        else if ((c->engine == ENG_GENERATOR) && ((k = errorFiles (dir, m->reason, sizeof (m->reason))) > 0)) {
+            if (k > 1)
+                snprintf (m->reason + strlen (m->reason), sizeof (m->reason) - strlen (m->reason),
+                          " (and %u more error files)", k - 1);
+            m->outcome = FAILED;
+        }
+    }
+    if (m->outcome != PASSED)
+        release (c, dir, pid);
+    if ((c->log != NULL) && (stat (c->log, &st) == 0)) {
+        m->logBytes = (double) st.st_size / n;
+        unlink (c->log);
+    }
+    unlink (err);
+}
+
+static const char *outcomeName (unsigned int outcome)
+{
+    static const char *names[] = { "skipped", "ok", "failed", "timeout" };
+
+    return names[outcome];
+}
+
+/* kernel limits the sizes run into */
+static void limits (char *s, size_t size)
+{
+    struct rlimit rl;
+    struct seminfo info;
+    char procs[24] = "unlimited";
+
+    if ((getrlimit (RLIMIT_NPROC, &rl) == 0) && (rl.rlim_cur != RLIM_INFINITY))
+        snprintf (procs, sizeof (procs), "%llu", (unsigned long long) rl.rlim_cur);
+    if (semctl (0, 0, SEM_INFO, (struct seminfo *) &info) == -1)
+        memset (&info, 0, sizeof (info));
+    snprintf (s, size, "processes per user %s, SEMMSL %d, SEMMNS %d, SEMMNI %d", procs, info.semmsl, info.semmns,
+              info.semmni);
+}
+
+static void csvReport (FILE *fic, const char *lim)
+{
+    const MEASURE *m;
+    unsigned int c, s;
+    char *q;
+
+    fprintf (fic, "# airlift scaling suite: %s\n", lim);
+    fprintf (fic, "engine,backend,N,outcome,startup_s,wall_s,peak_rss_kib,processes,semaphores,"
+                  "csw_per_passenger,log_bytes_per_passenger,reason\n");
+    for (c = 0; c < NCASES; c++)
+        for (s = 0; selected[c] && (s < nSizes); s++) {
+            m = &res[c][s];
+            fprintf (fic, "%s,%s,%u,%s,%.6f,%.6f,%.0f,%.0f,%.0f,%.3f,%.1f,\"", cases[c].name, cases[c].backend,
+                     sizes[s], outcomeName (m->outcome), m->startup, m->wall, m->rss, m->procs, m->sems, m->csw,
+                     m->logBytes);
+            for (q = (char *) m->reason; *q != '\0'; q++)
+                fprintf (fic, (*q == '"') ? "\"\"" : "%c", *q);
+            fprintf (fic, "\"\n");
+        }
+    for (c = 0; c < NCASES; c++)
+        for (s = 0; selected[c] && (s < nSizes); s++)
+            if ((res[c][s].outcome == FAILED) || (res[c][s].outcome == TIMEOUT)) {
+                fprintf (fic, "# first failure: %s %s at N=%u: %s\n", cases[c].name, cases[c].backend, sizes[s],
+                         res[c][s].reason);
+                break;
+            }
+}
+
+/* text with the HTML special characters escaped */
+static void html (FILE *fic, const char *s)
+{
+    for (; *s != '\0'; s++)
+        switch (*s) {
+            case '<': fputs ("&lt;", fic); break;
+            case '>': fputs ("&gt;", fic); break;
+            case '&': fputs ("&amp;", fic); break;
+            default: fputc (*s, fic);
+        }
+}
+
+/* log-log curves of a measure, one per engine and backend */
+static void plot (FILE *fic, unsigned int k)
+{
+    static const char *colors[] = { "#1f77b4", "#ff7f0e", "#2ca02c", "#d62728", "#9467bd", "#8c564b", "#e377c2",
+                                    "#7f7f7f" };
+    const double W = 640, H = 320, L = 70, R = 170, T = 30, B = 40;
+    double xlo = log10 (sizes[0]), xhi = log10 (sizes[nSizes - 1]), ylo = HUGE_VAL, yhi = -HUGE_VAL, v, x, y;
+    unsigned int c, s, nc = 0;
+    int e;
+
+    for (c = 0; c < NCASES; c++)
+        for (s = 0; selected[c] && (s < nSizes); s++)
+            if ((res[c][s].outcome == PASSED) && ((v = measureOf (&res[c][s], k)) > 0.0)) {
+                ylo = fmin (ylo, floor (log10 (v)));
+                yhi = fmax (yhi, ceil (log10 (v)));
+            }
+    if (ylo > yhi)
+        ylo = yhi = 0.0;
+    if (yhi == ylo)
+        yhi++;
+    if (xhi == xlo)
+        xhi++;
+#define   PX(lx)        (L + ((lx) - xlo) / (xhi - xlo) * (W - L - R))
+#define   PY(ly)        (H - B - ((ly) - ylo) / (yhi - ylo) * (H - T - B))
+    fprintf (fic, "<svg width=\"%.0f\" height=\"%.0f\" font-family=\"sans-serif\" font-size=\"11\">\n", W, H);
+    fprintf (fic, "<text x=\"%.0f\" y=\"18\" font-size=\"13\">", L);
+    html (fic, measureNames[k]);
+    fprintf (fic, "</text>\n<rect x=\"%.0f\" y=\"%.0f\" width=\"%.0f\" height=\"%.0f\" fill=\"none\" "
+                  "stroke=\"#999\"/>\n", L, T, W - L - R, H - T - B);
+    for (e = (int) ylo; e <= (int) yhi; e++)
+        fprintf (fic, "<line x1=\"%.0f\" x2=\"%.0f\" y1=\"%.1f\" y2=\"%.1f\" stroke=\"#eee\"/>"
+                      "<text x=\"%.0f\" y=\"%.1f\" text-anchor=\"end\">1e%d</text>\n", L, W - R, PY (e), PY (e),
+                 L - 4, PY (e) + 4, e);
+    for (s = 0; s < nSizes; s++)
+        fprintf (fic, "<text x=\"%.1f\" y=\"%.0f\" text-anchor=\"middle\">%u</text>\n", PX (log10 (sizes[s])),
+                 H - B + 14, sizes[s]);
+    fprintf (fic, "<text x=\"%.0f\" y=\"%.0f\" text-anchor=\"middle\">passengers (N)</text>\n", L + (W - L - R) / 2,
+             H - 6);
+    for (c = 0; c < NCASES; c++) {
+        if (!selected[c])
+            continue;
+        fprintf (fic, "<polyline fill=\"none\" stroke-width=\"2\" stroke=\"%s\" points=\"", colors[nc % 8]);
+        for (s = 0; s < nSizes; s++)
+            if ((res[c][s].outcome == PASSED) && ((v = measureOf (&res[c][s], k)) > 0.0))
+                fprintf (fic, " %.1f,%.1f", PX (log10 (sizes[s])), PY (log10 (v)));
+        fprintf (fic, "\"/>\n");
+        for (s = 0; s < nSizes; s++)
+            if ((res[c][s].outcome == FAILED) || (res[c][s].outcome == TIMEOUT)) {        /* first failure */
+                x = PX (log10 (sizes[s]));
+                y = T + 8 + 10 * nc;
+                fprintf (fic, "<text x=\"%.1f\" y=\"%.1f\" fill=\"%s\" text-anchor=\"middle\">&#x2717;</text>\n", x,
+                         y, colors[nc % 8]);
+                break;
+            }
+        fprintf (fic, "<line x1=\"%.0f\" x2=\"%.0f\" y1=\"%.0f\" y2=\"%.0f\" stroke-width=\"2\" stroke=\"%s\"/>"
+                      "<text x=\"%.0f\" y=\"%.0f\">%s %s</text>\n", W - R + 10, W - R + 30, T + 6 + 16 * nc,
+                 T + 6 + 16 * nc, colors[nc % 8], W - R + 34, T + 10 + 16 * nc, cases[c].name, cases[c].backend);
+        nc++;
+    }
+#undef PX
+#undef PY
+    fprintf (fic, "</svg>\n");
+}
+
+static void htmlReport (FILE *fic, const char *lim)
+{
+    const MEASURE *m;
+    unsigned int c, s, k;
+    bool any = false;
+
+    fprintf (fic, "<!DOCTYPE html>\n<html><head><meta charset=\"utf-8\"><title>airlift scaling suite</title>\n"
+                  "<style>body { font-family: sans-serif; } td, th { padding: 2px 8px; text-align: right; } "
+                  "td.l { text-align: left; } .failed { color: #d62728; }</style></head><body>\n"
+                  "<h1>airlift scaling suite</h1>\n<p>Kernel limits: ");
+    html (fic, lim);
+    fprintf (fic, ".</p>\n<h2>First failures</h2>\n<table>\n");
+    for (c = 0; c < NCASES; c++)
+        for (s = 0; selected[c] && (s < nSizes); s++)
+            if ((res[c][s].outcome == FAILED) || (res[c][s].outcome == TIMEOUT)) {
+                fprintf (fic, "<tr><td class=\"l\">%s %s</td><td>N=%u</td><td class=\"l failed\">", cases[c].name,
+                         cases[c].backend, sizes[s]);
+                html (fic, res[c][s].reason);
+                fprintf (fic, "</td></tr>\n");
+                any = true;
+                break;
+            }
+    if (!any)
+        fprintf (fic, "<tr><td class=\"l\">every engine and backend ran at every size</td></tr>\n");
+    fprintf (fic, "</table>\n<h2>Curves</h2>\n<p>Log-log scales; a cross marks the first failure.</p>\n");
+    for (k = 0; k < NMEASURES; k++)
+        plot (fic, k);
+    fprintf (fic, "<h2>Measures</h2>\n<table>\n<tr><th>engine</th><th>backend</th><th>N</th><th>outcome</th>");
+    for (k = 0; k < NMEASURES; k++) {
+        fprintf (fic, "<th>");
+        html (fic, measureNames[k]);
+        fprintf (fic, "</th>");
+    }
+    fprintf (fic, "</tr>\n");
+    for (c = 0; c < NCASES; c++)
+        for (s = 0; selected[c] && (s < nSizes); s++) {
+            m = &res[c][s];
+            fprintf (fic, "<tr><td class=\"l\">%s</td><td class=\"l\">%s</td><td>%u</td><td class=\"l%s\">%s</td>",
+                     cases[c].name, cases[c].backend, sizes[s], (m->outcome >= FAILED) ? " failed" : "",
+                     outcomeName (m->outcome));
+            for (k = 0; k < NMEASURES; k++)
+                fprintf (fic, "<td>%.6g</td>", measureOf (m, k));
+            fprintf (fic, "</tr>\n");
+        }
+    fprintf (fic, "</table>\n</body></html>\n");
+}
+
+/**
+ *  \brief Main program.
+ */
+
+int main (int argc, char *argv[])
+{
+    char defSizes[] = "10,100,1000,10000,100000", lim[160], *sizeList = defSizes, *engList = NULL, *w, *b;
+    const char *csv = NULL, *htmlName = NULL;
+    unsigned int timeout = 600, c, s, k, v;
+    double maxLog = 1024.0 * 1048576;
+    FILE *fic;
+    int opt;
+
+    while ((opt = getopt (argc, argv, "s:e:t:l:o:H:")) != -1) {
+        switch (opt) {
+            case 's': sizeList = optarg; break;
+            case 'e': engList = optarg; break;
+            case 't': timeout = (unsigned int) atoi (optarg); break;
+            case 'l': maxLog = atof (optarg) * 1048576; break;
+            case 'o': csv = optarg; break;
+            case 'H': htmlName = optarg; break;
+            default:
+                fprintf (stderr, "USAGE: %s [-s sizes] [-e engine[:backend],...] [-t seconds] [-l MiB] [-o csv] "
+                                 "[-H html]\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    for (w = strtok (sizeList, ", "); w != NULL; w = strtok (NULL, ", ")) {
+        if (((v = (unsigned int) atoi (w)) == 0) || (nSizes == MAXSIZES)) {
+            fprintf (stderr, "%s: wrong size or more than %d sizes (\"%s\")\n", argv[0], MAXSIZES, w);
+            return EXIT_FAILURE;
+        }
+        for (k = nSizes++; (k > 0) && (sizes[k - 1] > v); k--)                                 /* kept ascending */
+            sizes[k] = sizes[k - 1];
+        sizes[k] = v;
+    }
+    for (c = 0; c < NCASES; c++)
+        selected[c] = (engList == NULL);
+    for (w = (engList == NULL) ? NULL : strtok (engList, ","); w != NULL; w = strtok (NULL, ",")) {
+        if ((b = strchr (w, ':')) != NULL)
+            *b++ = '\0';
+        for (k = 0, c = 0; c < NCASES; c++)
+            if ((strcmp (w, cases[c].name) == 0) && ((b == NULL) || (strcmp (b, cases[c].backend) == 0))) {
+                selected[c] = true;
+                k++;
+            }
+        if (k == 0) {
+            fprintf (stderr, "%s: unknown engine or backend (\"%s\")\n", argv[0], w);
+            return EXIT_FAILURE;
+        }
+    }
+    if ((nSizes == 0) || (timeout == 0)) {
+        fprintf (stderr, "%s: at least one size and a time limit are required\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    for (c = 0; c < NCASES; c++)
+        for (s = 0; selected[c] && (s < nSizes); s++) {
+            if ((s > 0) && (res[c][s - 1].outcome != PASSED)) {
+                res[c][s].outcome = SKIPPED;
+                continue;
+            }
+            measure (&cases[c], sizes[s], timeout, maxLog, &res[c][s]);
+            fprintf (stderr, "%-9s %-7s N=%-6u %-7s %9.3f s  %s\n", cases[c].name, cases[c].backend, sizes[s],
+                     outcomeName (res[c][s].outcome), res[c][s].wall, res[c][s].reason);
+        }
+
+    limits (lim, sizeof (lim));
+    if ((fic = (csv == NULL) ? stdout : fopen (csv, "w")) == NULL) {
+        perror ("error on opening the CSV report");
+        return EXIT_FAILURE;
+    }
+    csvReport (fic, lim);
+    if ((fic != stdout) ? (fclose (fic) == EOF) : (fflush (fic) == EOF)) {
+        perror ("error on writing the CSV report");
+        return EXIT_FAILURE;
+    }
+    if (htmlName != NULL) {
+        if ((fic = fopen (htmlName, "w")) == NULL) {
+            perror ("error on opening the HTML report");
+            return EXIT_FAILURE;
+        }
+        htmlReport (fic, lim);
+        if (fclose (fic) == EOF) {
+            perror ("error on writing the HTML report");
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,191 @@
+/**
+ *  \file airliftSpecial.c (implementation file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  Embeddable simulation library (libairlift).
+ *
+ *  Problem size specialized code paths.
+ *
+ *  The number of passengers and the flight capacities are run-time parameters of the library, which leaves the
+ *  state line formatting and the hostess capacity rule with variable bounds. For each problem size listed in
+ *  <tt>airliftSizes.h</tt> (generated by the build from the <tt>SIZES</tt> make variable, as
+ *  <tt>AIRLIFT_SIZE (n, minfc, maxfc)</tt> entries), a copy of those paths is compiled with constant bounds:
+ *  the passengers loop is fully unrolled and the capacity rule constant folded.
+ *  A generic path covers every other size. The path is selected once, when the simulation is created.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "airlift.h"
+#include "airliftInternal.h"
+
+/**
+ *  \brief Writing an unsigned value right aligned in a field of a given width (printf "%*u").
+ */
+
+static inline char *putUns (char *p, unsigned int v, unsigned int width)
+{
+    char d[10];
+    unsigned int k = 0;
+
+    do {
+        d[k++] = (char) ('0' + v % 10);
+        v /= 10;
+    } while (v != 0);
+    while (width-- > k)
+        *p++ = ' ';
+    while (k > 0)
+        *p++ = d[--k];
+
+    return p;
+}
+
+/**
+ *  \brief Writing a passenger state field ("%4u"); states are single digit, which takes a single store.
+ */
+
+static inline char *putStat (char *p, unsigned int v)
+{
+    if (v > 9)
+        return putUns (p, v, 4);
+    p[0] = p[1] = p[2] = ' ';
+    p[3] = (char) ('0' + v);
+
+    return p + 4;
+}
+
+/** \brief pilot and hostess fields of a state line ("%3u%3u ") */
+static inline char *putHead (char *p, const AIRLIFT_STATE *st)
+{
+    p = putUns (p, st->pilotStat, 3);
+    p = putUns (p, st->hostessStat, 3);
+    *p++ = ' ';
+
+    return p;
+}
+
+/** \brief counters of a state line (" %4u%4u%4u\n") */
+static inline char *putTail (char *p, const AIRLIFT_STATE *st)
+{
+    *p++ = ' ';
+    p = putUns (p, st->nPassInQueue, 4);
+    p = putUns (p, st->nPassInFlight, 4);
+    p = putUns (p, st->totalPassBoarded, 4);
+    *p++ = '\n';
+
+    return p;
+}
+
+/**
+ *  \brief Hostess capacity rule: true if the passenger just checked is the last one of the flight.
+ */
+
+static inline bool lastPassenger (const AIRLIFT_STATE *st, unsigned int n, unsigned int minfc, unsigned int maxfc)
+{
+    return (st->nPassInFlight == maxfc) || ((minfc <= st->nPassInFlight) && (st->nPassInQueue == 0)) ||
+           (st->totalPassBoarded == n);
+}
+
+/** \brief size of the longest state line for <tt>n</tt> passengers */
+#define  STATE_LINE(n)    (2 * 10 + 1 + (n) * 10 + 1 + 3 * 10 + 2)
+
+/* generic path */
+
+static void logStateGeneric (AIRLIFT_SIM *sim, const AIRLIFT_STATE *st)
+{
+    char *p = putHead (sim->line, st);
+    unsigned int i;
+
+    for (i = 0; i < sim->cfg.nPassengers; i++)
+        p = putStat (p, st->passengerStat[i]);
+    p = putTail (p, st);
+    fwrite (sim->line, 1, (size_t) (p - sim->line), sim->log);
+}
+
+static bool isLastGeneric (const AIRLIFT_SIM *sim, const AIRLIFT_STATE *st)
+{
+    return lastPassenger (st, sim->cfg.nPassengers, sim->cfg.minFC, sim->cfg.maxFC);
+}
+
+/* specialized paths */
+
+#define AIRLIFT_SIZE(n, minfc, maxfc)                                                                               \
+    static void logState_##n##_##minfc##_##maxfc (AIRLIFT_SIM *sim, const AIRLIFT_STATE *st)                       \
+    {                                                                                                               \
+        char buf[STATE_LINE (n)];                                                                                   \
+        char *p = putHead (buf, st);                                                                                \
+        unsigned int i;                                                                                             \
+                                                                                                                    \
+        _Pragma ("GCC unroll 256")                                                                                  \
+        for (i = 0; i < (n); i++)                                                                                   \
+            p = putStat (p, st->passengerStat[i]);                                                                  \
+        p = putTail (p, st);                                                                                        \
+        fwrite (buf, 1, (size_t) (p - buf), sim->log);                                                              \
+    }                                                                                                               \
+                                                                                                                    \
+    static bool isLast_##n##_##minfc##_##maxfc (const AIRLIFT_SIM *sim, const AIRLIFT_STATE *st)                   \
+    {                                                                                                               \
+        return lastPassenger (st, (n), (minfc), (maxfc));                                                           \
+    }
+#include "airliftSizes.h"
+#undef AIRLIFT_SIZE
+
+/** \brief available paths, the generic one last */
+static const AIRLIFT_OPS ops[] =
+{
+#define AIRLIFT_SIZE(n, minfc, maxfc)                                                                               \
+    { (n), (minfc), (maxfc), logState_##n##_##minfc##_##maxfc, isLast_##n##_##minfc##_##maxfc },
+#include "airliftSizes.h"
+#undef AIRLIFT_SIZE
+    { 0, 0, 0, logStateGeneric, isLastGeneric }
+};
+
+/**
+ *  \brief Selection of the code paths for a configuration.
+ *
+ *  \param cfg pointer to the configuration
+ *
+ *  \return the specialized paths for the configuration size, if built, the generic ones otherwise
+ */
+
+const AIRLIFT_OPS *airliftSelectOps (const AIRLIFT_CONFIG *cfg)
+{
+    unsigned int k;
+
+    for (k = 0; k < sizeof (ops) / sizeof (ops[0]) - 1; k++)
+        if ((ops[k].nPassengers == cfg->nPassengers) && (ops[k].minFC == cfg->minFC) && (ops[k].maxFC == cfg->maxFC))
+            break;
+
+    return &ops[k];
+}
+
+/**
+ *  \brief Building the header line and the state line buffer of a simulation.
+ *
+ *  \param sim simulation handle
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when there is no memory
+ */
+
+int airliftBuildLines (AIRLIFT_SIM *sim)
+{
+    unsigned int n = sim->cfg.nPassengers;
+    unsigned int p;
+    char *s;
+
+    if (((sim->line = malloc (STATE_LINE (n))) == NULL) || ((sim->header = malloc (7 + n * 12 + 14)) == NULL))
+        return -1;
+    s = sim->header;
+    s += sprintf (s, "%3s%3s ", "PT", "HT");
+    for (p = 0; p < n; p++)
+        s += sprintf (s, " P%02u", p);
+    s += sprintf (s, " %4s%4s%4s\n", "InQ", "InF", "toB");
+    sim->headerLen = (size_t) (s - sim->header);
+
+    return 0;
+}
@@ -0,0 +1,332 @@
+/**
+ *  \file airliftStats.c (implementation file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  Cross-run statistical aggregator.
+ *
+ *  Reads the output of a batch of runs (as printed by <tt>run.sh</tt>, or any concatenation of logging files,
+ *  compressed or not) and summarizes the air lift results of every run:
+ *    \li flights used per run
+ *    \li passengers taken per flight
+ *    \li duration of the air lift (makespan) per run
+ *    \li time each passenger waited in queue.
+ *
+ *  For each of them the count, mean, standard deviation, extremes, percentiles and a histogram are reported.
+ *  The input is processed as a stream in constant memory: moments are accumulated on line and distributions are
+ *  kept in fixed log-linear histograms (percentiles are accurate to 1/16 of their order of magnitude), printed in
+ *  rows of equal width over which the count of each histogram bucket is spread.
+ *  A run is flagged as an outlier, as soon as it is read, when its flights, makespan or mean wait lie more than
+ *  <tt>z</tt> standard deviations away from the mean of the runs read before it.
+ *
+ *  Runs are numbered by the <tt>run.sh</tt> header preceding their summary, or else in order of their summaries. The
+ *  makespans and waits are only in the summaries of runs made with <tt>AIRLIFT_RESULT_TIMES</tt> set.
+ *
+ *  Usage: <tt>airliftStats [-z threshold] [-w warm-up runs] [file ...]</tt> (standard input if no file is given).
+ *  Rotated logging files are read by giving them oldest first.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <unistd.h>
+#include <math.h>
+#include <zlib.h>
+
+/** \brief values below this bound have a bucket of their own */
+#define  EXACT           64
+
+/** \brief sub-buckets per power of two above the exact range */
+#define  SUB             16
+
+/** \brief number of buckets of a histogram */
+#define  NBUCKETS        (EXACT + (64 - 6) * SUB)
+
+/** \brief rows of a printed histogram */
+#define  NROWS           12
+
+/** \brief length of the bars of a printed histogram */
+#define  BAR             40
+
+/**
+ *  \brief Definition of <em>metric accumulator</em> data type.
+ */
+typedef struct
+{ /** \brief metric name */
+    const char *name;
+    /** \brief unit of the metric */
+    const char *unit;
+    /** \brief number of samples */
+    unsigned long n;
+    /** \brief running mean */
+    double mean;
+    /** \brief running sum of squared deviations */
+    double m2;
+    /** \brief extremes */
+    unsigned long long min, max;
+    /** \brief log-linear histogram */
+    unsigned long bucket[NBUCKETS];
+
+} METRIC;
+
+/** \brief histogram bucket of a value */
+static unsigned int bucketOf (unsigned long long v)
+{
+    unsigned int k;
+
+    if (v < EXACT)
+        return (unsigned int) v;
+    k = 63 - (unsigned int) __builtin_clzll (v);                                            /* 6 .. 63 */
+    return EXACT + (k - 6) * SUB + ((v >> (k - 4)) & (SUB - 1));
+}
+
+/** \brief smallest value of a histogram bucket */
+static unsigned long long bucketLow (unsigned int b)
+{
+    unsigned int k;
+
+    if (b < EXACT)
+        return b;
+    k = (b - EXACT) / SUB + 6;
+    return (1ULL << k) | ((unsigned long long) ((b - EXACT) % SUB) << (k - 4));
+}
+
+static void addSample (METRIC *m, unsigned long long v)
+{
+    double d = (double) v - m->mean;
+
+    m->n++;
+    m->mean += d / m->n;
+    m->m2 += d * ((double) v - m->mean);
+    if ((m->n == 1) || (v < m->min))
+        m->min = v;
+    if ((m->n == 1) || (v > m->max))
+        m->max = v;
+    m->bucket[bucketOf (v)]++;
+}
+
+static double stdDev (const METRIC *m)
+{
+    return (m->n > 1) ? sqrt (m->m2 / (m->n - 1)) : 0.0;
+}
+
+static unsigned long long percentile (const METRIC *m, double q)
+{
+    unsigned long rank = (unsigned long) ceil (q * m->n), acc = 0;
+    unsigned int b;
+
+    for (b = 0; b < NBUCKETS; b++)
+        if ((acc += m->bucket[b]) >= rank)
+            break;
+    if (b == NBUCKETS)
+        return m->max;
+    return (bucketLow (b) < m->min) ? m->min : bucketLow (b);
+}
+
+static void printMetric (const METRIC *m)
+{
+    unsigned long row[NROWS] = { 0 }, top = 0;
+    unsigned long long width;
+    unsigned int nRows, b, r;
+
+    printf ("\n%s (%s)\n", m->name, m->unit);
+    if (m->n == 0) {
+        printf ("  no samples\n");
+        return;
+    }
+    printf ("  n %lu  mean %.2f  stddev %.2f  min %llu  max %llu\n", m->n, m->mean, stdDev (m), m->min, m->max);
+    printf ("  p50 %llu  p90 %llu  p99 %llu\n", percentile (m, 0.50), percentile (m, 0.90), percentile (m, 0.99));
+
+    /* histogram rows of equal width between the extremes, the count of each bucket spread over the rows its range
+       [low, high) covers (within the extremes), in proportion to the part of the range each one covers */
+
+    width = (m->max - m->min) / NROWS + 1;
+    nRows = (unsigned int) ((m->max - m->min) / width + 1);
+    for (b = 0; b < NBUCKETS; b++)
+        if (m->bucket[b] != 0) {
+            unsigned long long lo = bucketLow (b), hi = (b + 1 < NBUCKETS) ? bucketLow (b + 1) : m->max + 1, v, end;
+            unsigned long given = 0, share;
+
+            if (lo < m->min)
+                lo = m->min;
+            if (hi > m->max + 1)
+                hi = m->max + 1;
+            for (v = lo; v < hi; v = end) {
+                r = (unsigned int) ((v - m->min) / width);
+                end = (m->min + (r + 1) * width < hi) ? m->min + (r + 1) * width : hi;
+                share = (unsigned long) llround ((double) m->bucket[b] * (end - lo) / (hi - lo)) - given;
+                row[r] += share;
+                given += share;
+            }
+        }
+    for (r = 0; r < nRows; r++)
+        if (row[r] > top)
+            top = row[r];
+    for (r = 0; r < nRows; r++) {
+        unsigned int len = (unsigned int) ((row[r] * BAR + top - 1) / top);
+
+        printf ("  %10llu .. %-10llu %8lu |", m->min + r * width, m->min + (r + 1) * width - 1, row[r]);
+        while (len-- > 0)
+            putchar ('#');
+        putchar ('\n');
+    }
+}
+
+/**
+ *  \brief Definition of <em>per-run figures</em> data type.
+ */
+typedef struct
+{ /** \brief run number */
+    unsigned int run;
+    /** \brief run number given by a header, for the next summary */
+    bool numbered;
+    /** \brief a result block was read */
+    bool valid;
+    /** \brief flights used */
+    unsigned int flights;
+    /** \brief makespan */
+    unsigned long long makespan;
+    /** \brief sum and number of passenger waits */
+    double waitSum;
+    unsigned int nWaits;
+
+} RUN;
+
+/** \brief metrics over the runs */
+static METRIC flights = { "flights used per run", "flights" },
+              occupancy = { "passengers per flight", "passengers" },
+              makespan = { "makespan per run", "us" },
+              wait = { "passenger wait in queue", "us" },
+              meanWait = { "mean passenger wait per run", "us" };
+
+/** \brief outlier threshold (standard deviations) */
+static double zMax = 3.0;
+
+/** \brief runs read before outliers are flagged */
+static unsigned long warmUp = 30;
+
+/** \brief outliers found */
+static unsigned long nOutliers = 0;
+
+static void checkOutlier (const RUN *r, const METRIC *m, unsigned long long v)
+{
+    double sd = stdDev (m), z;
+
+    if ((m->n < warmUp) || (sd == 0.0))
+        return;
+    z = ((double) v - m->mean) / sd;
+    if (fabs (z) > zMax) {
+        printf ("outlier: run %u  %s %llu %s (z = %+.1f)\n", r->run, m->name, v, m->unit, z);
+        nOutliers++;
+    }
+}
+
+static void endRun (RUN *r)
+{
+    if (!r->valid)
+        return;
+    checkOutlier (r, &flights, r->flights);
+    addSample (&flights, r->flights);
+    if (r->makespan != 0) {                                                      /* summary with the times */
+        checkOutlier (r, &makespan, r->makespan);
+        addSample (&makespan, r->makespan);
+    }
+    if (r->nWaits > 0) {
+        unsigned long long mw = (unsigned long long) (r->waitSum / r->nWaits + 0.5);
+
+        checkOutlier (r, &meanWait, mw);
+        addSample (&meanWait, mw);
+    }
+    r->valid = false;
+}
+
+static void scan (gzFile fic, RUN *r)
+{
+    char line[512];
+    unsigned int a, b;
+    unsigned long long t;
+    char *s;
+
+    while (gzgets (fic, line, sizeof (line)) != NULL) {
+        if ((s = strstr (line, "Run n")) != NULL) {                                 /* run.sh header: Run n.º i */
+            endRun (r);
+            s += strcspn (s, "0123456789");
+            r->run = (unsigned int) atoi (s);
+            r->numbered = true;
+        }
+        else if (strncmp (line, "AirLift result", 14) == 0) {
+            endRun (r);
+            if (!r->numbered)
+                r->run++;
+            r->numbered = false;
+            if (r->valid == false) {
+                memset (&r->flights, 0, sizeof (RUN) - offsetof (RUN, flights));
+                r->valid = true;
+            }
+        }
+        else if (!r->valid)
+            continue;
+        else if (sscanf (line, "AirLift used %u Flights", &a) == 1)
+            r->flights = a;
+        else if (sscanf (line, "Flight %u took %u passengers", &a, &b) == 2)
+            addSample (&occupancy, b);
+        else if (sscanf (line, "AirLift took %llu us", &t) == 1)
+            r->makespan = t;
+        else if (sscanf (line, "Passenger %u waited %llu us", &a, &t) == 2) {
+            addSample (&wait, t);
+            r->waitSum += t;
+            r->nWaits++;
+        }
+    }
+}
+
+/**
+ *  \brief Main program.
+ */
+
+int main (int argc, char *argv[])
+{
+    RUN r;
+    gzFile fic;
+    int opt, i;
+
+    while ((opt = getopt (argc, argv, "z:w:")) != -1) {
+        switch (opt) {
+            case 'z': zMax = atof (optarg); break;
+            case 'w': warmUp = (unsigned long) atol (optarg); break;
+            default:
+                fprintf (stderr, "USAGE: %s [-z threshold] [-w warm-up runs] [file ...]\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+
+    memset (&r, 0, sizeof (RUN));
+    if (optind == argc) {
+        if ((fic = gzdopen (STDIN_FILENO, "r")) == NULL) {
+            perror ("stdin");
+            return EXIT_FAILURE;
+        }
+        scan (fic, &r);
+        gzclose (fic);
+    }
+    for (i = optind; i < argc; i++) {
+        if ((fic = gzopen (argv[i], "r")) == NULL) {
+            perror (argv[i]);
+            return EXIT_FAILURE;
+        }
+        scan (fic, &r);
+        gzclose (fic);
+    }
+    endRun (&r);
+
+    printf ("\nAirLift batch summary: %lu runs, %lu outliers (|z| > %.1f)\n", flights.n, nOutliers, zMax);
+    printMetric (&flights);
+    printMetric (&occupancy);
+    printMetric (&makespan);
+    printMetric (&wait);
+    printMetric (&meanWait);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,373 @@
+/**
+ *  \file airliftStress.c (implementation file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  Schedule perturbation stress harness.
+ *
+ *  Runs the air lift (the generator and the entities in the current directory, or in the one given) many times,
+ *  several at a time, each run with its own seed of schedule perturbation (<tt>AIRLIFT_PERTURB</tt>, see
+ *  perturb.h), and checks every run:
+ *    \li hangs: runs not over within the timeout are killed, with their entities, and their IPC objects removed
+ *    \li failures: a generator ending with an error or a logging file without summary
+ *    \li invariant violations in the logging file: states within range, passengers flying within the plane
+ *        capacity, passengers waiting and boarded within the number of passengers, boarded passengers never
+ *        decreasing, flights taking between the minimum (but the last one) and the maximum capacity and every
+ *        passenger taken.
+ *
+ *  Every anomaly is reported with its seed, and its logging file kept as <tt>stress-seed.log</tt>, so it can be
+ *  reproduced by <tt>AIRLIFT_PERTURB=seed:max ./probSemSharedMemAirLift</tt>; the distribution of the throughput
+ *  (passengers per second) of the runs and the seeds of the slowest ones are reported at the end.
+ *
+ *  Concurrent runs do not share their IPC objects: each one runs in a directory of its own, the access key being
+ *  derived from it.
+ *
+ *  Usage: <tt>airliftStress [-n runs] [-j concurrent runs] [-s first seed] [-d max delay (us)] [-t timeout (s)]
+ *  [-b directory of the programs]</tt>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/stat.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <sys/sem.h>
+
+#include "probConst.h"
+
+/** \brief name of the generator */
+#define  GENERATOR       "probSemSharedMemAirLift"
+
+/** \brief number of slowest runs reported */
+#define  NSLOW           5
+
+/**
+ *  \brief Definition of <em>run slot</em> data type.
+ */
+typedef struct
+{ /** \brief process identifier of the generator (0 if the slot is free) */
+    pid_t pid;
+    /** \brief seed of the run */
+    unsigned long seed;
+    /** \brief start of the run (seconds) */
+    double start;
+    /** \brief working directory of the slot */
+    char dir[PATH_MAX];
+
+} SLOT;
+
+/**
+ *  \brief Definition of <em>run result</em> data type.
+ */
+typedef struct
+{ /** \brief seed of the run */
+    unsigned long seed;
+    /** \brief throughput (passengers per second) */
+    double throughput;
+
+} RESULT;
+
+static unsigned long maxDelay = 100;
+
+static double timeNow (void)
+{
+    struct timespec t;
+
+    clock_gettime (CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+/* the program linked into the directory of a slot */
+static bool link1 (const char *binDir, const char *dir, const char *prog)
+{
+    char from[PATH_MAX + 64], to[PATH_MAX + 64];
+
+    snprintf (from, sizeof (from), "%s/%s", binDir, prog);
+    snprintf (to, sizeof (to), "%s/%s", dir, prog);
+    return symlink (from, to) == 0;
+}
+
+static bool launch (SLOT *s, unsigned long seed)
+{
+    char spec[64];
+
+    snprintf (spec, sizeof (spec), "%lu:%lu", seed, maxDelay);
+    if ((s->pid = fork ()) == -1) {
+        s->pid = 0;
+        return false;
+    }
+    if (s->pid == 0) {
+        setpgid (0, 0);                                                      /* killed with its entities on a hang */
+        if (chdir (s->dir) == -1) {
+            perror (s->dir);
+            _exit (EXIT_FAILURE);
+        }
+        setenv ("AIRLIFT_PERTURB", spec, 1);
+        setenv ("AIRLIFT_RESULT_TIMES", "1", 1);                                 /* makespan in the summary */
+        freopen ("/dev/null", "w", stdout);
+        execl ("./" GENERATOR, GENERATOR, "log", NULL);
+        perror (GENERATOR);
+        _exit (EXIT_FAILURE);
+    }
+    setpgid (s->pid, s->pid);
+    s->seed = seed;
+    s->start = timeNow ();
+
+    return true;
+}
+
+/* every process of the run killed and its IPC objects removed */
+static void cleanUp (SLOT *s)
+{
+    key_t key;
+    int id;
+
+    kill (-s->pid, SIGKILL);
+    if ((key = ftok (s->dir, 'a')) == -1)
+        return;
+    if ((id = shmget (key, 0, 0)) != -1)
+        shmctl (id, IPC_RMID, NULL);
+    if ((id = semget (key, 0, 0)) != -1)
+        semctl (id, 0, IPC_RMID);
+}
+
+/* invariant violation of a logging file (NULL if none), throughput of the run */
+static const char *check (const char *nFic, double *throughput)
+{
+    static char why[128];
+    char line[1024], *p, *end;
+    long v[2 + N + 3];
+    unsigned int k, f, n, flights[MAXNF + 1], nFlights = 0, total = 0, boarded = 0;
+    unsigned long long makespan = 0;
+    FILE *fic;
+
+    if ((fic = fopen (nFic, "r")) == NULL)
+        return "no logging file";
+    why[0] = '\0';
+    while ((why[0] == '\0') && (fgets (line, sizeof (line), fic) != NULL)) {
+        for (k = 0, p = line; k < 2 + N + 3; k++, p = end)                                         /* state line */
+            if (v[k] = strtol (p, &end, 10), end == p)
+                break;
+        if (k == 2 + N + 3) {
+            for (k = 0; k < N; k++)
+                if ((v[2 + k] < GOING_TO_AIRPORT) || (v[2 + k] > AT_DESTINATION))
+                    break;
+            if ((v[0] < FLYING_BACK) || (v[0] > DROPING_PASSENGERS) || (v[1] < WAIT_FOR_FLIGHT) ||
+                (v[1] > READY_TO_FLIGHT) || (k < N))
+                snprintf (why, sizeof (why), "state out of range");
+            else if (v[2 + N + 1] > MAXFC)
+                snprintf (why, sizeof (why), "%ld passengers flying", v[2 + N + 1]);
+            else if ((v[2 + N] < 0) || (v[2 + N] + v[2 + N + 2] > N))
+                snprintf (why, sizeof (why), "%ld waiting with %ld boarded", v[2 + N], v[2 + N + 2]);
+            else if (v[2 + N + 2] < boarded)
+                snprintf (why, sizeof (why), "boarded passengers decreased to %ld", v[2 + N + 2]);
+            else boarded = (unsigned int) v[2 + N + 2];
+        }
+        else if (sscanf (line, "Flight %u took %u passengers", &f, &n) == 2) {
+            if (nFlights == MAXNF)
+                snprintf (why, sizeof (why), "more than %d flights", MAXNF);
+            else flights[nFlights++] = n;
+            total += n;
+        }
+        else sscanf (line, "AirLift took %llu us", &makespan);
+    }
+    fclose (fic);
+    if (why[0] != '\0')
+        return why;
+    if (makespan == 0)
+        return "no summary";
+    for (f = 0; f < nFlights; f++)
+        if ((flights[f] > MAXFC) || ((flights[f] < MINFC) && (f + 1 < nFlights))) {
+            snprintf (why, sizeof (why), "flight %u took %u passengers", f + 1, flights[f]);
+            return why;
+        }
+    if (total != N) {
+        snprintf (why, sizeof (why), "%u passengers taken", total);
+        return why;
+    }
+    *throughput = 1e6 * N / makespan;
+
+    return NULL;
+}
+
+/* a run over (normally or killed): checked and reported when anomalous */
+static bool finish (SLOT *s, int status, bool hung, RESULT *res, unsigned int *nRes)
+{
+    char nFic[PATH_MAX + 8], keep[64];
+    const char *why = NULL;
+    char buf[64];
+    double throughput = 0.0;
+
+    snprintf (nFic, sizeof (nFic), "%s/log", s->dir);
+    if (hung)
+        why = "hang";
+    else if (!WIFEXITED (status) || (WEXITSTATUS (status) != EXIT_SUCCESS)) {
+        if (WIFSIGNALED (status))
+            snprintf (buf, sizeof (buf), "generator killed by signal %d", WTERMSIG (status));
+        else snprintf (buf, sizeof (buf), "generator exited with status %d", WEXITSTATUS (status));
+        why = buf;
+    }
+    else why = check (nFic, &throughput);
+    if (hung || (why != NULL))
+        cleanUp (s);
+    else kill (-s->pid, SIGKILL);                                                  /* nothing should be left */
+
+    if (why != NULL) {
+        snprintf (keep, sizeof (keep), "stress-%lu.log", s->seed);
+        rename (nFic, keep);
+        printf ("seed %lu: %s (logging file %s; reproduce with AIRLIFT_PERTURB=%lu:%lu ./%s)\n", s->seed, why, keep,
+                s->seed, maxDelay, GENERATOR);
+        fflush (stdout);
+    }
+    else {
+        res[*nRes].seed = s->seed;
+        res[(*nRes)++].throughput = throughput;
+        unlink (nFic);
+    }
+    s->pid = 0;
+
+    return why == NULL;
+}
+
+static int byThroughput (const void *a, const void *b)
+{
+    double ta = ((const RESULT *) a)->throughput, tb = ((const RESULT *) b)->throughput;
+
+    return (ta > tb) - (ta < tb);
+}
+
+static void report (RESULT *res, unsigned int nRes, unsigned int nRuns)
+{
+    static const double pct[] = { 0.0, 1.0, 10.0, 50.0, 90.0, 99.0, 100.0 };
+    double mean = 0.0;
+    unsigned int k;
+
+    printf ("%u runs, %u anomalous\n", nRuns, nRuns - nRes);
+    if (nRes == 0)
+        return;
+    qsort (res, nRes, sizeof (RESULT), byThroughput);
+    for (k = 0; k < nRes; k++)
+        mean += res[k].throughput / nRes;
+    printf ("throughput (passengers/s): mean %.1f", mean);
+    for (k = 0; k < sizeof (pct) / sizeof (pct[0]); k++)
+        printf ("  p%g %.1f", pct[k], res[(unsigned int) (pct[k] / 100.0 * (nRes - 1) + 0.5)].throughput);
+    printf ("\nslowest runs:");
+    for (k = 0; (k < NSLOW) && (k < nRes); k++)
+        printf (" seed %lu (%.1f)", res[k].seed, res[k].throughput);
+    printf ("\n");
+}
+
+/**
+ *  \brief Main program.
+ */
+
+int main (int argc, char *argv[])
+{
+    char base[] = "/tmp/airliftStressXXXXXX", binDir[PATH_MAX];
+    const char *progDir = ".";
+    unsigned long seed = 1;
+    unsigned int nRuns = 1000, nJobs = (unsigned int) sysconf (_SC_NPROCESSORS_ONLN), started = 0, nRes = 0, j;
+    double timeout = 10.0;
+    SLOT *slot;
+    RESULT *res;
+    int opt, status;
+    pid_t pid;
+
+    while ((opt = getopt (argc, argv, "n:j:s:d:t:b:")) != -1) {
+        switch (opt) {
+            case 'n': nRuns = (unsigned int) atoi (optarg); break;
+            case 'j': nJobs = (unsigned int) atoi (optarg); break;
+            case 's': seed = strtoul (optarg, NULL, 10); break;
+            case 'd': maxDelay = strtoul (optarg, NULL, 10); break;
+            case 't': timeout = atof (optarg); break;
+            case 'b': progDir = optarg; break;
+            default:
+                fprintf (stderr, "USAGE: %s [-n runs] [-j concurrent runs] [-s first seed] [-d max delay (us)] "
+                                 "[-t timeout (s)] [-b directory of the programs]\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    if (nJobs == 0)
+        nJobs = 1;
+    if ((realpath (progDir, binDir) == NULL) || (mkdtemp (base) == NULL)) {
+        perror ("error on the working directories");
+        return EXIT_FAILURE;
+    }
+    if (((slot = calloc (nJobs, sizeof (SLOT))) == NULL) || ((res = calloc (nRuns + 1, sizeof (RESULT))) == NULL)) {
+        perror ("error on allocating the runs");
+        return EXIT_FAILURE;
+    }
+    for (j = 0; j < nJobs; j++) {
+        snprintf (slot[j].dir, sizeof (slot[j].dir), "%s/%u", base, j);
+        if ((mkdir (slot[j].dir, 0700) == -1) || !link1 (binDir, slot[j].dir, GENERATOR) ||
+            !link1 (binDir, slot[j].dir, "pilot") || !link1 (binDir, slot[j].dir, "hostess") ||
+            !link1 (binDir, slot[j].dir, "passenger") || !link1 (binDir, slot[j].dir, "controller")) {
+            perror ("error on the working directories");
+            return EXIT_FAILURE;
+        }
+    }
+
+    /* runs: slots refilled as runs finish, hung ones killed */
+
+    while (true) {
+        bool busy = false;
+
+        for (j = 0; j < nJobs; j++) {
+            if ((slot[j].pid == 0) && (started < nRuns)) {
+                if (!launch (&slot[j], seed + started)) {
+                    perror ("error on the fork operation for a run");
+                    return EXIT_FAILURE;
+                }
+                started++;
+            }
+            busy |= (slot[j].pid != 0);
+        }
+        if (!busy)
+            break;
+        if ((pid = waitpid (-1, &status, WNOHANG)) > 0) {
+            for (j = 0; j < nJobs; j++)
+                if (slot[j].pid == pid)
+                    finish (&slot[j], status, false, res, &nRes);
+            continue;
+        }
+        for (j = 0; j < nJobs; j++)
+            if ((slot[j].pid != 0) && (timeNow () - slot[j].start > timeout)) {
+                pid = slot[j].pid;
+                cleanUp (&slot[j]);
+                waitpid (pid, &status, 0);
+                finish (&slot[j], status, true, res, &nRes);
+            }
+        usleep (1000);
+    }
+
+    for (j = 0; j < nJobs; j++) {
+        char path[PATH_MAX + 32];
+        const char *prog[] = { GENERATOR, "pilot", "hostess", "passenger", "controller" };
+        unsigned int k;
+
+        for (k = 0; k < 5; k++) {
+            snprintf (path, sizeof (path), "%s/%s", slot[j].dir, prog[k]);
+            unlink (path);
+        }
+        for (k = 0; k < N + 3; k++) {                                                     /* error files of entities */
+            if (k < 3)
+                snprintf (path, sizeof (path), "%s/error_%s", slot[j].dir, (k == 0) ? "PT" : (k == 1) ? "HT" : "CT");
+            else snprintf (path, sizeof (path), "%s/error_PG%02u", slot[j].dir, k - 3);
+            unlink (path);
+        }
+        rmdir (slot[j].dir);
+    }
+    rmdir (base);
+    report (res, nRes, nRuns);
+
+    return (nRes == nRuns) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,334 @@
+/**
+ *  \file airliftVector.c (implementation file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  Embeddable simulation library (libairlift).
+ *
+ *  Vectorized replication engine.
+ *
+ *  With every wait but the travel and flight times taking no simulated time, a run of the discrete event engine
+ *  reduces to a recurrence over the passengers in order of arrival: the hostess checks the <tt>i</tt>-th of them at
+ *  the later of its arrival and the start of the boarding, and the flight departs after it when it is full, when
+ *  it holds at least the minimum and the next passenger did not arrive yet, or when it was the last passenger.
+ *  The random numbers are drawn in the order the event engine draws them (the travel times of all the passengers,
+ *  then the flight times as the pilot flies), so a replication gives the results of the event engine run with the
+ *  same seed. Passengers travelling in groups are left to the event engine.
+ *
+ *  <tt>LANES</tt> replications are run at once, one per lane of GCC vector types, their state kept as a structure
+ *  of arrays: every replication checks exactly one passenger per step, so the lanes never diverge, a flight
+ *  departing in some of them only being a masked update (the random generators of the other lanes do not advance).
+ *  The passengers are put in order of arrival by sorting them on their arrival time and id, a lane per replication,
+ *  then gathered back into vectors. Batches of replications are shared among threads, and the results delivered
+ *  in order of replication by the calling thread.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+
+#include "probConst.h"
+#include "airlift.h"
+#include "airliftInternal.h"
+
+/* the vector results of the functions below only cross static functions, so their ABI does not matter */
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+/** \brief replications run at once by a thread */
+#define  LANES           8
+
+/** \brief results buffered per thread between two deliveries (bytes) */
+#define  CHUNK_BYTES     (1 << 22)
+
+/** \brief vector of times (microseconds) */
+typedef double VD __attribute__ ((vector_size (LANES * sizeof (double))));
+
+/** \brief vector of counters and masks (all bits set when true) */
+typedef long long VI __attribute__ ((vector_size (LANES * sizeof (long long))));
+
+/** \brief vector of random generator states */
+typedef unsigned long long VU __attribute__ ((vector_size (LANES * sizeof (unsigned long long))));
+
+/**
+ *  \brief Definition of <em>batch of results</em> data type.
+ *
+ *  Results of consecutive replications, each with room for a flight per passenger.
+ */
+typedef struct
+{ /** \brief number of flights of each replication */
+    unsigned int *nFlights;
+    /** \brief passengers at each flight of each replication */
+    unsigned int *flights;
+    /** \brief makespan of each replication */
+    double *makespan;
+    /** \brief time spent boarding in each replication */
+    double *boarding;
+    /** \brief time each passenger of each replication waited in queue */
+    double *wait;
+
+} RESULTS;
+
+/**
+ *  \brief Definition of <em>arrival</em> data type.
+ */
+typedef struct
+{ /** \brief arrival time */
+    double time;
+    /** \brief passenger id */
+    unsigned int id;
+
+} ARRIVAL;
+
+/**
+ *  \brief Definition of <em>worker</em> data type.
+ */
+typedef struct
+{ /** \brief configuration */
+    const AIRLIFT_CONFIG *cfg;
+    /** \brief first replication of the chunk */
+    unsigned long first;
+    /** \brief replications of the chunk */
+    unsigned long nRuns;
+    /** \brief batches taken by the worker: its index, then every <tt>nThreads</tt> */
+    unsigned int index, nThreads;
+    /** \brief results of the chunk */
+    RESULTS *res;
+    /** \brief arrival times of the passengers, then in order of arrival (<tt>nPassengers</tt> vectors each) */
+    VD *arrival, *sorted;
+    /** \brief passengers in order of arrival (<tt>nPassengers</tt> per lane) */
+    unsigned int *order;
+    /** \brief arrivals of a lane being sorted (<tt>nPassengers</tt>) */
+    ARRIVAL *key;
+
+} WORKER;
+
+/** \brief a vector with every lane set to a value */
+#define  SPLAT(T, v)     ((T) {} + (v))
+
+/** \brief lanes of <tt>x</tt> where the mask <tt>m</tt> is set, of <tt>y</tt> elsewhere */
+#define  BLEND(m, x, y)  ((VD) (((VI) (x) & (m)) | ((VI) (y) & ~(m))))
+
+/**
+ *  \brief Uniformly distributed random numbers in [0, 1] (splitmix64), the lanes outside the mask keeping their
+ *  state.
+ */
+
+static inline VD uniform (VU *rnd, const VI *m)
+{
+    VU z = (*rnd += SPLAT (VU, 0x9e3779b97f4a7c15ULL) & (VU) *m);
+
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    z ^= z >> 31;
+    return __builtin_convertvector (z >> 11, VD) / (double) ((1ULL << 53) - 1);
+}
+
+/** \brief <tt>floor (scale * u + offset)</tt> for the non negative values the times take */
+static inline VD draw (VU *rnd, const VI *m, double scale, double offset)
+{
+    return __builtin_convertvector (__builtin_convertvector (scale * uniform (rnd, m) + offset, VI), VD);
+}
+
+/* order of arrival, ties in order of id */
+static int byArrival (const void *a, const void *b)
+{
+    const ARRIVAL *x = a, *y = b;
+
+    if (x->time != y->time)
+        return (x->time < y->time) ? -1 : 1;
+    return (x->id < y->id) ? -1 : (x->id > y->id);
+}
+
+/**
+ *  \brief Running a batch of <tt>LANES</tt> replications.
+ *
+ *  \param w worker
+ *  \param b batch within the chunk
+ */
+
+static void batch (WORKER *w, unsigned long b)
+{
+    const AIRLIFT_CONFIG *cfg = w->cfg;
+    unsigned int n = cfg->nPassengers, i, p, l;
+    unsigned long r0 = b * LANES;
+    VU rnd;
+    VI all = SPLAT (VI, -1), none = SPLAT (VI, 0), inFlight = none, nFlights = none, last;
+    VD board, check, wait, makespan = SPLAT (VD, 0.0), boarding = SPLAT (VD, 0.0);
+    RESULTS *res = w->res;
+
+    for (l = 0; l < LANES; l++)
+        rnd[l] = cfg->seed + w->first + r0 + l;
+
+    /* travel times, then the passengers in order of arrival (ties in order of id, as their wake ups) */
+
+    for (p = 0; p < n; p++)
+        w->arrival[p] = draw (&rnd, &all, cfg->maxTravel, 1000.0);
+    for (l = 0; l < LANES; l++) {
+        for (p = 0; p < n; p++) {
+            w->key[p].time = w->arrival[p][l];
+            w->key[p].id = p;
+        }
+        qsort (w->key, n, sizeof (ARRIVAL), byArrival);
+        for (i = 0; i < n; i++) {
+            w->sorted[i][l] = w->key[i].time;
+            w->order[l * n + i] = w->key[i].id;
+        }
+    }
+
+    /* boarding, a passenger per step; a flight departs in the lanes where it was the last one */
+
+    board = draw (&rnd, &all, cfg->maxFlight, 100.0);
+    for (i = 0; i < n; i++) {
+        check = BLEND (w->sorted[i] > board, w->sorted[i], board);
+        wait = check - w->sorted[i];
+        for (l = 0; l < LANES; l++)
+            if (r0 + l < w->nRuns)
+                res->wait[(r0 + l) * n + w->order[l * n + i]] = wait[l];
+        inFlight += 1;
+        last = (i == n - 1) ? all
+                            : (VI) ((inFlight == (long long) cfg->maxFC) |
+                                    ((inFlight >= (long long) cfg->minFC) & (w->sorted[i + 1] > check)));
+        if (!memcmp (&last, &none, sizeof (VI)))
+            continue;
+        for (l = 0; l < LANES; l++)
+            if (last[l] && (r0 + l < w->nRuns))
+                res->flights[(r0 + l) * n + (unsigned int) nFlights[l]] = (unsigned int) inFlight[l];
+        nFlights -= last;
+        boarding += BLEND (last, check - board, SPLAT (VD, 0.0));
+        makespan = BLEND (last, check + draw (&rnd, &last, cfg->maxFlight, 100.0), makespan);
+        if (i < n - 1)
+            board = BLEND (last, makespan + draw (&rnd, &last, cfg->maxFlight, 100.0), board);
+        inFlight &= ~last;
+    }
+
+    for (l = 0; (l < LANES) && (r0 + l < w->nRuns); l++) {
+        res->nFlights[r0 + l] = (unsigned int) nFlights[l];
+        res->makespan[r0 + l] = makespan[l];
+        res->boarding[r0 + l] = boarding[l];
+    }
+}
+
+static void *worker (void *arg)
+{
+    WORKER *w = arg;
+    unsigned long b;
+
+    for (b = w->index; b * LANES < w->nRuns; b += w->nThreads)
+        batch (w, b);
+
+    return NULL;
+}
+
+/**
+ *  \brief Running independent replications with the vectorized engine.
+ *
+ *  \param cfg pointer to the configuration (the logging, column and samples files are ignored)
+ *  \param nRuns number of replications
+ *  \param nThreads number of threads (at least one)
+ *  \param cb callback receiving the results of each replication, in order
+ *  \param ctx user context passed to the callback
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int airliftReplicate (const AIRLIFT_CONFIG *cfg, unsigned long nRuns, unsigned int nThreads,
+                      AIRLIFT_REPLICATION_CB cb, void *ctx)
+{
+    unsigned int n, t;
+    unsigned long chunk, first, r;
+    size_t perRun;
+    RESULTS res;
+    WORKER *w;
+    pthread_t *tid;
+    AIRLIFT_RESULT out;
+    int stat = 0, err;
+
+    if ((cfg == NULL) || (cb == NULL) || (nThreads == 0) || (cfg->nPassengers == 0) || (cfg->maxFC == 0) ||
+        (cfg->minFC > cfg->maxFC) || (cfg->maxTravel < 0.0) || (cfg->maxFlight < 0.0) || airliftGrouped (cfg)) {
+        errno = EINVAL;
+        return -1;
+    }
+    n = cfg->nPassengers;
+    perRun = sizeof (unsigned int) + n * sizeof (unsigned int) + 2 * sizeof (double) + n * sizeof (double);
+    chunk = (CHUNK_BYTES / perRun / LANES + 1) * LANES * nThreads;
+    memset (&res, 0, sizeof (RESULTS));
+    res.nFlights = malloc (chunk * sizeof (unsigned int));
+    res.flights = malloc (chunk * n * sizeof (unsigned int));
+    res.makespan = malloc (chunk * sizeof (double));
+    res.boarding = malloc (chunk * sizeof (double));
+    res.wait = malloc (chunk * n * sizeof (double));
+    w = calloc (nThreads, sizeof (WORKER));
+    tid = malloc (nThreads * sizeof (pthread_t));
+    if ((res.nFlights == NULL) || (res.flights == NULL) || (res.makespan == NULL) || (res.boarding == NULL) ||
+        (res.wait == NULL) || (w == NULL) || (tid == NULL)) {
+        errno = ENOMEM;
+        stat = -1;
+        goto out;
+    }
+    for (t = 0; t < nThreads; t++) {
+        w[t].cfg = cfg;
+        w[t].index = t;
+        w[t].nThreads = nThreads;
+        w[t].res = &res;
+        if ((posix_memalign ((void **) &w[t].arrival, sizeof (VD), 2 * n * sizeof (VD)) != 0) ||
+            ((w[t].order = malloc (LANES * n * sizeof (unsigned int))) == NULL) ||
+            ((w[t].key = malloc (n * sizeof (ARRIVAL))) == NULL)) {
+            errno = ENOMEM;
+            stat = -1;
+            goto out;
+        }
+        w[t].sorted = w[t].arrival + n;
+    }
+
+    for (first = 0; first < nRuns; first += chunk) {
+        for (t = 0; t < nThreads; t++) {
+            w[t].first = first;
+            w[t].nRuns = (nRuns - first < chunk) ? nRuns - first : chunk;
+        }
+        for (t = 1; t < nThreads; t++)
+            if ((err = pthread_create (&tid[t], NULL, worker, &w[t])) != 0) {
+                while (--t > 0)
+                    pthread_join (tid[t], NULL);
+                errno = err;
+                stat = -1;
+                goto out;
+            }
+        worker (&w[0]);
+        for (t = 1; t < nThreads; t++)
+            pthread_join (tid[t], NULL);
+
+        for (r = 0; r < w[0].nRuns; r++) {
+            out.nFlights = res.nFlights[r];
+            out.nPassengersInFlight = res.flights + r * n;
+            out.totalPassBoarded = n;
+            out.makespan = res.makespan[r];
+            out.nEvents = 0;
+            out.passengerWait = res.wait + r * n;
+            out.nGroups = n;
+            out.nSemOps = 0;
+            out.boardingTime = res.boarding[r];
+            cb (ctx, first + r, &out);
+        }
+    }
+
+out:
+    if (w != NULL)
+        for (t = 0; t < nThreads; t++) {
+            free (w[t].arrival);
+            free (w[t].order);
+            free (w[t].key);
+        }
+    free (w);
+    free (tid);
+    free (res.nFlights);
+    free (res.flights);
+    free (res.makespan);
+    free (res.boarding);
+    free (res.wait);
+
+    return stat;
+}
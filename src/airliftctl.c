@@ -0,0 +1,150 @@
+/**
+ *  \file airliftctl.c (implementation file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  Control of a run going.
+ *
+ *  Changes the settings of the control block of a run going (see control.h): the capacity rules, the flight and
+ *  travel times, the factor applied to both and the logging level. The settings changed are validated and written,
+ *  with the next version, inside the critical region; the intervening entities pick them up at their next decision
+ *  and the first one to do so writes them to the logging file. With no setting given, those in force are printed.
+ *  Soak runs may so step through several settings in a single run, instead of paying the startup once per setting.
+ *
+ *  The run is found by the access key of its IPC objects, derived from the directory it runs in (the current one by
+ *  default), as the generator does. The program must be built for the same number of passengers as the run (in
+ *  <tt>../run/N&lt;size&gt;</tt> by <tt>make sized</tt>): a shared memory region of another size is refused.
+ *
+ *  Usage: <tt>airliftctl [-d directory] [-k key] [-m minFC] [-M maxFC] [-f maxFlight (us)] [-t maxTravel (us)]
+ *  [-s timeScale] [-l full|events]</tt>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+
+#include "probConst.h"
+#include "probDataStruct.h"
+#include "sharedDataSync.h"
+#include "semaphore.h"
+#include "sharedMemory.h"
+#include "control.h"
+
+/* settings given, one bit per option */
+#define  MINFC_SET         0x01
+#define  MAXFC_SET         0x02
+#define  MAXFLIGHT_SET     0x04
+#define  MAXTRAVEL_SET     0x08
+#define  TIMESCALE_SET     0x10
+#define  LOGLEVEL_SET      0x20
+
+static void print (const CONTROL *c)
+{
+    printf ("Control %u : minFC %u maxFC %u maxFlight %.0f maxTravel %.0f timeScale %g log %s\n", c->version,
+            c->minFC, c->maxFC, c->maxFlight, c->maxTravel, c->timeScale, c->eventsOnly ? "events" : "full");
+}
+
+/**
+ *  \brief Main program.
+ */
+
+int main (int argc, char *argv[])
+{
+    char *dir = ".";
+    key_t key = -1;
+    int opt, shmid, semgid, valid = 0;
+    unsigned int given = 0;
+    struct shmid_ds ds;
+    SHARED_DATA *sh;
+    CONTROL c, req = { 0 };
+
+    while ((opt = getopt (argc, argv, "d:k:m:M:f:t:s:l:")) != -1) {
+        switch (opt) {
+            case 'd': dir = optarg; break;
+            case 'k': key = (key_t) strtol (optarg, NULL, 0); break;
+            case 'm': req.minFC = (unsigned int) atoi (optarg); given |= MINFC_SET; break;
+            case 'M': req.maxFC = (unsigned int) atoi (optarg); given |= MAXFC_SET; break;
+            case 'f': req.maxFlight = atof (optarg); given |= MAXFLIGHT_SET; break;
+            case 't': req.maxTravel = atof (optarg); given |= MAXTRAVEL_SET; break;
+            case 's': req.timeScale = atof (optarg); given |= TIMESCALE_SET; break;
+            case 'l':
+                if ((strcmp (optarg, "full") != 0) && (strcmp (optarg, "events") != 0)) {
+                    fprintf (stderr, "%s: the logging level is either full or events\n", argv[0]);
+                    return EXIT_FAILURE;
+                }
+                req.eventsOnly = (strcmp (optarg, "events") == 0);
+                given |= LOGLEVEL_SET;
+                break;
+            default:
+                fprintf (stderr, "USAGE: %s [-d directory] [-k key] [-m minFC] [-M maxFC] [-f maxFlight (us)] "
+                                 "[-t maxTravel (us)] [-s timeScale] [-l full|events]\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+
+    /* connecting to the run going */
+
+    if ((key == -1) && ((key = ftok (dir, 'a')) == -1)) {
+        perror ("error on generating the key");
+        return EXIT_FAILURE;
+    }
+    if ((shmid = shmemConnect (key)) == -1) {
+        perror ("error on connecting to the shared memory region (is a run going?)");
+        return EXIT_FAILURE;
+    }
+    if (shmctl (shmid, IPC_STAT, &ds) == -1) {
+        perror ("error on reading the size of the shared memory region");
+        return EXIT_FAILURE;
+    }
+    if (ds.shm_segsz != sizeof (SHARED_DATA)) {
+        fprintf (stderr, "%s: the run was built for another number of passengers (region of %zu bytes, %zu expected "
+                         "for N = %d), use the airliftctl of its size\n", argv[0], (size_t) ds.shm_segsz,
+                 sizeof (SHARED_DATA), N);
+        return EXIT_FAILURE;
+    }
+    if (shmemAttach (shmid, (void **) &sh) == -1) {
+        perror ("error on mapping the shared region on the process address space");
+        return EXIT_FAILURE;
+    }
+    if ((semgid = semConnect (key)) == -1) {
+        perror ("error on connecting to the semaphore set");
+        return EXIT_FAILURE;
+    }
+
+    /* settings changed inside the critical region, as a new version */
+
+    if (semDown (semgid, sh->mutex) == -1) {
+        perror ("error on the down operation for semaphore access");
+        return EXIT_FAILURE;
+    }
+    c = sh->control;
+    if (given & MINFC_SET) c.minFC = req.minFC;
+    if (given & MAXFC_SET) c.maxFC = req.maxFC;
+    if (given & MAXFLIGHT_SET) c.maxFlight = req.maxFlight;
+    if (given & MAXTRAVEL_SET) c.maxTravel = req.maxTravel;
+    if (given & TIMESCALE_SET) c.timeScale = req.timeScale;
+    if (given & LOGLEVEL_SET) c.eventsOnly = req.eventsOnly;
+    if ((given != 0) && ((valid = controlCheck (&c)) == 0)) {
+        c.version++;
+        sh->control = c;
+    }
+    if (semUp (semgid, sh->mutex) == -1) {
+        perror ("error on the up operation for semaphore access");
+        return EXIT_FAILURE;
+    }
+    shmemDettach (sh);
+
+    if (valid == -1) {
+        fprintf (stderr, "%s: settings not valid (1 <= minFC <= maxFC, N / minFC rounded up at most %d, times and "
+                         "scale not negative), not changed\n", argv[0], MAXNF);
+        return EXIT_FAILURE;
+    }
+    print (&c);
+
+    return EXIT_SUCCESS;
+}
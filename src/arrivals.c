@@ -0,0 +1,194 @@
+/**
+ *  \file arrivals.c (implementation file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  Arrival generator.
+ *
+ *  Defined operations:
+ *     \li selecting the arrival generator
+ *     \li starting the arrival generator.
+ *
+ *  The timer wheel has <tt>LEVELS</tt> levels of <tt>SLOTS</tt> slots, a slot of level <tt>l</tt> spanning
+ *  <tt>SLOTS^l</tt> ticks; a timer is kept at the lowest level whose span reaches its expiry, and moved down a level
+ *  (cascaded) when the current tick enters the slot holding it. The generator sleeps until absolute deadlines: the
+ *  next tick of level 0 holding timers or, if there is none before it, the next tick where a slot of level 1 is
+ *  cascaded, so empty ticks cost nothing. Passengers arriving in the same tick are released by a single batch of
+ *  <em>up</em> operations, in order of arrival time, which does not set the order in which they then run.
+ *  The arrival generator is forked without exec, so it leaves through _exit: the exit handlers belong to its parent.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/types.h>
+
+#include "probConst.h"
+#include "probDataStruct.h"
+#include "sharedDataSync.h"
+#include "semaphore.h"
+#include "arrivals.h"
+
+/** \brief levels of the timer wheel */
+#define  LEVELS         4
+
+/** \brief bits of the slot number of a level */
+#define  SLOTBITS       6
+
+/** \brief slots per level */
+#define  SLOTS          (1 << SLOTBITS)
+
+/**
+ *  \brief Definition of <em>timer wheel</em> data type.
+ *
+ *  Timers are passengers, chained by passenger id.
+ */
+typedef struct
+{ /** \brief current tick */
+    unsigned long long now;
+    /** \brief first timer of each slot (-1 if none) */
+    int slot[LEVELS][SLOTS];
+    /** \brief next timer of the same slot (-1 if none) */
+    int next[N];
+    /** \brief expiry of each timer (ticks) */
+    unsigned long long expiry[N];
+
+} WHEEL;
+
+static void wheelAdd (WHEEL *w, int p)
+{
+    unsigned long long delta = (w->expiry[p] > w->now) ? w->expiry[p] - w->now : 0;
+    unsigned int l = 0, s;
+
+    while ((l < LEVELS - 1) && (delta >> (SLOTBITS * (l + 1))) != 0)
+        l++;
+    s = (unsigned int) (((delta == 0) ? w->now : w->expiry[p]) >> (SLOTBITS * l)) & (SLOTS - 1);
+    w->next[p] = w->slot[l][s];
+    w->slot[l][s] = p;
+}
+
+/* the slots the current tick enters moved down a level */
+static void wheelCascade (WHEEL *w)
+{
+    unsigned int l, s;
+    int p, q;
+
+    for (l = 1; (l < LEVELS) && (((w->now >> (SLOTBITS * (l - 1))) & (SLOTS - 1)) == 0); l++) {
+        s = (unsigned int) (w->now >> (SLOTBITS * l)) & (SLOTS - 1);
+        for (p = w->slot[l][s], w->slot[l][s] = -1; p != -1; p = q) {
+            q = w->next[p];
+            wheelAdd (w, p);
+        }
+    }
+}
+
+/* next tick to visit: one of level 0 holding timers, or the next cascade */
+static unsigned long long wheelNext (WHEEL *w)
+{
+    unsigned long long t;
+
+    for (t = w->now + 1; (t & (SLOTS - 1)) != 0; t++)
+        if (w->slot[0][t & (SLOTS - 1)] != -1)
+            return t;
+    return t;
+}
+
+static void addTime (struct timespec *t, const struct timespec *start, unsigned long long us)
+{
+    t->tv_sec = start->tv_sec + (time_t) (us / 1000000);
+    t->tv_nsec = start->tv_nsec + (long) (us % 1000000) * 1000;
+    if (t->tv_nsec >= 1000000000L) {
+        t->tv_nsec -= 1000000000L;
+        t->tv_sec++;
+    }
+}
+
+static void arrivals (SHARED_DATA *sh, int semgid)
+{
+    static WHEEL w;
+    unsigned int tick = sh->arrivalTick, travel[N], nReleased = 0, n, k;
+    SEM_OP batch[N], op;
+    struct timespec start, deadline;
+    int p;
+
+    clock_gettime (CLOCK_MONOTONIC, &start);
+    srandom ((unsigned int) sh->arrivalSeed);
+    memset (w.slot, -1, sizeof (w.slot));
+    w.now = 0;
+    for (p = 0; p < N; p++) {                                         /* same distribution as the passengers' own */
+        travel[p] = (unsigned int) ((MAXTRAVEL * (double) random ()) / RAND_MAX + 1000);
+        w.expiry[p] = (travel[p] + tick - 1) / tick;
+        wheelAdd (&w, p);
+    }
+
+    while (nReleased < N) {
+        w.now = wheelNext (&w);
+        if ((w.now & (SLOTS - 1)) == 0)
+            wheelCascade (&w);
+        if ((p = w.slot[0][w.now & (SLOTS - 1)]) == -1)
+            continue;
+        w.slot[0][w.now & (SLOTS - 1)] = -1;
+        for (n = 0; p != -1; p = w.next[p]) {                                    /* in order of arrival time */
+            op.sindex = ARRIVED (p);
+            op.op = 1;
+            for (k = n++; (k > 0) && (travel[batch[k - 1].sindex - ARRIVED (0)] > travel[p]); k--)
+                batch[k] = batch[k - 1];
+            batch[k] = op;
+        }
+        addTime (&deadline, &start, w.now * tick);
+        while (clock_nanosleep (CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) == EINTR)
+            ;
+        if (semOps (semgid, batch, n) == -1) {
+            perror ("error on the up operation for semaphore access (AG)");
+            _exit (EXIT_FAILURE);
+        }
+        nReleased += n;
+    }
+}
+
+/**
+ *  \brief Selecting the arrival generator.
+ *
+ *  Sets the tick (0 when not enabled) and the seed of the arrivals in the shared memory region, before the
+ *  passengers are generated.
+ *
+ *  \param sh pointer to the shared memory region
+ */
+
+void arrivalSelect (SHARED_DATA *sh)
+{
+    char *env = getenv ("AIRLIFT_ARRIVALS"), *end;
+
+    sh->arrivalTick = 0;
+    sh->arrivalSeed = (unsigned long) getpid ();
+    if ((env == NULL) || ((sh->arrivalTick = (unsigned int) strtoul (env, &end, 10)) == 0))
+        return;
+    if ((*end == ':') && (end[1] != '\0'))
+        sh->arrivalSeed = strtoul (end + 1, NULL, 10);
+}
+
+/**
+ *  \brief Starting the arrival generator.
+ *
+ *  \param sh pointer to the shared memory region
+ *  \param semgid semaphore set identifier
+ *
+ *  \return process identifier of the arrival generator, upon success
+ *  \return \c 0, when the arrival generator is not enabled
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+pid_t startArrivals (SHARED_DATA *sh, int semgid)
+{
+    pid_t pid;
+
+    if (sh->arrivalTick == 0)
+        return 0;
+    if ((pid = fork ()) != 0)
+        return pid;
+    arrivals (sh, semgid);
+    _exit (EXIT_SUCCESS);                                               /* the exit handlers belong to the parent */
+}
@@ -0,0 +1,56 @@
+/**
+ *  \file arrivals.h (interface file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  Arrival generator.
+ *
+ *  When the environment variable <tt>AIRLIFT_ARRIVALS</tt> is set to <tt>tick[:seed]</tt>, the passengers no longer
+ *  sleep their own travel time: the arrival times of all of them are drawn up front (from the same distribution,
+ *  with <tt>seed</tt>, the process id by default) and kept in a hierarchical timer wheel of <tt>tick</tt>
+ *  microseconds by a single arrival generator process, which releases the passengers arriving in the same tick
+ *  together, each one blocked on a semaphore of its own (<tt>ARRIVED(p)</tt>). There is one timer and one wakeup per
+ *  tick holding arrivals, rather than one per passenger. The arrivals are exact to tick resolution only: the same
+ *  seed gives the same arrival tick to every passenger, but the passengers released in the same tick reach the
+ *  airport in the order the scheduler runs them.
+ *
+ *  Defined operations:
+ *     \li selecting the arrival generator
+ *     \li starting the arrival generator.
+ */
+
+#ifndef ARRIVALS_H_
+#define ARRIVALS_H_
+
+#include <sys/types.h>
+
+#include "sharedDataSync.h"
+
+/**
+ *  \brief Selecting the arrival generator.
+ *
+ *  Sets the tick (0 when not enabled) and the seed of the arrivals in the shared memory region, before the
+ *  passengers are generated.
+ *
+ *  \param sh pointer to the shared memory region
+ */
+
+extern void arrivalSelect (SHARED_DATA *sh);
+
+/**
+ *  \brief Starting the arrival generator.
+ *
+ *  The arrival generator is a child process of the caller, which must already have signaled the start of
+ *  operations; it terminates once every passenger is released.
+ *
+ *  \param sh pointer to the shared memory region
+ *  \param semgid semaphore set identifier
+ *
+ *  \return process identifier of the arrival generator, upon success
+ *  \return \c 0, when the arrival generator is not enabled
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+extern pid_t startArrivals (SHARED_DATA *sh, int semgid);
+
+#endif /* ARRIVALS_H_ */
@@ -0,0 +1,227 @@
+/**
+ *  \file causal.c (implementation file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  Virtual speedup for causal profiling.
+ *
+ *  Defined operations:
+ *     \li selecting the target
+ *     \li enabling the virtual speedup in an entity
+ *     \li marking the start and the end of a phase
+ *     \li makespan less the delays inserted.
+ *
+ *  The total delay inserted is a counter in shared memory, every entity keeping the part of it already accounted
+ *  for by itself: the delay owed is the difference. The entity executing the target adds the delay to both, so it
+ *  never delays itself. Only the time the target runs is sped up: the time blocked in <em>down</em> operations and
+ *  spent paying delays within the phase is left out. As in Coz, an entity woken by an <em>up</em> operation done
+ *  after it blocked takes over the delay paid by the entity that did it (its part of the total, published with the
+ *  operation), being causally behind it, but still owes the rest. The entity hooks itself to the semaphore
+ *  operations, delays being inserted before the <em>down</em> ones only, so never while the critical region is
+ *  held.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+
+#include "probConst.h"
+#include "probDataStruct.h"
+#include "semaphore.h"
+#include "phaseCounters.h"
+#include "causal.h"
+
+/** \brief virtual speedup (NULL if not enabled in this process) */
+static CAUSAL *causal = NULL;
+
+/** \brief part of the total delay accounted for by this process */
+static unsigned long long local = 0;
+
+/** \brief start of the current phase, of the current down operation and of the current hold of the mutex */
+static unsigned long long tPhase, tDown, tHeld;
+
+/** \brief time of the current phase spent blocked or paying delays */
+static unsigned long long tOff;
+
+/** \brief hook previously set */
+static SEM_HOOK prevHook = NULL;
+
+static unsigned long long timeNs (void)
+{
+    struct timespec t;
+
+    clock_gettime (CLOCK_MONOTONIC, &t);
+    return (unsigned long long) t.tv_sec * 1000000000ULL + (unsigned long long) t.tv_nsec;
+}
+
+/* inserting the delay owed */
+static void pay (void)
+{
+    unsigned long long total = __atomic_load_n (&causal->delay, __ATOMIC_ACQUIRE), t;
+    struct timespec d;
+
+    if (total <= local)
+        return;
+    d.tv_sec = (time_t) ((total - local) / 1000000000ULL);
+    d.tv_nsec = (long) ((total - local) % 1000000000ULL);
+    t = timeNs ();
+    while ((nanosleep (&d, &d) == -1) && (errno == EINTR))
+        ;
+    tOff += timeNs () - t;
+    local = total;
+}
+
+/* an execution of the target that took t nanoseconds: the other entities delayed */
+static void speedUp (unsigned long long t)
+{
+    unsigned long long d = t * causal->speedup / 100;
+
+    __atomic_fetch_add (&causal->delay, d, __ATOMIC_RELEASE);
+    local += d;
+}
+
+static void hook (unsigned int point, unsigned int sindex)
+{
+    unsigned long long now = timeNs (), credit;
+
+    if (prevHook != NULL)
+        prevHook (point, sindex);
+    switch (point) {
+        case SEM_HOOK_DOWN:
+            pay ();
+            tDown = timeNs ();
+            break;
+        case SEM_HOOK_DOWN_RETURN:
+            tOff += now - tDown;
+            if ((sindex < NCREDITS) &&                                      /* woken by an up done after it blocked */
+                (__atomic_load_n (&causal->tUp[sindex], __ATOMIC_ACQUIRE) >= tDown)) {
+                credit = __atomic_load_n (&causal->credit[sindex], __ATOMIC_ACQUIRE);
+                if (credit > local)
+                    local = credit;
+            }
+            if ((causal->target == NPHASES) && (sindex == causal->mutex))
+                tHeld = now;
+            break;
+        case SEM_HOOK_UP:
+            if ((causal->target == NPHASES) && (sindex == causal->mutex))
+                speedUp (now - tHeld);
+            if (sindex < NCREDITS) {                                        /* delay paid, handed to the entity woken */
+                __atomic_store_n (&causal->credit[sindex], local, __ATOMIC_RELEASE);
+                __atomic_store_n (&causal->tUp[sindex], now, __ATOMIC_RELEASE);
+            }
+            break;
+    }
+}
+
+/**
+ *  \brief Selecting the target.
+ *
+ *  \param c pointer to the virtual speedup, located in shared memory
+ *  \param mutex semaphore location of the critical region protection
+ *
+ *  \return \c 0, upon success (the virtual speedup is disabled when <tt>AIRLIFT_CAUSAL</tt> is not set)
+ *  \return -\c 1, when the target is not known or the speedup is not within 0 .. 100 (<tt>errno</tt> is set to
+ *          <tt>EINVAL</tt>)
+ */
+
+int causalSelect (CAUSAL *c, unsigned int mutex)
+{
+    char *env = getenv ("AIRLIFT_CAUSAL"), *sep, *end;
+    unsigned int target;
+    long speedup;
+
+    memset (c, 0, sizeof (CAUSAL));
+    if ((env == NULL) || (*env == '\0'))
+        return 0;
+    if ((sep = strchr (env, ':')) == NULL) {
+        errno = EINVAL;
+        return -1;
+    }
+    for (target = 0; target < NPHASES; target++)
+        if ((strlen (phaseName (target)) == (size_t) (sep - env)) &&
+            (strncmp (phaseName (target), env, (size_t) (sep - env)) == 0))
+            break;
+    if ((target == NPHASES) && (strncmp ("mutex:", env, 6) != 0)) {
+        errno = EINVAL;
+        return -1;
+    }
+    speedup = strtol (sep + 1, &end, 10);
+    if ((*end != '\0') || (speedup < 0) || (speedup > 100)) {
+        errno = EINVAL;
+        return -1;
+    }
+    c->target = target;
+    c->speedup = (unsigned int) speedup;
+    c->mutex = mutex;
+    c->enabled = true;
+
+    return 0;
+}
+
+/**
+ *  \brief Enabling the virtual speedup in the calling entity.
+ *
+ *  \param c pointer to the virtual speedup, located in shared memory
+ */
+
+void causalOpen (CAUSAL *c)
+{
+    if (!c->enabled)
+        return;
+    causal = c;
+    local = 0;
+    prevHook = semSetHook (hook);
+}
+
+/**
+ *  \brief Marking the start of a phase.
+ */
+
+void causalBegin (void)
+{
+    if (causal == NULL)
+        return;
+    pay ();
+    tPhase = timeNs ();
+    tOff = 0;
+}
+
+/**
+ *  \brief Marking the end of a phase.
+ *
+ *  \param phase phase
+ */
+
+void causalEnd (unsigned int phase)
+{
+    unsigned long long t;
+
+    if (causal == NULL)
+        return;
+    t = timeNs () - tPhase;
+    if (phase == causal->target)
+        speedUp ((t > tOff) ? t - tOff : 0);                           /* the time the target ran only */
+    pay ();
+}
+
+/**
+ *  \brief Makespan less the delays inserted.
+ *
+ *  \param c pointer to the virtual speedup
+ *  \param makespan duration of the air lift (microseconds)
+ *
+ *  \return virtual makespan (microseconds), \c 0 when the virtual speedup is disabled
+ */
+
+unsigned long long causalMakespan (CAUSAL *c, unsigned long long makespan)
+{
+    unsigned long long delay = c->delay / 1000;
+
+    if (!c->enabled)
+        return 0;
+
+    return (delay < makespan) ? makespan - delay : 1;
+}
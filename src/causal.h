@@ -0,0 +1,79 @@
+/**
+ *  \file causal.h (interface file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  Virtual speedup for causal profiling.
+ *
+ *  When the environment variable <tt>AIRLIFT_CAUSAL</tt> is set to <tt>target:percent</tt>, the target (a lifecycle
+ *  phase, named after its function, or <tt>mutex</tt> for the hold time of the critical region) is virtually sped up
+ *  by <tt>percent</tt>: after each execution of the target taking <tt>t</tt>, every other entity is delayed by
+ *  <tt>t * percent / 100</tt>, which is the same, relative to the entity that executed it, as having executed it
+ *  that much faster. The makespan of the air lift less the total delay inserted is the makespan it would have were
+ *  the target actually that much faster.
+ *
+ *  The delays owed by an entity are inserted at its phase boundaries and <em>down</em> operations; only the time
+ *  the target runs is sped up, not the time it is blocked or paying delays. An entity woken by an <em>up</em>
+ *  operation counts the delays already paid by the entity that did it as served.
+ *
+ *  Defined operations:
+ *     \li selecting the target
+ *     \li enabling the virtual speedup in an entity
+ *     \li marking the start and the end of a phase
+ *     \li makespan less the delays inserted.
+ */
+
+#ifndef CAUSAL_H_
+#define CAUSAL_H_
+
+#include "probDataStruct.h"
+
+/**
+ *  \brief Selecting the target.
+ *
+ *  \param c pointer to the virtual speedup, located in shared memory
+ *  \param mutex semaphore location of the critical region protection
+ *
+ *  \return \c 0, upon success (the virtual speedup is disabled when <tt>AIRLIFT_CAUSAL</tt> is not set)
+ *  \return -\c 1, when the target is not known or the speedup is not within 0 .. 100 (<tt>errno</tt> is set to
+ *          <tt>EINVAL</tt>)
+ */
+
+extern int causalSelect (CAUSAL *c, unsigned int mutex);
+
+/**
+ *  \brief Enabling the virtual speedup in the calling entity.
+ *
+ *  Nothing is done when it is disabled.
+ *
+ *  \param c pointer to the virtual speedup, located in shared memory
+ */
+
+extern void causalOpen (CAUSAL *c);
+
+/**
+ *  \brief Marking the start of a phase.
+ */
+
+extern void causalBegin (void);
+
+/**
+ *  \brief Marking the end of a phase.
+ *
+ *  \param phase phase
+ */
+
+extern void causalEnd (unsigned int phase);
+
+/**
+ *  \brief Makespan less the delays inserted.
+ *
+ *  \param c pointer to the virtual speedup
+ *  \param makespan duration of the air lift (microseconds)
+ *
+ *  \return virtual makespan (microseconds), \c 0 when the virtual speedup is disabled
+ */
+
+extern unsigned long long causalMakespan (CAUSAL *c, unsigned long long makespan);
+
+#endif /* CAUSAL_H_ */
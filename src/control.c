@@ -0,0 +1,66 @@
+/**
+ *  \file control.c (implementation file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  Settings changed while running.
+ *
+ *  Defined operations:
+ *     \li selecting the initial settings
+ *     \li validating a change of the settings.
+ */
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+
+#include "probConst.h"
+#include "probDataStruct.h"
+#include "control.h"
+
+/**
+ *  \brief Selecting the initial settings.
+ *
+ *  Sets the control block from the compile-time constants and the logging level from <tt>AIRLIFT_LOG_LEVEL</tt>, at
+ *  version 0, before the intervening entities are generated.
+ *
+ *  \param c pointer to the control block
+ */
+
+void controlSelect (CONTROL *c)
+{
+    char *level = getenv ("AIRLIFT_LOG_LEVEL");
+
+    c->version = c->logged = 0;
+    c->minFC = MINFC;
+    c->maxFC = MAXFC;
+    c->maxFlight = MAXFLIGHT;
+    c->maxTravel = MAXTRAVEL;
+    c->timeScale = 1.0;
+    c->eventsOnly = (level != NULL) && (strcmp (level, "events") == 0);
+}
+
+/**
+ *  \brief Validating a change of the settings.
+ *
+ *  The capacities must satisfy <tt>1 <= minFC <= maxFC</tt>, the times and the factor must not be negative. Every
+ *  flight but the last one takes at least <tt>minFC</tt> passengers, so the <tt>N</tt> passengers must fit in the
+ *  <tt>MAXNF</tt> flight records of the full state at the lowest capacity ever in force.
+ *
+ *  \param c pointer to the settings changed
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when the settings are not valid (<tt>errno</tt> set to <tt>EINVAL</tt>)
+ */
+
+int controlCheck (const CONTROL *c)
+{
+    if ((c->minFC < 1) || (c->minFC > c->maxFC) || ((N + c->minFC - 1) / c->minFC > MAXNF) ||
+        !(c->maxFlight >= 0.0) || !(c->maxTravel >= 0.0) || !(c->timeScale >= 0.0)) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,52 @@
+/**
+ *  \file control.h (interface file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  Settings changed while running.
+ *
+ *  The capacity rules (<tt>MINFC</tt>, <tt>MAXFC</tt>), the flight and travel times (<tt>MAXFLIGHT</tt>,
+ *  <tt>MAXTRAVEL</tt>), a factor applied to both and the logging level are kept in a control block in the shared
+ *  memory region, set at the start from the compile-time constants and from <tt>AIRLIFT_LOG_LEVEL</tt>. They may be
+ *  changed while a run is going by <tt>airliftctl</tt>: the hostess reads the capacity rules at every passenger
+ *  checked, the pilot the flight time at every flight, the passengers the travel time as they leave for the airport
+ *  and every entity the logging level at every line written. Every change is versioned and written to the logging
+ *  file, inside the critical region, by the first entity reading the block after it.
+ *
+ *  Defined operations:
+ *     \li selecting the initial settings
+ *     \li validating a change of the settings.
+ */
+
+#ifndef CONTROL_H_
+#define CONTROL_H_
+
+#include "probDataStruct.h"
+
+/**
+ *  \brief Selecting the initial settings.
+ *
+ *  Sets the control block from the compile-time constants and the logging level from <tt>AIRLIFT_LOG_LEVEL</tt>, at
+ *  version 0, before the intervening entities are generated.
+ *
+ *  \param c pointer to the control block
+ */
+
+extern void controlSelect (CONTROL *c);
+
+/**
+ *  \brief Validating a change of the settings.
+ *
+ *  The capacities must satisfy <tt>1 <= minFC <= maxFC</tt>, the times and the factor must not be negative. Every
+ *  flight but the last one takes at least <tt>minFC</tt> passengers, so a minimum capacity needing more than the
+ *  <tt>MAXNF</tt> flight records of the full state for the <tt>N</tt> passengers is refused.
+ *
+ *  \param c pointer to the settings changed
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when the settings are not valid (<tt>errno</tt> set to <tt>EINVAL</tt>)
+ */
+
+extern int controlCheck (const CONTROL *c);
+
+#endif /* CONTROL_H_ */
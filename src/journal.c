@@ -0,0 +1,349 @@
+/**
+ *  \file journal.c (implementation file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  Per-entity journals of the logging file, merged by sequence number.
+ *
+ *  Defined operations:
+ *     \li attaching the journal of an intervening entity
+ *     \li waiting for room in a journal
+ *     \li appending a record to a journal
+ *     \li starting the merger
+ *     \li stopping the merger, after every record was written.
+ *
+ *  A record is its sequence number and its length (8 bytes each) followed by its lines, padded to 8 bytes; it may
+ *  wrap around the end of the ring. The producer takes the sequence number only once the record fits, so a full
+ *  ring never holds back a number the merger is waiting for. The entities wait for room in their ring before
+ *  entering the critical region, so a record written inside it seldom has to wait for the merger.
+ *
+ *  The merger keeps the rings holding a record in a heap ordered by the sequence number of their first record and
+ *  writes the record whose number is the next one; the rings found empty are only polled again when that record
+ *  is not in the heap. It sleeps while no record is available. The merger is forked without exec, so it leaves
+ *  through _exit: the exit handlers belong to its parent.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/ipc.h>
+
+#include "probConst.h"
+#include "probDataStruct.h"
+#include "sharedDataSync.h"
+#include "sharedMemory.h"
+#include "logging.h"
+#include "journal.h"
+
+/** \brief size of a record header: sequence number and length */
+#define  HDR             16
+
+/** \brief idle time of the merger (nanoseconds) */
+#define  IDLE            100000
+
+/** \brief size of the output buffer of the merger */
+#define  OUTBUF          65536
+
+/** \brief size of a record of len bytes in the ring */
+#define  RECSIZE(len)    (HDR + (((len) + 7) & ~(size_t) 7))
+
+/** \brief journals of the pilot, the hostess and the passengers, as attached by this process (NULL if none) */
+static JOURNAL *journal = NULL;
+
+/**
+ *  \brief Definition of <em>heap entry</em> data type.
+ */
+typedef struct
+{ /** \brief sequence number of the first record of the ring */
+    unsigned long long seq;
+    /** \brief ring */
+    unsigned int j;
+
+} ENTRY;
+
+static void copyIn (JOURNAL *j, unsigned long long pos, const void *data, size_t len)
+{
+    size_t off = (size_t) (pos % JOURNAL_SIZE), n = (len < JOURNAL_SIZE - off) ? len : JOURNAL_SIZE - off;
+
+    memcpy (j->data + off, data, n);
+    memcpy (j->data, (const char *) data + n, len - n);
+}
+
+static void copyOut (const JOURNAL *j, unsigned long long pos, void *data, size_t len)
+{
+    size_t off = (size_t) (pos % JOURNAL_SIZE), n = (len < JOURNAL_SIZE - off) ? len : JOURNAL_SIZE - off;
+
+    memcpy (data, j->data + off, n);
+    memcpy ((char *) data + n, j->data, len - n);
+}
+
+/**
+ *  \brief Attaching the journal of an intervening entity.
+ *
+ *  \param sh pointer to the shared memory region
+ *  \param entity entity id
+ *  \param j pointer to the location where the journal of the entity is stored (NULL when journals are not enabled)
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int journalOpen (SHARED_DATA *sh, unsigned int entity, JOURNAL **j)
+{
+    *j = NULL;
+    if (!sh->journals)
+        return 0;
+    if ((journal == NULL) && (shmemAttach (sh->journalShmid, (void **) &journal) == -1)) {
+        journal = NULL;
+        return -1;
+    }
+    *j = &journal[entity];
+
+    return 0;
+}
+
+/* the ring has room for size bytes more */
+static bool hasRoom (JOURNAL *j, size_t size)
+{
+    return j->tail + size - __atomic_load_n (&j->head, __ATOMIC_ACQUIRE) <= JOURNAL_SIZE;
+}
+
+/**
+ *  \brief Waiting for room in a journal.
+ *
+ *  \param j pointer to the journal
+ *  \param room number of bytes of the records to be appended
+ */
+
+void journalWait (JOURNAL *j, size_t room)
+{
+    while (!hasRoom (j, (room < JOURNAL_SIZE) ? room : JOURNAL_SIZE))
+        sched_yield ();                                                                  /* full: merger behind */
+}
+
+/**
+ *  \brief Appending a record to a journal.
+ *
+ *  \param j pointer to the journal
+ *  \param seq pointer to the global sequence number counter
+ *  \param data pointer to the lines
+ *  \param len number of bytes
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when the record does not fit in a ring (<tt>errno</tt> is set to <tt>EMSGSIZE</tt>)
+ */
+
+int journalPut (JOURNAL *j, unsigned long long *seq, const char *data, size_t len)
+{
+    unsigned long long hdr[2], tail = j->tail;
+    size_t size = RECSIZE (len);
+
+    if (size > JOURNAL_SIZE) {
+        errno = EMSGSIZE;
+        return -1;
+    }
+    while (!hasRoom (j, size))                                                       /* more than the room waited for */
+        sched_yield ();
+    hdr[0] = __atomic_fetch_add (seq, 1, __ATOMIC_RELAXED);
+    hdr[1] = len;
+    copyIn (j, tail, hdr, HDR);
+    copyIn (j, tail + HDR, data, len);
+    __atomic_store_n (&j->tail, tail + size, __ATOMIC_RELEASE);
+
+    return 0;
+}
+
+/* sequence number of the first record of a ring, false if it is empty */
+static bool peek (JOURNAL *j, unsigned long long *seq)
+{
+    if (__atomic_load_n (&j->tail, __ATOMIC_ACQUIRE) == j->head)
+        return false;
+    copyOut (j, j->head, seq, sizeof (unsigned long long));
+
+    return true;
+}
+
+static void push (ENTRY heap[], unsigned int *n, ENTRY e)
+{
+    unsigned int k = (*n)++;
+
+    for (; (k > 0) && (heap[(k - 1) / 2].seq > e.seq); k = (k - 1) / 2)
+        heap[k] = heap[(k - 1) / 2];
+    heap[k] = e;
+}
+
+static ENTRY pop (ENTRY heap[], unsigned int *n)
+{
+    ENTRY top = heap[0], last = heap[--(*n)];
+    unsigned int k = 0, c;
+
+    while ((c = 2 * k + 1) < *n) {
+        if ((c + 1 < *n) && (heap[c + 1].seq < heap[c].seq))
+            c++;
+        if (last.seq <= heap[c].seq)
+            break;
+        heap[k] = heap[c];
+        k = c;
+    }
+    heap[k] = last;
+
+    return top;
+}
+
+/* writing the first record of a ring and releasing its room */
+static void writeRecord (FILE *fic, JOURNAL *j)
+{
+    unsigned long long hdr[2];
+    char line[JOURNAL_SIZE];
+
+    copyOut (j, j->head, hdr, HDR);
+    copyOut (j, j->head + HDR, line, (size_t) hdr[1]);
+    if (fwrite (line, 1, (size_t) hdr[1], fic) != (size_t) hdr[1]) {
+        perror ("error on writing log file (MG)");
+        _exit (EXIT_FAILURE);
+    }
+    __atomic_store_n (&j->head, j->head + RECSIZE ((size_t) hdr[1]), __ATOMIC_RELEASE);
+}
+
+static void merger (SHARED_DATA *sh, char nFic[])
+{
+    static char outBuf[OUTBUF];
+    struct timespec idle = { 0, IDLE };
+    ENTRY heap[N + 2], e;
+    bool inHeap[N + 2] = { false }, stopping = false, found;
+    unsigned long long next = 0;
+    unsigned int n = 0, j;
+    FILE *fic;
+
+    if ((fic = fopen (nFic, "a")) == NULL) {
+        perror ("error on opening log file (MG)");
+        _exit (EXIT_FAILURE);
+    }
+    setvbuf (fic, outBuf, _IOFBF, OUTBUF);
+    while (true) {
+        if ((n > 0) && ((heap[0].seq == next) || stopping)) {
+            e = pop (heap, &n);
+            writeRecord (fic, &journal[e.j]);
+            next = e.seq + 1;
+            if (peek (&journal[e.j], &e.seq))
+                push (heap, &n, e);
+            else inHeap[e.j] = false;
+            continue;
+        }
+
+        /* next record not at the head of a ring known to hold records: the empty ones polled */
+
+        found = false;
+        for (j = 0; j < N + 2; j++)
+            if (!inHeap[j] && peek (&journal[j], &e.seq)) {
+                e.j = j;
+                push (heap, &n, e);
+                inHeap[j] = found = true;
+            }
+        if (found)
+            continue;
+        if (stopping)
+            break;                                                                        /* every record written */
+        if (__atomic_load_n (&sh->stopMerger, __ATOMIC_ACQUIRE)) {
+            stopping = true;                                                 /* the entities are over: last poll */
+            continue;
+        }
+        if (fflush (fic) == EOF) {
+            perror ("error on writing log file (MG)");
+            _exit (EXIT_FAILURE);
+        }
+        nanosleep (&idle, NULL);
+    }
+    if (fclose (fic) == EOF) {
+        perror ("error on closing log file (MG)");
+        _exit (EXIT_FAILURE);
+    }
+}
+
+/* the segment of the journals detached and destroyed */
+static void releaseJournals (SHARED_DATA *sh)
+{
+    shmemDettach (journal);
+    shmemDestroy (sh->journalShmid);
+    journal = NULL;
+    sh->journals = false;
+}
+
+/**
+ *  \brief Starting the merger.
+ *
+ *  \param sh pointer to the shared memory region
+ *  \param nFic name of the logging file
+ *
+ *  \return process identifier of the merger, upon success
+ *  \return \c 0, when journals are not enabled (or the logging file is not a plain file)
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+pid_t startMerger (SHARED_DATA *sh, char nFic[])
+{
+    pid_t pid;
+    int err;
+
+    sh->journals = false;
+    if (!logThroughJournals (nFic))
+        return 0;
+    if ((sh->journalShmid = shmemCreate (IPC_PRIVATE, (N + 2) * sizeof (JOURNAL))) == -1)
+        return -1;                                                        /* a new segment: every ring is empty */
+    if (shmemAttach (sh->journalShmid, (void **) &journal) == -1) {
+        err = errno;
+        shmemDestroy (sh->journalShmid);
+        journal = NULL;
+        errno = err;
+        return -1;
+    }
+    sh->journals = true;
+    sh->journalSeq = 0;
+    sh->stopMerger = false;
+    fflush (NULL);                                                         /* nothing buffered written twice */
+    if ((pid = fork ()) != 0) {
+        if (pid == -1) {
+            err = errno;
+            releaseJournals (sh);
+            errno = err;
+        }
+        return pid;
+    }
+    merger (sh, nFic);
+    _exit (EXIT_SUCCESS);                                               /* the exit handlers belong to the parent */
+}
+
+/**
+ *  \brief Stopping the merger, after every record was written.
+ *
+ *  \param sh pointer to the shared memory region
+ *  \param pid process identifier of the merger (nothing is done if \c 0)
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when the merger failed (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int stopMerger (SHARED_DATA *sh, pid_t pid)
+{
+    int status;
+
+    if (pid == 0)
+        return 0;
+    __atomic_store_n (&sh->stopMerger, true, __ATOMIC_RELEASE);
+    if (waitpid (pid, &status, 0) == -1)
+        return -1;
+    releaseJournals (sh);
+    if (!WIFEXITED (status) || (WEXITSTATUS (status) != EXIT_SUCCESS)) {
+        errno = ECHILD;
+        return -1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,108 @@
+/**
+ *  \file journal.h (interface file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  Per-entity journals of the logging file, merged by sequence number.
+ *
+ *  When the environment variable <tt>AIRLIFT_LOG_SINK</tt> is set to <tt>journal</tt>, every intervening entity
+ *  writes the lines of a plain logging file into its own single producer ring in shared memory, each record
+ *  carrying a global sequence number taken from a single atomic counter. A merger process consumes the rings as
+ *  they fill, merging them by sequence number into the logging file, and drains them once the entities are over.
+ *
+ *  The entities only share the counter: no lock, no file and no common ring, whatever the number of passengers.
+ *  The rings are kept in a shared memory segment of their own, created by the merger only when journals are
+ *  enabled, so the shared memory region does not grow with them otherwise.
+ *
+ *  Defined operations:
+ *     \li attaching the journal of an intervening entity
+ *     \li waiting for room in a journal
+ *     \li appending a record to a journal
+ *     \li starting the merger
+ *     \li stopping the merger, after every record was written.
+ */
+
+#ifndef JOURNAL_H_
+#define JOURNAL_H_
+
+#include <stddef.h>
+#include <sys/types.h>
+
+#include "probDataStruct.h"
+#include "sharedDataSync.h"
+
+/**
+ *  \brief Attaching the journal of an intervening entity.
+ *
+ *  The segment of the journals is attached to the address space of the caller, when journals are enabled.
+ *
+ *  \param sh pointer to the shared memory region
+ *  \param entity entity id
+ *  \param j pointer to the location where the journal of the entity is stored (NULL when journals are not enabled)
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+extern int journalOpen (SHARED_DATA *sh, unsigned int entity, JOURNAL **j);
+
+/**
+ *  \brief Waiting for room in a journal.
+ *
+ *  Only the owner of the journal may wait for it, before entering the critical region where it appends the records,
+ *  so that it does not wait for the merger while holding it.
+ *
+ *  \param j pointer to the journal
+ *  \param room number of bytes of the records to be appended (headers included)
+ */
+
+extern void journalWait (JOURNAL *j, size_t room);
+
+/**
+ *  \brief Appending a record to a journal.
+ *
+ *  Only the owner of the journal may append to it. When the ring is full, the caller waits for the merger.
+ *
+ *  \param j pointer to the journal
+ *  \param seq pointer to the global sequence number counter
+ *  \param data pointer to the lines
+ *  \param len number of bytes
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when the record does not fit in a ring (<tt>errno</tt> is set to <tt>EMSGSIZE</tt>)
+ */
+
+extern int journalPut (JOURNAL *j, unsigned long long *seq, const char *data, size_t len);
+
+/**
+ *  \brief Starting the merger.
+ *
+ *  The merger is a child process of the caller, which must already have initialized the logging file and must
+ *  start it before the intervening entities are generated. The segment of the journals is created when journals
+ *  are enabled.
+ *
+ *  \param sh pointer to the shared memory region
+ *  \param nFic name of the logging file
+ *
+ *  \return process identifier of the merger, upon success
+ *  \return \c 0, when journals are not enabled (or the logging file is not a plain file)
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+extern pid_t startMerger (SHARED_DATA *sh, char nFic[]);
+
+/**
+ *  \brief Stopping the merger, after every record was written.
+ *
+ *  The intervening entities must be over. The segment of the journals is destroyed.
+ *
+ *  \param sh pointer to the shared memory region
+ *  \param pid process identifier of the merger (nothing is done if \c 0)
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when the merger failed (the actual situation is reported in <tt>errno</tt>)
+ */
+
+extern int stopMerger (SHARED_DATA *sh, pid_t pid);
+
+#endif /* JOURNAL_H_ */
@@ -12,7 +12,47 @@
  *     \li writing the present full state as a single line at the end of the file.
  *     \li Writing the flight arrival at the end of the file.
  *     \li Writing the flight returning at the end of the file.
- *     \li writing summary of air lift at the end of the file.
+ *     \li writing summary of air lift at the end of the file
+ *     \li measuring the time elapsed since the start of operations
+ *     \li setting the shared buffer of compressed logging files
+ *     \li setting the journal of the calling process
+ *     \li telling whether a logging file is written through journals
+ *     \li waiting for room in the journal before a critical region.
+ *
+ *  When the environment variable <tt>AIRLIFT_LOG_LEVEL</tt> is set to <tt>events</tt>, only the events (boarding,
+ *  passenger checked, departure, arrival, return) and the summary are written, not the state lines nor their
+ *  headers; the state may then be recorded at a fixed rate by the sampler (sampler.c).
+ *
+ *  When the environment variable <tt>AIRLIFT_LOG_TIME</tt> is set (not empty), every state line ends with the time
+ *  elapsed since the start of operations (in microseconds), so the transitions may be timed afterwards; the lines
+ *  are then no longer in the layout expected by <tt>filter_log.awk</tt>.
+ *
+ *  When the environment variable <tt>AIRLIFT_RESULT_TIMES</tt> is set (not empty), the summary also holds the
+ *  duration of the air lift and the time each passenger waited in queue (read by <tt>airliftStats</tt>).
+ *
+ *  Logging files whose name ends in <tt>.gz</tt> are written compressed (gzip format): the lines are gathered in a
+ *  buffer shared by all processes and every time it fills up it is compressed and appended to the file as a gzip
+ *  member, the file being a valid gzip stream at any member boundary.
+ *
+ *  When the environment variable <tt>AIRLIFT_LOG_ROTATE</tt> is set to <tt>size[:keep]</tt>, a logging file that
+ *  reached <tt>size</tt> bytes, or that already exists when it is initialized, is renamed to <tt>name.1</tt>
+ *  (<tt>name.1.gz</tt> when compressed), older ones being shifted up to <tt>keep</tt> files (5 by default), and the
+ *  new file begins with the title and the column header. The size is tracked in the shared buffer, so it is only
+ *  checked when lines are appended to the file (for compressed files, when the buffer is flushed).
+ *
+ *  The environment is read when the file is initialized and when the shared buffer, the journal or the control
+ *  block is set, not at every line. These settings are kept per thread, so threads of a host process running
+ *  simulations with the process engine (libairlift) each log their own run.
+ *
+ *  When the environment variable <tt>AIRLIFT_LOG_SINK</tt> is set to <tt>uring</tt>, plain logging files are
+ *  written asynchronously: the writer reserves the next file offset in the shared buffer and submits the lines
+ *  through io_uring (uringLog.c), so it never waits for the storage inside the critical region. Each process waits
+ *  for its writes in flight on exit, the generator before writing the summary. Where io_uring is not available the
+ *  lines are written synchronously at the same offsets. Rotation does not apply to this sink.
+ *
+ *  When it is set to <tt>journal</tt>, the processes that set a journal append the lines of a plain logging file to
+ *  it instead, as a record numbered from the shared counter, and the merger process (journal.c) writes them to the
+ *  file in that order. Rotation does not apply to this sink either.
  *
  *  \author Nuno Lau - January 2022
  */
@@ -23,11 +63,294 @@
 #include <stdbool.h>
 
 #include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/time.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <zlib.h>
 
 
 #include "probConst.h"
 #include "probDataStruct.h"
+#include "sharedDataSync.h"
+#include "uringLog.h"
+#include "journal.h"
+#include "probes.h"
+#include "logging.h"
+
+/** \brief room waited for in the journal before a critical region: the records of the lines it writes (a state
+ *         line, or an event line and a column header, each), with some margin */
+#define  REGION_ROOM     (4 * (16 + 2 * (4 * N + 64)))
+
+/** \brief shared buffer of a compressed logging file (NULL if none, every write becomes a gzip member) */
+static __thread LOG_BUFFER *logBuf = NULL;
+
+/** \brief lines being written to a compressed logging file */
+static __thread char *lineBuf = NULL;
+static __thread size_t lineLen = 0;
+
+/** \brief asynchronous sink of this process: file name (NULL if none), descriptor of the synchronous fallback */
+static __thread char *asyncName = NULL;
+static __thread int asyncFd = -1;
+
+/** \brief journal of this process and global sequence number counter (NULL if none) */
+static __thread JOURNAL *logJournal = NULL;
+static __thread unsigned long long *logSeq = NULL;
+
+/** \brief control block of the settings changed while running (NULL if none) */
+static __thread CONTROL *logControl = NULL;
+
+/** \brief settings of the environment, read by createLog and setLog*: sink, logging level, time column */
+static __thread bool sinkUring = false, sinkJournal = false, levelEvents = false, timeColumn = false;
+
+/** \brief rotation settings of the environment: size (0 when disabled) and number of files kept */
+static __thread off_t rotateSize = 0;
+static __thread int rotateKeep = 5;
+
+static void printTitle(FILE *fic);
+
+/* settings read from the environment once, instead of at every line */
+static void readSettings(void)
+{
+    char *sink = getenv("AIRLIFT_LOG_SINK"), *level = getenv("AIRLIFT_LOG_LEVEL"), *t = getenv("AIRLIFT_LOG_TIME"),
+         *rotate = getenv("AIRLIFT_LOG_ROTATE"), *end;
+    long long size;
+
+    sinkUring = (sink != NULL) && (strcmp(sink, "uring") == 0);
+    sinkJournal = (sink != NULL) && (strcmp(sink, "journal") == 0);
+    levelEvents = (level != NULL) && (strcmp(level, "events") == 0);
+    timeColumn = (t != NULL) && (*t != '\0');
+    rotateSize = 0;
+    rotateKeep = 5;
+    if ((rotate != NULL) && ((size = strtoll(rotate, &end, 10)) > 0)) {
+        rotateSize = (off_t) size;
+        if ((*end == ':') && (atoi(end + 1) > 0))
+            rotateKeep = atoi(end + 1);
+    }
+}
+
+static bool isCompressed(char nFic[])
+{
+    size_t len = strlen(nFic);
+
+    return (len > 3) && (strcmp(nFic + len - 3, ".gz") == 0);
+}
+
+static bool isAsync(char nFic[])
+{
+    return sinkUring && (logBuf != NULL) && !isCompressed(nFic);
+}
+
+static bool isJournal(char nFic[])
+{
+    return sinkJournal && (logJournal != NULL) && !isCompressed(nFic);
+}
+
+/* plain logging file whose size is tracked in the shared buffer, for its rotation */
+static bool isTracked(char nFic[])
+{
+    return (rotateSize != 0) && (logBuf != NULL) && !isCompressed(nFic) && !isAsync(nFic) && !isJournal(nFic);
+}
+
+/* waiting for the writes in flight of this process and closing its asynchronous sink */
+static void closeAsync(void)
+{
+    if (asyncName == NULL)
+        return;
+    if (asyncFd != -1)
+        close(asyncFd);
+    else if (uringLogClose() == -1) {
+        perror ("error on writing log file");
+        exit (EXIT_FAILURE);
+    }
+    free(asyncName);
+    asyncName = NULL;
+    asyncFd = -1;
+}
+
+/* lines written at the next offset of the file, reserved in the shared buffer */
+static void writeAsync(char nFic[], const char *data, size_t len)
+{
+    static bool atExit = false;
+    long long off = logBuf->end;
+    ssize_t n;
+
+    logBuf->end += (long long) len;
+    if ((asyncName == NULL) || (strcmp(asyncName, nFic) != 0)) {
+        closeAsync();
+        if ((asyncName = strdup(nFic)) == NULL) {
+            perror ("error on opening log file");
+            exit (EXIT_FAILURE);
+        }
+        if ((uringLogOpen(nFic) == -1) && ((asyncFd = open(nFic, O_WRONLY | O_CLOEXEC)) == -1)) {
+            perror ("error on opening log file");
+            exit (EXIT_FAILURE);
+        }
+        if (!atExit) {
+            atexit(closeAsync);
+            atExit = true;
+        }
+    }
+    if (asyncFd == -1) {
+        if (uringLogWrite(data, len, off) == -1) {
+            perror ("error on writing log file");
+            exit (EXIT_FAILURE);
+        }
+        return;
+    }
+    while (len > 0) {                                                             /* io_uring not available */
+        if ((n = pwrite(asyncFd, data, len, (off_t) off)) == -1) {
+            perror ("error on writing log file");
+            exit (EXIT_FAILURE);
+        }
+        data += n;
+        len -= (size_t) n;
+        off += n;
+    }
+}
+
+static void rotateName(char nFic[], int k, char name[], size_t size)
+{
+    if (isCompressed(nFic))
+        snprintf(name, size, "%.*s.%d.gz", (int) strlen(nFic) - 3, nFic, k);
+    else snprintf(name, size, "%s.%d", nFic, k);
+}
+
+static void rotateLog(char nFic[], int keep)
+{
+    char from[256], to[256];
+    int k;
+
+    for (k = keep - 1; k > 0; k--) {
+        rotateName(nFic, k, from, sizeof(from));
+        rotateName(nFic, k + 1, to, sizeof(to));
+        rename(from, to);
+    }
+    rotateName(nFic, 1, to, sizeof(to));
+    if (rename(nFic, to) == -1) {
+        perror ("error on rotating log file");
+        exit (EXIT_FAILURE);
+    }
+}
+
+/* compression of a block of lines, appended to the logging file as a gzip member: its size */
+static size_t writeMember(char nFic[], const char *data, size_t len)
+{
+    z_stream z;
+    unsigned char *out;
+    size_t outLen;
+    FILE *fic;
+
+    memset(&z, 0, sizeof(z));
+    if (deflateInit2(&z, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        fprintf(stderr, "error on initializing log compression\n");
+        exit (EXIT_FAILURE);
+    }
+    outLen = deflateBound(&z, len);
+    if ((out = malloc(outLen)) == NULL) {
+        perror ("error on allocating log compression buffer");
+        exit (EXIT_FAILURE);
+    }
+    z.next_in = (unsigned char *) data;
+    z.avail_in = len;
+    z.next_out = out;
+    z.avail_out = outLen;
+    if (deflate(&z, Z_FINISH) != Z_STREAM_END) {
+        fprintf(stderr, "error on compressing log file\n");
+        exit (EXIT_FAILURE);
+    }
+    outLen -= z.avail_out;
+    deflateEnd(&z);
+
+    if ((fic = fopen(nFic, "ab")) == NULL) {
+        perror ("error on opening log file");
+        exit (EXIT_FAILURE);
+    }
+    if ((fwrite(out, 1, outLen, fic) != outLen) || (fclose(fic) == EOF)) {
+        perror ("error on writing log file");
+        exit (EXIT_FAILURE);
+    }
+    free(out);
+
+    return outLen;
+}
+
+/* lines appended to a plain logging file */
+static void writePlain(char nFic[], const char *data, size_t len)
+{
+    FILE *fic;
+
+    if ((fic = fopen(nFic, "a")) == NULL) {
+        perror ("error on opening log file");
+        exit (EXIT_FAILURE);
+    }
+    if ((fwrite(data, 1, len, fic) != len) || (fclose(fic) == EOF)) {
+        perror ("error on writing log file");
+        exit (EXIT_FAILURE);
+    }
+}
+
+/* a new logging file begins with the title and the column header */
+static void startLog(char nFic[])
+{
+    char *data = NULL;
+    size_t len = 0;
+    FILE *fic;
+
+    if ((fic = open_memstream(&data, &len)) == NULL) {
+        perror ("error on opening log file");
+        exit (EXIT_FAILURE);
+    }
+    printTitle(fic);
+    fclose(fic);
+    if (isCompressed(nFic))
+        logBuf->end = (long long) writeMember(nFic, data, len);
+    else {
+        writePlain(nFic, data, len);
+        logBuf->end = (long long) len;
+    }
+    free(data);
+}
+
+/* rotation of a logging file that reached its size limit, tracked in the shared buffer when there is one (that is
+   not empty, if any is true, before the file is created) */
+static void checkRotation(char nFic[], bool any)
+{
+    struct stat st;
+    long long size;
+
+    if (rotateSize == 0)
+        return;
+    if (!any && (logBuf != NULL))
+        size = logBuf->end;
+    else if (stat(nFic, &st) == 0)
+        size = (long long) st.st_size;
+    else return;
+    if (size < (any ? 1 : (long long) rotateSize))
+        return;
+    rotateLog(nFic, rotateKeep);
+    if (!any && (logBuf != NULL))
+        startLog(nFic);
+}
+
+/* lines appended as a gzip member, the size of the file being tracked */
+static void appendMember(char nFic[], const char *data, size_t len)
+{
+    size_t n = writeMember(nFic, data, len);
+
+    if (logBuf != NULL)
+        logBuf->end += (long long) n;
+    checkRotation(nFic, false);
+}
+
+/* compression of the lines in the shared buffer */
+static void flushLog(char nFic[])
+{
+    if ((nFic == NULL) || !isCompressed(nFic) || (logBuf == NULL) || (logBuf->len == 0))
+        return;
+    appendMember(nFic, logBuf->data, logBuf->len);
+    logBuf->len = 0;
+}
 
 static FILE *openLog(char nFic[], char mode[])
 {
@@ -39,6 +362,24 @@ static FILE *openLog(char nFic[], char mode[])
     }
     else fName = nFic;
     //fprintf(stderr,"%d opening log %s %s\n",getpid(),nFic,mode);
+    if (isCompressed(fName) || isAsync(fName) || isJournal(fName) || isTracked(fName)) {
+        if (mode[0] == 'w') {                                            /* empty file, lines gathered from now on */
+            if ((fic = fopen (fName, "wb")) == NULL) {
+                perror ("error on opening log file");
+                exit (EXIT_FAILURE);
+            }
+            fclose (fic);
+            if (logBuf != NULL) {
+                logBuf->len = 0;
+                logBuf->end = 0;
+            }
+        }
+        if ((fic = open_memstream (&lineBuf, &lineLen)) == NULL) {
+            perror ("error on opening log file");
+            exit (EXIT_FAILURE);
+        }
+        return fic;
+    }
     if ((fic = fopen (fName, mode)) == NULL) {
         perror ("error on opening log file");
         exit (EXIT_FAILURE);
@@ -46,7 +387,7 @@ static FILE *openLog(char nFic[], char mode[])
     return fic;
 }
 
-static void closeLog(FILE *fic)
+static void closeLog(char nFic[], FILE *fic)
 {
     if(fic==stderr || fic == stdout) {
          fflush(fic);
@@ -57,10 +398,149 @@ static void closeLog(FILE *fic)
         perror ("error on closing of log file");
         exit (EXIT_FAILURE);
     }
+    if (isJournal(nFic)) {
+        if (journalPut(logJournal, logSeq, lineBuf, lineLen) == -1) {
+            perror ("error on writing log file");
+            exit (EXIT_FAILURE);
+        }
+        free(lineBuf);
+        lineBuf = NULL;
+        return;
+    }
+    if (isAsync(nFic)) {
+        writeAsync(nFic, lineBuf, lineLen);
+        free(lineBuf);
+        lineBuf = NULL;
+        return;
+    }
+    if (isTracked(nFic)) {
+        writePlain(nFic, lineBuf, lineLen);
+        logBuf->end += (long long) lineLen;
+        free(lineBuf);
+        lineBuf = NULL;
+        checkRotation(nFic, false);
+        return;
+    }
+    if (!isCompressed(nFic)) {
+        checkRotation(nFic, false);                                              /* no shared buffer: file size */
+        return;
+    }
+
+    /* lines written by this call: gathered in the shared buffer, compressed when it is full */
+
+    if (logBuf == NULL)
+        appendMember(nFic, lineBuf, lineLen);
+    else {
+        if (logBuf->len + lineLen > LOGBUF)
+            flushLog(nFic);
+        if (lineLen > LOGBUF)
+            appendMember(nFic, lineBuf, lineLen);
+        else {
+            memcpy(logBuf->data + logBuf->len, lineBuf, lineLen);
+            logBuf->len += lineLen;
+        }
+    }
+    free(lineBuf);
+    lineBuf = NULL;
+}
+
+/**
+ *  \brief Setting the shared buffer of compressed logging files.
+ *
+ *  Every process writing a compressed or asynchronous logging file must set the same buffer, located in shared
+ *  memory, and write to the file only inside the critical region. Without it, every write to a compressed file is
+ *  compressed on its own and plain files are written synchronously.
+ *
+ *  \param buf pointer to the shared buffer
+ */
+
+void setLogBuffer (LOG_BUFFER *buf)
+{
+    logBuf = buf;
+    readSettings();
+}
+
+/**
+ *  \brief Setting the journal of the calling process.
+ *
+ *  Every intervening entity writing a plain logging file through journals must set its own journal, located in
+ *  shared memory, and the counter shared by all of them. Without it, the process writes to the file directly.
+ *
+ *  \param j pointer to the journal (NULL if none)
+ *  \param seq pointer to the global sequence number counter
+ */
+
+void setLogJournal (JOURNAL *j, unsigned long long *seq)
+{
+    logJournal = j;
+    logSeq = seq;
+    readSettings();
+}
+
+/**
+ *  \brief Telling whether a logging file is written through journals.
+ *
+ *  \param nFic name of the logging file
+ *
+ *  \return true, when the journal sink is selected and the file is a plain one
+ */
+
+bool logThroughJournals (char nFic[])
+{
+    readSettings();
+    return sinkJournal && (nFic != NULL) && (strlen(nFic) != 0) && !isCompressed(nFic);
+}
+
+/**
+ *  \brief Waiting for room in the journal before a critical region.
+ *
+ *  Nothing is done when the calling process does not write the logging file through its journal.
+ *
+ *  \param nFic name of the logging file
+ */
+
+void waitLogRoom (char nFic[])
+{
+    if ((nFic != NULL) && isJournal(nFic))
+        journalWait(logJournal, REGION_ROOM);
+}
+
+/**
+ *  \brief Setting the control block of the settings changed while running.
+ *
+ *  When set, the logging level is taken from the block instead of the environment.
+ *
+ *  \param c pointer to the control block, located in shared memory (NULL if none)
+ */
+
+void setLogControl (CONTROL *c)
+{
+    logControl = c;
+    readSettings();
+}
+
+/* only events are written, not the state lines */
+static bool eventsOnly(void)
+{
+    return (logControl != NULL) ? logControl->eventsOnly : levelEvents;
+}
+
+/* state of the calling entity, carried by the probes (-1 if not an intervening entity) */
+static int entityState(FULL_STAT *p_fSt)
+{
+    if (probeEntity == PILOT_ENTITY)
+        return (int) p_fSt->st.pilotStat;
+    if (probeEntity == HOSTESS_ENTITY)
+        return (int) p_fSt->st.hostessStat;
+    if ((probeEntity >= PASSENGER_ENTITY(0)) && (probeEntity < PASSENGER_ENTITY(N)))
+        return (int) p_fSt->st.passengerStat[probeEntity - PASSENGER_ENTITY(0)];
+    return -1;
 }
 
 static void printHeader(FILE *fic)
 {
+    if (eventsOnly())
+        return;
     fprintf(fic,"%3s","PT");
     fprintf(fic,"%3s","HT");
     fprintf(fic," ");
@@ -73,6 +553,8 @@ static void printHeader(FILE *fic)
     fprintf(fic,"%4s","InQ");
     fprintf(fic,"%4s","InF");
     fprintf(fic,"%4s","toB");
+    if (timeColumn)
+        fprintf(fic,"%11s","time");
 
     fprintf(fic,"\n");
 }
@@ -82,6 +564,7 @@ static void printHeader(FILE *fic)
  *
  *  The function creates the logging file and writes its header.
  *  If <tt>nFic</tt> is a null pointer or a null string, the file is created under a predefined name <em>log</em>.
+ *  An existing file is rotated when rotation is enabled.
  *
  *  The file header consists of
  *       \li a title line
@@ -94,14 +577,19 @@ void createLog (char nFic[])
 {
     FILE *fic;                                                                                      /* file descriptor */
 
+    readSettings();
+    if ((nFic != NULL) && (strlen (nFic) != 0))
+        checkRotation(nFic, true);                                   /* a previous run is kept when rotation is enabled */
     fic = openLog(nFic,"w");
+    printTitle(fic);
+    closeLog(nFic, fic);
+}
 
-    /* title line + blank line */
-
+/* title line + blank line + column header */
+static void printTitle(FILE *fic)
+{
     fprintf (fic, "%31cAir Lift - Description of the internal state\n\n", ' ');
     printHeader(fic);
-
-    closeLog(fic);
 }
 
 /**
@@ -123,6 +611,10 @@ void saveState (char nFic[], FULL_STAT *p_fSt)
 {
     FILE *fic;                                                                                      /* file descriptor */
 
+    AIRLIFT_PROBE3 (log_state, probeEntity, entityState(p_fSt), p_fSt->nFlight);
+
+    if (eventsOnly())
+        return;
     fic = openLog(nFic,"a");
 
     fprintf(fic,"%3d",p_fSt->st.pilotStat);
@@ -137,10 +629,12 @@ void saveState (char nFic[], FULL_STAT *p_fSt)
     fprintf(fic,"%4d",p_fSt->nPassInQueue);
     fprintf(fic,"%4d",p_fSt->nPassInFlight);
     fprintf(fic,"%4d",p_fSt->totalPassBoarded);
+    if (timeColumn)
+        fprintf(fic,"%11llu",elapsedTime(p_fSt));
 
     fprintf(fic,"\n");
 
-    closeLog(fic);
+    closeLog(nFic, fic);
 }
 /**
  *  \brief Writing the start of Boarding Process and header.
@@ -155,13 +649,15 @@ void saveStartBoarding (char nFic[], FULL_STAT *p_fSt)
 {
     FILE *fic;                                                                                      /* file descriptor */
 
+    AIRLIFT_PROBE3 (log_boarding, probeEntity, entityState(p_fSt), p_fSt->nFlight);
+
     fic = openLog(nFic,"a");
 
     fprintf(fic,"Flight %d : Boarding Started\n", p_fSt->nFlight);
     printHeader(fic);
 
 
-    closeLog(fic);
+    closeLog(nFic, fic);
 }
 
 /**
@@ -177,11 +673,39 @@ void savePassengerChecked (char nFic[], FULL_STAT *p_fSt)
 {
     FILE *fic;                                                                                      /* file descriptor */
 
+    AIRLIFT_PROBE3 (log_checked, probeEntity, entityState(p_fSt), p_fSt->nFlight);
+
     fic = openLog(nFic,"a");
 
     fprintf(fic,"Flight %d : Passenger %d checked\n", p_fSt->nFlight, p_fSt->passengerChecked);
 
-    closeLog(fic);
+    closeLog(nFic, fic);
+}
+
+/**
+ *  \brief Writing the settings in force, if changed since last written.
+ *
+ *  It must be called inside the critical region. If <tt>nFic</tt> is a null pointer or a null string, the line is
+ *  written to stdout
+ *
+ *  \param nFic name of the logging file
+ *  \param c pointer to the control block
+ */
+
+void saveControl (char nFic[], CONTROL *c)
+{
+    FILE *fic;                                                                                      /* file descriptor */
+
+    if (c->logged == c->version)
+        return;
+    c->logged = c->version;
+
+    fic = openLog(nFic,"a");
+
+    fprintf(fic,"Control %u : minFC %u maxFC %u maxFlight %.0f maxTravel %.0f timeScale %g log %s\n", c->version,
+            c->minFC, c->maxFC, c->maxFlight, c->maxTravel, c->timeScale, c->eventsOnly ? "events" : "full");
+
+    closeLog(nFic, fic);
 }
 
 /**
@@ -197,12 +721,14 @@ void saveFlightDeparted (char nFic[], FULL_STAT *p_fSt)
 {
     FILE *fic;                                                                                      /* file descriptor */
 
+    AIRLIFT_PROBE3 (log_departed, probeEntity, entityState(p_fSt), p_fSt->nFlight);
+
     fic = openLog(nFic,"a");
 
     fprintf(fic,"Flight %d : Departed with %d passengers\n", p_fSt->nFlight, p_fSt->nPassengersInFlight[p_fSt->nFlight-1]);
     printHeader(fic);
 
-    closeLog(fic);
+    closeLog(nFic, fic);
 }
 
 
@@ -219,12 +745,14 @@ void saveFlightArrived (char nFic[], FULL_STAT *p_fSt)
 {
     FILE *fic;                                                                                      /* file descriptor */
 
+    AIRLIFT_PROBE3 (log_arrived, probeEntity, entityState(p_fSt), p_fSt->nFlight);
+
     fic = openLog(nFic,"a");
 
     fprintf(fic,"Flight %d : Arrived \n", p_fSt->nFlight);
     printHeader(fic);
 
-    closeLog(fic);
+    closeLog(nFic, fic);
 }
 
 /**
@@ -240,12 +768,14 @@ void saveFlightReturning (char nFic[], FULL_STAT *p_fSt)
 {
     FILE *fic;                                                                                      /* file descriptor */
 
+    AIRLIFT_PROBE3 (log_returning, probeEntity, entityState(p_fSt), p_fSt->nFlight);
+
     fic = openLog(nFic,"a");
 
     fprintf(fic,"Flight %d : Returning \n", p_fSt->nFlight);
     printHeader(fic);
 
-    closeLog(fic);
+    closeLog(nFic, fic);
 }
 
 /**
@@ -260,6 +790,9 @@ void saveFlightReturning (char nFic[], FULL_STAT *p_fSt)
 void saveAirLiftResult (char nFic[], FULL_STAT *p_fSt)
 {
     FILE *fic;                                                                                      /* file descriptor */
+
+    AIRLIFT_PROBE3 (log_result, probeEntity, entityState(p_fSt), p_fSt->nFlight);
+
     fic = openLog(nFic,"a");
 
     fprintf(fic,"AirLift result\n");
@@ -270,5 +803,50 @@ void saveAirLiftResult (char nFic[], FULL_STAT *p_fSt)
         fprintf(fic,"Flight %d took %2d passengers\n", f+1, p_fSt->nPassengersInFlight[f]);
     }
 
-    closeLog(fic);
+    char *times = getenv("AIRLIFT_RESULT_TIMES");
+    if ((times != NULL) && (*times != '\0')) {
+        fprintf(fic,"AirLift took %llu us\n", p_fSt->makespan);
+        int p;
+        for(p=0; p < N; p++) {
+            fprintf(fic,"Passenger %02d waited %llu us\n", p, p_fSt->wait[p]);
+        }
+    }
+    if (p_fSt->virtualMakespan != 0)
+        fprintf(fic,"AirLift virtual makespan %llu us\n", p_fSt->virtualMakespan);
+
+    closeLog(nFic, fic);
+    flushLog(nFic);                                                   /* last lines of a compressed file */
+    closeAsync();                                                                  /* writes in flight completed */
+}
+
+static long long timeNow()
+{
+    struct timeval t;
+
+    gettimeofday(&t, NULL);
+    return (long long) t.tv_sec * 1000000 + t.tv_usec;
+}
+
+/**
+ *  \brief Marking the start of operations.
+ *
+ *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ */
+
+void startClock (FULL_STAT *p_fSt)
+{
+    p_fSt->tStart = timeNow();
+}
+
+/**
+ *  \brief Time elapsed since the start of operations.
+ *
+ *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ *
+ *  \return elapsed time in microseconds
+ */
+
+unsigned long long elapsedTime (FULL_STAT *p_fSt)
+{
+    return (unsigned long long) (timeNow() - p_fSt->tStart);
 }
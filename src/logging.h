@@ -12,7 +12,17 @@
  *     \li writing the present full state as a single line at the end of the file.
  *     \li Writing the flight arrival at the end of the file.
  *     \li Writing the flight returning at the end of the file.
- *     \li writing summary of air lift at the end of the file.
+ *     \li writing summary of air lift at the end of the file
+ *     \li measuring the time elapsed since the start of operations
+ *     \li setting the shared buffer of compressed logging files
+ *     \li setting the journal of the calling process
+ *     \li telling whether a logging file is written through journals
+ *     \li waiting for room in the journal before a critical region.
+ *
+ *  Logging files whose name ends in <tt>.gz</tt> are written compressed; <tt>AIRLIFT_LOG_ROTATE=size[:keep]</tt>
+ *  in the environment enables size-based rotation; <tt>AIRLIFT_LOG_SINK=uring</tt> writes plain logging files
+ *  asynchronously through io_uring and <tt>AIRLIFT_LOG_SINK=journal</tt> through per-entity journals merged by
+ *  sequence number; <tt>AIRLIFT_LOG_LEVEL=events</tt> leaves out the state lines.
  *
  *  \author Nuno Lau - January 2022
  */
@@ -20,6 +30,8 @@
 #ifndef LOGGING_H_
 #define LOGGING_H_
 
+#include <stdbool.h>
+
 #include "probDataStruct.h"
 
 /**
@@ -109,15 +121,106 @@ extern void saveFlightReturning (char nFic[], FULL_STAT *p_fSt);
 
 void savePassengerChecked (char nFic[], FULL_STAT *p_fSt);
 
+/**
+ *  \brief Writing the settings in force, if changed since last written.
+ *
+ *  It must be called inside the critical region. If <tt>nFic</tt> is a null pointer or a null string, the line is
+ *  written to stdout
+ *
+ *  \param nFic name of the logging file
+ *  \param c pointer to the control block
+ */
+
+extern void saveControl (char nFic[], CONTROL *c);
+
 /**
  *  \brief Writing summary of air lift at the end of the file.
  *
  *  If <tt>nFic</tt> is a null pointer or a null string, the lines are written to stdout 
  *
+ *  Besides the passengers taken by each flight, the duration of the air lift and the time each passenger
+ *  waited in queue are written when the environment variable <tt>AIRLIFT_RESULT_TIMES</tt> is set (not empty).
+ *
  *  \param nFic name of the logging file
  *  \param p_fSt pointer to the location where the full internal state of the problem is stored
  */
 
 extern void saveAirLiftResult (char nFic[], FULL_STAT *p_fSt);
 
+/**
+ *  \brief Marking the start of operations.
+ *
+ *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ */
+
+extern void startClock (FULL_STAT *p_fSt);
+
+/**
+ *  \brief Time elapsed since the start of operations.
+ *
+ *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ *
+ *  \return elapsed time in microseconds
+ */
+
+extern unsigned long long elapsedTime (FULL_STAT *p_fSt);
+
+/**
+ *  \brief Setting the shared buffer of compressed logging files.
+ *
+ *  Every process writing a compressed or asynchronous logging file must set the same buffer, located in shared
+ *  memory, and write to the file only inside the critical region. Without it, every write to a compressed file is
+ *  compressed on its own and plain files are written synchronously.
+ *
+ *  \param buf pointer to the shared buffer
+ */
+
+extern void setLogBuffer (LOG_BUFFER *buf);
+
+/**
+ *  \brief Setting the journal of the calling process.
+ *
+ *  Every intervening entity writing a plain logging file through journals must set its own journal, located in
+ *  shared memory, and the counter shared by all of them. Without it, the process writes to the file directly.
+ *
+ *  \param j pointer to the journal (NULL if none)
+ *  \param seq pointer to the global sequence number counter
+ */
+
+extern void setLogJournal (JOURNAL *j, unsigned long long *seq);
+
+/**
+ *  \brief Telling whether a logging file is written through journals.
+ *
+ *  It is when <tt>AIRLIFT_LOG_SINK</tt> is set to <tt>journal</tt> and the file is a plain one (not compressed nor
+ *  the standard output).
+ *
+ *  \param nFic name of the logging file
+ *
+ *  \return true, when the journal sink is selected and the file is a plain one
+ */
+
+extern bool logThroughJournals (char nFic[]);
+
+/**
+ *  \brief Waiting for room in the journal before a critical region.
+ *
+ *  An intervening entity writing through its journal waits for the merger, when the journal is about full, before
+ *  entering the critical region rather than inside it. Nothing is done otherwise.
+ *
+ *  \param nFic name of the logging file
+ */
+
+extern void waitLogRoom (char nFic[]);
+
+/**
+ *  \brief Setting the control block of the settings changed while running.
+ *
+ *  When set, the logging level is taken from the block instead of the environment.
+ *
+ *  \param c pointer to the control block, located in shared memory (NULL if none)
+ */
+
+extern void setLogControl (CONTROL *c);
+
 #endif /* LOGGING_H_ */
@@ -0,0 +1,76 @@
+/**
+ *  \file perturb.c (implementation file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  Schedule perturbation of stress runs.
+ *
+ *  Defined operations:
+ *     \li enabling the perturbation in an entity.
+ *
+ *  The delays are drawn from a generator of their own (xorshift), so they do not disturb the sequence of travel
+ *  and flight times drawn by the entity with <tt>random</tt>.
+ */
+
+#include <stdlib.h>
+#include <errno.h>
+#include <time.h>
+
+#include "semaphore.h"
+#include "perturb.h"
+
+/** \brief largest delay (microseconds), 0 if not enabled */
+static unsigned long maxDelay = 0;
+
+/** \brief state of the delay generator */
+static unsigned long long state;
+
+/** \brief hook previously set */
+static SEM_HOOK prevHook = NULL;
+
+static unsigned long long next (void)
+{
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+
+    return state;
+}
+
+static void hook (unsigned int point, unsigned int sindex)
+{
+    unsigned long long r = next (), us;
+    struct timespec d;
+
+    if (prevHook != NULL)
+        prevHook (point, sindex);
+    if (r & 1)                                                                            /* half of them delayed */
+        return;
+    us = (r >> 1) % (maxDelay + 1);
+    d.tv_sec = (time_t) (us / 1000000);
+    d.tv_nsec = (long) (us % 1000000) * 1000;
+    while ((nanosleep (&d, &d) == -1) && (errno == EINTR))
+        ;
+}
+
+/**
+ *  \brief Enabling the perturbation in the calling entity.
+ *
+ *  \param entity entity id
+ */
+
+void perturbOpen (unsigned int entity)
+{
+    char *env = getenv ("AIRLIFT_PERTURB"), *end;
+    unsigned long seed;
+
+    if ((env == NULL) || (*env == '\0'))
+        return;
+    seed = strtoul (env, &end, 10);
+    maxDelay = ((*end == ':') && (strtoul (end + 1, NULL, 10) > 0)) ? strtoul (end + 1, NULL, 10) : 100;
+    state = (seed + 1) * 0x9e3779b97f4a7c15ULL + entity;
+    if (state == 0)
+        state = 1;
+    srandom ((unsigned int) (seed * 1000003UL + entity));
+    prevHook = semSetHook (hook);
+}
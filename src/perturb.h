@@ -0,0 +1,33 @@
+/**
+ *  \file perturb.h (interface file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  Schedule perturbation of stress runs.
+ *
+ *  When the environment variable <tt>AIRLIFT_PERTURB</tt> is set to <tt>seed[:max]</tt>, every intervening entity
+ *  sleeps for a random time of up to <tt>max</tt> microseconds (100 by default) before half of its <em>down</em>
+ *  and <em>up</em> operations and after half of its successful <em>down</em> ones, so inside and around every
+ *  critical region, driving the run through interleavings the plain runs hardly ever see. The delays, and the
+ *  travel and flight times, are drawn from random sequences determined by the seed and the entity, so the same
+ *  seed replays the same perturbation.
+ *
+ *  Defined operations:
+ *     \li enabling the perturbation in an entity.
+ */
+
+#ifndef PERTURB_H_
+#define PERTURB_H_
+
+/**
+ *  \brief Enabling the perturbation in the calling entity.
+ *
+ *  Nothing is done when it is not enabled. The random generator of the entity is seeded, so this must be called
+ *  after any other seeding.
+ *
+ *  \param entity entity id
+ */
+
+extern void perturbOpen (unsigned int entity);
+
+#endif /* PERTURB_H_ */
@@ -0,0 +1,241 @@
+/**
+ *  \file phaseCounters.c (implementation file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  Performance counters per lifecycle phase.
+ *
+ *  Defined operations:
+ *     \li selecting the events counted
+ *     \li opening the counters of an entity
+ *     \li marking the start and the end of a phase
+ *     \li writing the report
+ *     \li name of a phase.
+ *
+ *  The phase boundaries are also the points where a virtual speedup (causal.c) accounts for its target and inserts
+ *  the delays owed by the process, outside the counts.
+ *
+ *  The counters of a process form a single group, counting the process only, on any CPU. Kernel events are
+ *  counted where allowed, so the context switches are seen; otherwise (<tt>perf_event_paranoid</tt>) only user
+ *  space is. The totals of a phase are updated with atomic additions, since the passengers go through their phases
+ *  concurrently, outside the critical region.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+#include "probConst.h"
+#include "probDataStruct.h"
+#include "phaseCounters.h"
+#include "causal.h"
+
+/** \brief counters of this process (-1 if none) */
+static int fd[NCOUNTERS] = { -1, -1, -1, -1 };
+
+/** \brief phase totals */
+static PHASE_STAT *phases = NULL;
+
+/** \brief counts at the start of the phase */
+static unsigned long long start[NCOUNTERS];
+
+/** \brief events of each kind: type and configuration */
+static const struct { unsigned int type; unsigned long long config; const char *name; } event[2][NCOUNTERS] = {
+    { { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, "instructions" },
+      { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, "cycles" },
+      { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, "cache-misses" },
+      { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES, "ctx-switches" } },
+    { { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK, "task-clock" },
+      { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES, "ctx-switches" },
+      { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS, "page-faults" },
+      { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_MIGRATIONS, "cpu-migrations" } }
+};
+
+static const char *phaseNames[NPHASES] = {
+    "flight", "signalReadyForBoarding", "waitUntilReadyToFlight", "dropPassengersAtTarget", "waitForNextFlight",
+    "waitForPassenger", "checkPassport", "signalReadyToFlight", "travelToAirport", "waitInQueue",
+    "waitUntilDestination"
+};
+
+static int openEvent (unsigned int type, unsigned long long config, int group)
+{
+    struct perf_event_attr attr;
+    int f;
+
+    memset (&attr, 0, sizeof (attr));
+    attr.size = sizeof (attr);
+    attr.type = type;
+    attr.config = config;
+    attr.read_format = PERF_FORMAT_GROUP;
+    attr.exclude_hv = 1;
+    if ((f = (int) syscall (__NR_perf_event_open, &attr, 0, -1, group, PERF_FLAG_FD_CLOEXEC)) != -1)
+        return f;
+    attr.exclude_kernel = 1;                                                                 /* user space only */
+
+    return (int) syscall (__NR_perf_event_open, &attr, 0, -1, group, PERF_FLAG_FD_CLOEXEC);
+}
+
+static void closeGroup (void)
+{
+    int c;
+
+    for (c = NCOUNTERS - 1; c >= 0; c--)
+        if (fd[c] != -1) {
+            close (fd[c]);
+            fd[c] = -1;
+        }
+}
+
+/* group of counters of a kind of events, false if one cannot be opened */
+static bool openGroup (unsigned int events)
+{
+    int c;
+
+    for (c = 0; c < NCOUNTERS; c++)
+        if ((fd[c] = openEvent (event[events - 1][c].type, event[events - 1][c].config,
+                                (c == 0) ? -1 : fd[0])) == -1) {
+            closeGroup ();
+            return false;
+        }
+
+    return true;
+}
+
+/* counts of the group */
+static bool readGroup (unsigned long long val[])
+{
+    unsigned long long buf[1 + NCOUNTERS];
+
+    if ((read (fd[0], buf, sizeof (buf)) != (ssize_t) sizeof (buf)) || (buf[0] != NCOUNTERS))
+        return false;
+    memcpy (val, buf + 1, NCOUNTERS * sizeof (unsigned long long));
+
+    return true;
+}
+
+/**
+ *  \brief Selecting the events counted.
+ *
+ *  \return \c PHASE_HARDWARE or \c PHASE_SOFTWARE
+ *  \return \c 0, when counting is not enabled or no counter can be opened
+ */
+
+unsigned int phaseSelect (void)
+{
+    char *env = getenv ("AIRLIFT_PERF");
+    unsigned int events;
+
+    if ((env == NULL) || (*env == '\0'))
+        return 0;
+    for (events = PHASE_HARDWARE; events <= PHASE_SOFTWARE; events++)
+        if (openGroup (events)) {
+            closeGroup ();
+            return events;
+        }
+
+    return 0;
+}
+
+/**
+ *  \brief Opening the counters of the calling entity.
+ *
+ *  \param ph pointer to the phase totals, located in shared memory
+ *  \param events events counted (\c 0 when not enabled)
+ */
+
+void phaseOpen (PHASE_STAT *ph, unsigned int events)
+{
+    if ((events != PHASE_HARDWARE) && (events != PHASE_SOFTWARE))
+        return;
+    if (openGroup (events))
+        phases = ph;
+}
+
+/**
+ *  \brief Marking the start of a phase.
+ */
+
+void phaseBegin (void)
+{
+    causalBegin ();
+    if ((phases != NULL) && !readGroup (start))
+        phases = NULL;                                                                     /* counting given up */
+}
+
+/**
+ *  \brief Marking the end of a phase, its counts being added to its totals.
+ *
+ *  \param phase phase
+ */
+
+void phaseEnd (unsigned int phase)
+{
+    unsigned long long val[NCOUNTERS];
+    int c;
+
+    if ((phases != NULL) && (phase < NPHASES)) {
+        if (readGroup (val)) {
+            __atomic_fetch_add (&phases[phase].calls, 1, __ATOMIC_RELAXED);
+            for (c = 0; c < NCOUNTERS; c++)
+                __atomic_fetch_add (&phases[phase].count[c], val[c] - start[c], __ATOMIC_RELAXED);
+        }
+        else phases = NULL;
+    }
+    causalEnd (phase);
+}
+
+/**
+ *  \brief Writing the report.
+ *
+ *  \param ph pointer to the phase totals
+ *  \param events events counted (nothing is written if \c 0)
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int phaseReport (PHASE_STAT *ph, unsigned int events)
+{
+    char *env = getenv ("AIRLIFT_PERF");
+    FILE *fic;
+    int p, c;
+
+    if (((events != PHASE_HARDWARE) && (events != PHASE_SOFTWARE)) || (env == NULL) || (*env == '\0'))
+        return 0;
+    if ((fic = fopen (env, "w")) == NULL)
+        return -1;
+    fprintf (fic, "# AirLift counters per lifecycle phase (%s events): totals and means per execution\n",
+             (events == PHASE_HARDWARE) ? "hardware" : "software");
+    fprintf (fic, "%-24s %8s", "phase", "calls");
+    for (c = 0; c < NCOUNTERS; c++)
+        fprintf (fic, " %14s %14s", event[events - 1][c].name, "/call");
+    fprintf (fic, "\n");
+    for (p = 0; p < NPHASES; p++) {
+        fprintf (fic, "%-24s %8llu", phaseNames[p], ph[p].calls);
+        for (c = 0; c < NCOUNTERS; c++)
+            fprintf (fic, " %14llu %14.1f", ph[p].count[c],
+                     (ph[p].calls == 0) ? 0.0 : (double) ph[p].count[c] / ph[p].calls);
+        fprintf (fic, "\n");
+    }
+    if (fclose (fic) == EOF)
+        return -1;
+
+    return 0;
+}
+
+/**
+ *  \brief Name of a phase.
+ *
+ *  \param phase phase
+ *
+ *  \return name of the lifecycle function of the phase, NULL if it does not exist
+ */
+
+const char *phaseName (unsigned int phase)
+{
+    return (phase < NPHASES) ? phaseNames[phase] : NULL;
+}
@@ -0,0 +1,122 @@
+/**
+ *  \file phaseCounters.h (interface file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  Performance counters per lifecycle phase.
+ *
+ *  When the environment variable <tt>AIRLIFT_PERF</tt> is set to a file name, every intervening entity counts,
+ *  through <tt>perf_event_open</tt>, the events of each of its lifecycle phases (the execution of the lifecycle
+ *  function, blocking included) and adds them to the totals of the phase in shared memory; the generator writes
+ *  the totals and the means per execution to the file once the entities are over.
+ *
+ *  Events counted, as a single group read in one system call at each phase boundary:
+ *     \li hardware: instructions, cycles, cache misses and context switches
+ *     \li software, when the hardware counters are not exposed (virtual machines, containers): task clock (ns),
+ *         context switches, page faults and CPU migrations.
+ *
+ *  Defined operations:
+ *     \li selecting the events counted
+ *     \li opening the counters of an entity
+ *     \li marking the start and the end of a phase
+ *     \li writing the report
+ *     \li name of a phase.
+ */
+
+#ifndef PHASECOUNTERS_H_
+#define PHASECOUNTERS_H_
+
+#include "probConst.h"
+#include "probDataStruct.h"
+
+/* events counted */
+
+/** \brief hardware events */
+#define  PHASE_HARDWARE               1
+/** \brief software events */
+#define  PHASE_SOFTWARE               2
+
+/* lifecycle phases */
+
+/** \brief pilot flying, either way */
+#define  PHASE_FLIGHT                 0
+/** \brief pilot signaling the start of boarding */
+#define  PHASE_SIGNALREADYFORBOARDING 1
+/** \brief pilot waiting for boarding to complete */
+#define  PHASE_WAITUNTILREADYTOFLIGHT 2
+/** \brief pilot dropping the passengers */
+#define  PHASE_DROPPASSENGERS         3
+/** \brief hostess waiting for the next flight */
+#define  PHASE_WAITFORNEXTFLIGHT      4
+/** \brief hostess waiting for a passenger */
+#define  PHASE_WAITFORPASSENGER       5
+/** \brief hostess checking a passport */
+#define  PHASE_CHECKPASSPORT          6
+/** \brief hostess signaling the plane is ready to flight */
+#define  PHASE_SIGNALREADYTOFLIGHT    7
+/** \brief passenger travelling to the airport */
+#define  PHASE_TRAVELTOAIRPORT        8
+/** \brief passenger waiting in the queue */
+#define  PHASE_WAITINQUEUE            9
+/** \brief passenger flying to the destination */
+#define  PHASE_WAITUNTILDESTINATION   10
+
+/**
+ *  \brief Selecting the events counted.
+ *
+ *  Hardware events when their counters can be opened, software events otherwise.
+ *
+ *  \return \c PHASE_HARDWARE or \c PHASE_SOFTWARE
+ *  \return \c 0, when counting is not enabled or no counter can be opened
+ */
+
+extern unsigned int phaseSelect (void);
+
+/**
+ *  \brief Opening the counters of the calling entity.
+ *
+ *  Nothing is counted by the process when the counters cannot be opened.
+ *
+ *  \param ph pointer to the phase totals, located in shared memory
+ *  \param events events counted (\c 0 when not enabled)
+ */
+
+extern void phaseOpen (PHASE_STAT *ph, unsigned int events);
+
+/**
+ *  \brief Marking the start of a phase.
+ */
+
+extern void phaseBegin (void);
+
+/**
+ *  \brief Marking the end of a phase, its counts being added to its totals.
+ *
+ *  \param phase phase
+ */
+
+extern void phaseEnd (unsigned int phase);
+
+/**
+ *  \brief Writing the report.
+ *
+ *  \param ph pointer to the phase totals
+ *  \param events events counted (nothing is written if \c 0)
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+extern int phaseReport (PHASE_STAT *ph, unsigned int events);
+
+/**
+ *  \brief Name of a phase.
+ *
+ *  \param phase phase
+ *
+ *  \return name of the lifecycle function of the phase, NULL if it does not exist
+ */
+
+extern const char *phaseName (unsigned int phase);
+
+#endif /* PHASECOUNTERS_H_ */
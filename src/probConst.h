@@ -11,19 +11,27 @@
 #ifndef PROBCONST_H_
 #define PROBCONST_H_
 
-/* Generic parameters */
+/* Generic parameters (the problem size may be set on the command line of the compiler, -DN=...) */
 
+#ifndef N
 /** \brief number of passengers */
 #define  N        5
+#endif
 
+#ifndef MINFC
 /** \brief min flight capacity */
 #define  MINFC    1
+#endif
 
+#ifndef MAXFC
 /** \brief max flight capacity */
 #define  MAXFC    1
+#endif
 
+#ifndef MAXNF
 /** \brief max flight capacity */
 #define  MAXNF    5
+#endif
 
 /** \brief max flight capacity */
 #define  MAXTRAVEL   20000.0 
@@ -31,6 +39,33 @@
 /** \brief max flight capacity */
 #define  MAXFLIGHT   1000.0 
 
+/** \brief size of the shared buffer of a compressed logging file (bytes) */
+#define  LOGBUF      65536
+
+/** \brief size of the journal ring of each intervening entity (bytes, a multiple of 8) */
+#define  JOURNAL_SIZE  16384
+
+/** \brief number of lifecycle phases of the intervening entities with performance counters */
+#define  NPHASES     11
+
+/** \brief number of performance counters per phase */
+#define  NCOUNTERS   4
+
+/** \brief semaphore locations whose wakeups hand the delays paid by the waker to the woken entity (causal.c) */
+#define  NCREDITS    16
+
+/** \brief maximum number of synchronization events of a recorded schedule */
+#define  SCHEDULE_SIZE  65536
+
+/** \brief number of intervening entity roles with latency sketches: pilot, hostess and passenger */
+#define  NROLES      3
+
+/** \brief number of latency metrics sketched per role */
+#define  NMETRICS    5
+
+/** \brief number of buckets of a latency sketch: 64 exact values, then 16 per power of two up to 2^32 */
+#define  SKETCH_BUCKETS  480
+
 /* Pilot state constants */
 
 /** \brief pilot flying to starting airport */
@@ -54,7 +54,169 @@ typedef struct
     /** \brief passenger id of last passenger to check passport */
     int passengerChecked;
 
+    /** \brief start of operations (microseconds since the epoch) */
+    long long tStart;
+    /** \brief time each passenger waited in queue (microseconds) */
+    unsigned long long wait[N];
+    /** \brief duration of the air lift (microseconds) */
+    unsigned long long makespan;
+    /** \brief duration of the air lift less the delays inserted by a virtual speedup (microseconds, 0 if none) */
+    unsigned long long virtualMakespan;
+
 } FULL_STAT;
 
+/**
+ *  \brief Definition of <em>logging buffer</em> data type.
+ *
+ *  Lines of a compressed logging file, shared by all processes, waiting to be compressed, and end of an
+ *  asynchronously written logging file or size of a rotated one.
+ */
+typedef struct
+{ /** \brief end of the logging file: offset of the next asynchronous write, size for the rotation */
+    long long end;
+    /** \brief number of bytes in use */
+    unsigned int len;
+    /** \brief buffered lines */
+    char data[LOGBUF];
+
+} LOG_BUFFER;
+
+/**
+ *  \brief Definition of <em>phase counters</em> data type.
+ *
+ *  Performance counters accumulated over every execution of a lifecycle phase, by every entity going through it.
+ */
+typedef struct
+{ /** \brief number of executions */
+    unsigned long long calls;
+    /** \brief counts of the events measured */
+    unsigned long long count[NCOUNTERS];
+
+} PHASE_STAT;
+
+/**
+ *  \brief Definition of <em>virtual speedup</em> data type.
+ *
+ *  Causal profiling: every execution of the target (a lifecycle phase or the critical region) is virtually sped up
+ *  by delaying all the other entities by a fraction of its duration.
+ */
+typedef struct
+{ /** \brief virtual speedup enabled */
+    bool enabled;
+    /** \brief target: lifecycle phase, or <tt>NPHASES</tt> for the critical region */
+    unsigned int target;
+    /** \brief speedup of the target (percent of its duration) */
+    unsigned int speedup;
+    /** \brief semaphore location of the critical region protection */
+    unsigned int mutex;
+    /** \brief total delay inserted (nanoseconds) */
+    unsigned long long delay;
+    /** \brief per semaphore location, delay paid by the entity of the last <em>up</em> and time it was done */
+    unsigned long long credit[NCREDITS], tUp[NCREDITS];
+
+} CAUSAL;
+
+/**
+ *  \brief Definition of <em>synchronization schedule</em> data type.
+ *
+ *  Order in which the intervening entities returned from their <em>down</em> operations, each event being the
+ *  entity id (upper 16 bits) and the semaphore location (lower 16 bits), recorded in a run or enforced in another.
+ */
+typedef struct
+{ /** \brief mode: 0 (disabled), <tt>SCHEDULE_RECORD</tt> or <tt>SCHEDULE_REPLAY</tt> */
+    unsigned int mode;
+    /** \brief number of events to replay */
+    unsigned int len;
+    /** \brief replay given up, the run having diverged from the schedule */
+    bool diverged;
+    /** \brief position of the next event: recorded or replayed */
+    unsigned int next __attribute__ ((aligned (64)));
+    /** \brief events */
+    unsigned int event[SCHEDULE_SIZE] __attribute__ ((aligned (64)));
+
+} SCHEDULE;
+
+/**
+ *  \brief Definition of <em>latency sketch</em> data type.
+ *
+ *  Streaming quantile sketch of a latency: a log-linear histogram, values below 64 having a bucket of their own and
+ *  every power of two above being split in 16 buckets, so quantiles are accurate to 1/32 of their order of magnitude
+ *  in a fixed size, whatever the number of samples. Sketches are merged by adding them up.
+ */
+typedef struct
+{ /** \brief number of samples */
+    unsigned long long n;
+    /** \brief sum of the samples */
+    unsigned long long sum;
+    /** \brief smallest sample (<tt>UINT_MAX</tt> if none) */
+    unsigned int min;
+    /** \brief largest sample */
+    unsigned int max;
+    /** \brief samples per bucket */
+    unsigned int bucket[SKETCH_BUCKETS];
+
+} SKETCH;
+
+/**
+ *  \brief Definition of <em>latency sketches</em> data type.
+ *
+ *  One sketch per role of the intervening entities and per metric, updated without locks by every entity.
+ */
+typedef struct
+{ /** \brief sketches enabled */
+    bool enabled;
+    /** \brief semaphore location of the critical region protection */
+    unsigned int mutex;
+    /** \brief time of the last takeoff (microseconds since the start) */
+    unsigned long long tTakeoff;
+    /** \brief sketches */
+    SKETCH sketch[NROLES][NMETRICS];
+
+} SKETCHES;
+
+/**
+ *  \brief Definition of <em>control block</em> data type.
+ *
+ *  Capacity rules, flight and travel times and logging level in force, initialized from the compile-time constants
+ *  and changed while a run is going by <tt>airliftctl</tt>, inside the critical region. Every change increments the
+ *  version, which is written to the logging file by the next intervening entity reading the block.
+ */
+typedef struct
+{ /** \brief version of the settings (0: compile-time constants) */
+    unsigned int version;
+    /** \brief version last written to the logging file */
+    unsigned int logged;
+    /** \brief minimum number of passengers in a flight */
+    unsigned int minFC;
+    /** \brief maximum number of passengers in a flight */
+    unsigned int maxFC;
+    /** \brief maximum flight time (microseconds) */
+    double maxFlight;
+    /** \brief maximum travel time of a passenger to the airport (microseconds) */
+    double maxTravel;
+    /** \brief factor applied to the flight and travel times */
+    double timeScale;
+    /** \brief only events are logged, not the state lines */
+    bool eventsOnly;
+
+} CONTROL;
+
+/**
+ *  \brief Definition of <em>journal</em> data type.
+ *
+ *  Single producer ring of the logging records of one intervening entity, each record being its global sequence
+ *  number, its length and its lines. The positions only grow, the producer and the consumer positions lying in
+ *  separate cache lines.
+ */
+typedef struct
+{ /** \brief consumer position (bytes read) */
+    unsigned long long head __attribute__ ((aligned (64)));
+    /** \brief producer position (bytes written) */
+    unsigned long long tail __attribute__ ((aligned (64)));
+    /** \brief records */
+    char data[JOURNAL_SIZE] __attribute__ ((aligned (64)));
+
+} JOURNAL;
+
 
 #endif /* PROBDATASTRUCT_H_ */
@@ -11,6 +11,12 @@
  *  Upon execution, one parameter is requested:
  *    \li name of the logging file.
  *
+ *  When the environment variable <tt>AIRLIFT_FUSED</tt> is set (not empty), a single gate controller process runs
+ *  the life cycles of both the pilot and the hostess, instead of a process for each.
+ *
+ *  The capacity rules, the flight and travel times and the logging level may be changed while the run is going by
+ *  <tt>airliftctl</tt>, through the control block of the shared memory region.
+ *
  *  \author Nuno Lau - January 2022
  */
 
@@ -22,6 +28,7 @@
 #include <sys/types.h>
 #include <sys/ipc.h>
 #include <string.h>
+#include <errno.h>
 #include <math.h>
 
 #include "probConst.h"
@@ -30,6 +37,14 @@
 #include "sharedDataSync.h"
 #include "semaphore.h"
 #include "sharedMemory.h"
+#include "sampler.h"
+#include "journal.h"
+#include "phaseCounters.h"
+#include "causal.h"
+#include "schedule.h"
+#include "arrivals.h"
+#include "sketch.h"
+#include "control.h"
 
 /** \brief name of pilot process */
 #define   PILOT         "./pilot"
@@ -40,6 +55,9 @@
 /** \brief name of passenger process */
 #define   PASSENGER     "./passenger"
 
+/** \brief name of gate controller process (pilot and hostess fused) */
+#define   CONTROLLER    "./controller"
+
 /**
  *  \brief Main program.
  *
@@ -55,14 +73,21 @@ int main (int argc, char *argv[])
         semgid;                                                                     /* semaphore set access identifier */
     unsigned int  m;                                                                             /* counting variables */
     SHARED_DATA *sh;                                                                /* pointer to shared memory region */
+    pid_t pidSM;                                                                         /* sampler process identifier */
+    pid_t pidMG;                                                                          /* merger process identifier */
+    pid_t pidAG;                                                               /* arrival generator process identifier */
+    CAUSAL causal;                                                                 /* virtual speedup of causal profiling */
     int pidPT,                                                                             /* pilot process identifier */
         pidHT,                                                                     /* hostess process identifier array */
+        pidCT,                                                                   /* gate controller process identifier */
         pidPG[N];                                                             /* passengers processes identifier array */
     int key;                                                           /*access key to shared memory and semaphore set */
     char num[2][12];                                                     /* numeric value conversion (up to 10 digits) */
     int status,                                                                                    /* execution status */
         info;                                                                                               /* info id */
     int p;
+    char *fused = getenv ("AIRLIFT_FUSED");                                       /* pilot and hostess fused, when set */
+    unsigned int nEntities = ((fused != NULL) && (*fused != '\0')) ? N + 1 : N + 2;                /* entity processes */
 
     /* getting log file name */
     if(argc==2) {
@@ -78,6 +103,13 @@ int main (int argc, char *argv[])
     }
     sprintf (num[1], "%d", key);
 
+    /* virtual speedup of causal profiling, when enabled */
+
+    if (causalSelect (&causal, MUTEX) == -1) {
+        perror ("error on the virtual speedup target (AIRLIFT_CAUSAL)");
+        exit (EXIT_FAILURE);
+    }
+
     /* creating and initializing the shared memory region and the log file */
 
     if ((shmid = shmemCreate (key, sizeof (SHARED_DATA))) == -1) { 
@@ -88,6 +120,7 @@ int main (int argc, char *argv[])
         perror ("error on mapping the shared region on the process address space");
         exit (EXIT_FAILURE);
     }
+    setLogBuffer (&sh->logBuf);                                               /* shared buffer of a compressed log */
 
     srandom ((unsigned int) getpid ());                                                      /* initialize random generator */
 
@@ -106,7 +139,10 @@ int main (int argc, char *argv[])
 
     /* initialize problem internal status */
 
+    controlSelect (&sh->control);                                     /* settings changed while running, by airliftctl */
+    setLogControl (&sh->control);                                             /* logging level taken from the settings */
     createLog (nFic);                                                                             /* log file creation */
+    sh->phaseEvents = phaseSelect ();                                 /* performance counters per phase, when enabled */
 
     /* initialize semaphore ids */
 
@@ -118,11 +154,25 @@ int main (int argc, char *argv[])
     sh->readyToFlight = READYTOFLIGHT;                                           
     sh->idShown = IDSHOWN;                                                      
     sh->planeEmpty = PLANEEMPTY;                                                      
+    sh->causal = causal;                                                          /* virtual speedup, when enabled */
+    arrivalSelect (sh);                                                            /* arrival generator, when enabled */
+    sketchSelect (&sh->sketches, MUTEX);                                         /* latency sketches, when enabled */
+    if (scheduleSelect (&sh->schedule) == -1) {                         /* schedule record or replay, when enabled */
+        perror ("error on the synchronization schedule (AIRLIFT_SCHEDULE)");
+        shmemDettach (sh);
+        shmemDestroy (shmid);
+        exit (EXIT_FAILURE);
+    }
 
     /* creating and initializing the semaphore set */
 
-    if ((semgid = semCreate (key, SEM_NU)) == -1) { 
-        perror ("error on creating the semaphore set");
+    if ((semgid = semCreate (key, SEM_NU + N)) == -1) {                       /* with the release of each passenger */
+        if (errno == ENOSPC)
+            fprintf (stderr, "%d semaphores exceed the kernel limits on semaphores per set (SEMMSL), sets (SEMMNI) "
+                             "or semaphores (SEMMNS): see /proc/sys/kernel/sem\n", SEM_NU + N + 1);
+        else perror ("error on creating the semaphore set");
+        shmemDettach (sh);
+        shmemDestroy (shmid);
         exit (EXIT_FAILURE);
     }
     if (semUp (semgid, sh->mutex) == -1) {                                      /* enabling access to critical region */
@@ -147,35 +197,65 @@ int main (int argc, char *argv[])
             }
     }
 
-    strcpy (nFicErr + 6, "HT");
-    if ((pidHT = fork ()) < 0)  {                                                               /* hostess process */
-        perror ("error on the fork operation for the hostess");
-        exit (EXIT_FAILURE);
+    if (nEntities == N + 1) {                                                               /* gate controller process */
+        strcpy (nFicErr + 6, "CT");
+        if ((pidCT = fork ()) < 0) {
+            perror ("error on the fork operation for the gate controller");
+            exit (EXIT_FAILURE);
+        }
+        if (pidCT == 0)
+            if (execl (CONTROLLER, CONTROLLER, nFic, num[1], nFicErr, NULL) < 0) {
+                perror ("error on the generation of the gate controller process");
+                exit (EXIT_FAILURE);
+            }
     }
-    if (pidHT == 0) {
-        if (execl (HOSTESS, HOSTESS, nFic, num[1], nFicErr, NULL) < 0) {
-            perror ("error on the generation of the hostess process");
+    else {
+        strcpy (nFicErr + 6, "HT");
+        if ((pidHT = fork ()) < 0)  {                                                               /* hostess process */
+            perror ("error on the fork operation for the hostess");
+            exit (EXIT_FAILURE);
+        }
+        if (pidHT == 0) {
+            if (execl (HOSTESS, HOSTESS, nFic, num[1], nFicErr, NULL) < 0) {
+                perror ("error on the generation of the hostess process");
+                exit (EXIT_FAILURE);
+            }
+        }
+
+        strcpy (nFicErr + 6, "PT");
+        if ((pidPT = fork ()) < 0) {                                                                  /* pilot process */
+            perror ("error on the fork operation for the pilot");
             exit (EXIT_FAILURE);
         }
+        if (pidPT == 0)
+            if (execl (PILOT, PILOT, nFic, num[1], nFicErr, NULL) < 0) { 
+                perror ("error on the generation of the referee process");
+                exit (EXIT_FAILURE);
+            }
     }
 
-    strcpy (nFicErr + 6, "PT");
-    if ((pidPT = fork ()) < 0) {                                                                   /* pilot process */
-        perror ("error on the fork operation for the pilot");
+    /* merging the journals of the intervening entities, when enabled */
+
+    if ((pidMG = startMerger (sh, nFic)) == -1) {
+        perror ("error on the fork operation for the merger");
         exit (EXIT_FAILURE);
     }
-    if (pidPT == 0)
-        if (execl (PILOT, PILOT, nFic, num[1], nFicErr, NULL) < 0) { 
-            perror ("error on the generation of the referee process");
-            exit (EXIT_FAILURE);
-        }
 
     /* signaling start of operations */
 
+    startClock (&sh->fSt);
     if (semSignal (semgid) == -1) {
         perror ("error on signaling start of operations");
         exit (EXIT_FAILURE);
     }
+    if ((pidSM = startSampler (sh, semgid)) == -1) {                            /* state sampler, when enabled */
+        perror ("error on the fork operation for the sampler");
+        exit (EXIT_FAILURE);
+    }
+    if ((pidAG = startArrivals (sh, semgid)) == -1) {                       /* arrival generator, when enabled */
+        perror ("error on the fork operation for the arrival generator");
+        exit (EXIT_FAILURE);
+    }
 
     /* waiting for the termination of the intervening entities processes */
 
@@ -186,10 +266,39 @@ int main (int argc, char *argv[])
         { perror ("error on waiting for an intervening process");
             exit (EXIT_FAILURE);
         }
-        m += 1;
-    } while (m < N+2);
+        if ((info == pidAG) && (!WIFEXITED (status) || (WEXITSTATUS (status) != EXIT_SUCCESS))) {
+            fprintf (stderr, "error on the arrival generator\n");
+            exit (EXIT_FAILURE);
+        }
+        if ((info != pidSM) && (info != pidMG) && (info != pidAG))
+            m += 1;
+    } while (m < nEntities);
+    if (stopSampler (sh, pidSM) == -1) {
+        perror ("error on the termination of the sampler");
+        exit (EXIT_FAILURE);
+    }
 
+    sh->fSt.makespan = elapsedTime (&sh->fSt);
+    sh->fSt.virtualMakespan = causalMakespan (&sh->causal, sh->fSt.makespan);
+    if (stopMerger (sh, pidMG) == -1) {                                       /* every journal record written */
+        perror ("error on the termination of the merger");
+        exit (EXIT_FAILURE);
+    }
     saveAirLiftResult(nFic,&sh->fSt);
+    if (scheduleSave (&sh->schedule) == -1) {
+        perror ("error on saving the synchronization schedule");
+        exit (EXIT_FAILURE);
+    }
+    if (sh->schedule.diverged)
+        fprintf (stderr, "the run diverged from the synchronization schedule replayed\n");
+    if (phaseReport (sh->phase, sh->phaseEvents) == -1) {
+        perror ("error on writing the performance counters report");
+        exit (EXIT_FAILURE);
+    }
+    if (sketchReport (&sh->sketches) == -1) {                                     /* merged with the previous runs */
+        perror ("error on writing the latency sketches (AIRLIFT_SKETCH)");
+        exit (EXIT_FAILURE);
+    }
 
     /* destruction of semaphore set and shared region */
 
@@ -0,0 +1,99 @@
+/**
+ *  \file probes.h (interface file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  Static tracepoints (USDT, provider <tt>airlift</tt>).
+ *
+ *  Every probe site is a single <tt>nop</tt> instruction plus an ELF note (<tt>.note.stapsdt</tt>) describing the
+ *  location of its arguments, so it costs nothing when not traced; bpftrace, perf or SystemTap attach to it by name,
+ *  e.g. <tt>bpftrace -e 'usdt:./hostess:airlift:sem_down_return { ... }'</tt> or <tt>perf probe -x ./pilot
+ *  sdt_airlift:flight</tt> (after <tt>perf buildid-cache --add ./pilot</tt>).
+ *
+ *  Probes (every argument a signed 32 bit integer):
+ *     \li <tt>sem_down(entity, sindex)</tt>, <tt>sem_down_return(entity, sindex)</tt>, <tt>sem_up(entity, sindex)</tt>:
+ *         semaphore operations, the wakeup latency of a blocked entity being the time from a <tt>sem_up</tt> to
+ *         the <tt>sem_down_return</tt> on the same semaphore
+ *     \li one probe per lifecycle function of the intervening entities, named after it (<tt>flight</tt>,
+ *         <tt>checkPassport</tt>, <tt>waitInQueue</tt>, ...), fired at each state change: <tt>(entity, state,
+ *         flight)</tt>
+ *     \li one probe per logging operation (<tt>log_state</tt>, <tt>log_boarding</tt>, <tt>log_checked</tt>,
+ *         <tt>log_departed</tt>, <tt>log_arrived</tt>, <tt>log_returning</tt>, <tt>log_result</tt>): <tt>(entity,
+ *         state, flight)</tt>, the state being the one of the calling entity.
+ *
+ *  The entity id is 0 for the pilot, 1 for the hostess and 2 + <tt>p</tt> for passenger <tt>p</tt>, -1 for the
+ *  generator.
+ *
+ *  Where <tt>sys/sdt.h</tt> is available its macros are used; otherwise the same notes are emitted directly on
+ *  x86-64 ELF targets, and the probes are left out elsewhere.
+ */
+
+#ifndef PROBES_H_
+#define PROBES_H_
+
+/** \brief entity id carried by the probes of this process (-1 if not an intervening entity) */
+extern int probeEntity;
+
+#if defined (__has_include)
+#if __has_include (<sys/sdt.h>)
+#define  AIRLIFT_SDT_H
+#endif
+#endif
+
+#if defined (AIRLIFT_SDT_H)
+
+#include <sys/sdt.h>
+
+/** \brief probe with two arguments */
+#define  AIRLIFT_PROBE2(name, a1, a2)          DTRACE_PROBE2 (airlift, name, (int) (a1), (int) (a2))
+
+/** \brief probe with three arguments */
+#define  AIRLIFT_PROBE3(name, a1, a2, a3)      DTRACE_PROBE3 (airlift, name, (int) (a1), (int) (a2), (int) (a3))
+
+#elif defined (__GNUC__) && defined (__ELF__) && defined (__x86_64__)
+
+/* nop at the probe site and its stapsdt note: address, base, semaphore (none), provider, name, arguments */
+#define  AIRLIFT_SDT_NOTE(name, args)                                                                             \
+    "990: nop\n"                                                                                                   \
+    "     .pushsection .note.stapsdt,\"?\",\"note\"\n"                                                             \
+    "     .balign 4\n"                                                                                             \
+    "     .4byte 992f-991f, 994f-993f, 3\n"                                                                        \
+    "991: .asciz \"stapsdt\"\n"                                                                                    \
+    "992: .balign 4\n"                                                                                             \
+    "993: .8byte 990b\n"                                                                                           \
+    "     .8byte _.stapsdt.base\n"                                                                                 \
+    "     .8byte 0\n"                                                                                              \
+    "     .asciz \"airlift\"\n"                                                                                    \
+    "     .asciz \"" #name "\"\n"                                                                                  \
+    "     .asciz \"" args "\"\n"                                                                                   \
+    "994: .balign 4\n"                                                                                             \
+    "     .popsection\n"                                                                                           \
+    "     .ifndef _.stapsdt.base\n"                                                                                \
+    "     .pushsection .stapsdt.base,\"aG\",\"progbits\",.stapsdt.base,comdat\n"                                   \
+    "     .weak _.stapsdt.base\n"                                                                                  \
+    "     .hidden _.stapsdt.base\n"                                                                                \
+    "_.stapsdt.base: .space 1\n"                                                                                   \
+    "     .size _.stapsdt.base, 1\n"                                                                               \
+    "     .popsection\n"                                                                                           \
+    "     .endif\n"
+
+/** \brief probe with two arguments */
+#define  AIRLIFT_PROBE2(name, a1, a2)                                                                             \
+    __asm__ __volatile__ (AIRLIFT_SDT_NOTE (name, "-4@%0 -4@%1") :: "nor" ((int) (a1)), "nor" ((int) (a2)))
+
+/** \brief probe with three arguments */
+#define  AIRLIFT_PROBE3(name, a1, a2, a3)                                                                         \
+    __asm__ __volatile__ (AIRLIFT_SDT_NOTE (name, "-4@%0 -4@%1 -4@%2")                                            \
+                          :: "nor" ((int) (a1)), "nor" ((int) (a2)), "nor" ((int) (a3)))
+
+#else
+
+/** \brief probe with two arguments */
+#define  AIRLIFT_PROBE2(name, a1, a2)          do { } while (0)
+
+/** \brief probe with three arguments */
+#define  AIRLIFT_PROBE3(name, a1, a2, a3)      do { } while (0)
+
+#endif
+
+#endif /* PROBES_H_ */
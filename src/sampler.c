@@ -0,0 +1,162 @@
+/**
+ *  \file sampler.c (implementation file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  Fixed-rate sampling of the full state of the problem.
+ *
+ *  Defined operations:
+ *     \li starting the sampler
+ *     \li stopping the sampler, after a last sample.
+ *
+ *  The sampler sleeps until absolute deadlines, so the period does not drift with the time taken by a sample.
+ *  Overruns (a deadline already passed) are skipped rather than sampled in bursts.
+ *  The sampler is forked without exec, so it leaves through _exit: the exit handlers belong to its parent.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "probConst.h"
+#include "probDataStruct.h"
+#include "sharedDataSync.h"
+#include "semaphore.h"
+#include "logging.h"
+#include "sampler.h"
+
+static void printSampleHeader (FILE *fic, unsigned int period)
+{
+    int p;
+
+    fprintf (fic, "# AirLift state samples, period %u us\n", period);
+    fprintf (fic, "%10s %3s %3s %4s %4s %4s %3s ", "time", "PT", "HT", "InQ", "InF", "toB", "nF");
+    for (p = 0; p < N; p++)
+        fprintf (fic, " P%02d", p);
+    fprintf (fic, "\n");
+}
+
+static void printSample (FILE *fic, unsigned long long time, FULL_STAT *p_fSt)
+{
+    int p;
+
+    fprintf (fic, "%10llu %3u %3u %4u %4u %4u %3u ", time, p_fSt->st.pilotStat, p_fSt->st.hostessStat,
+             p_fSt->nPassInQueue, p_fSt->nPassInFlight, p_fSt->totalPassBoarded, p_fSt->nFlight);
+    for (p = 0; p < N; p++)
+        fprintf (fic, "%4u", p_fSt->st.passengerStat[p]);
+    fprintf (fic, "\n");
+}
+
+static void addPeriod (struct timespec *t, unsigned int period)
+{
+    t->tv_nsec += (long) period * 1000;
+    while (t->tv_nsec >= 1000000000L) {
+        t->tv_nsec -= 1000000000L;
+        t->tv_sec++;
+    }
+}
+
+/* a consistent snapshot of the full state, taken inside the critical region */
+static void takeSample (FILE *fic, SHARED_DATA *sh, int semgid)
+{
+    FULL_STAT snap;
+    unsigned long long time;
+
+    if (semDown (semgid, sh->mutex) == -1) {
+        perror ("error on the down operation for semaphore access (SM)");
+        _exit (EXIT_FAILURE);
+    }
+    snap = sh->fSt;
+    time = elapsedTime (&sh->fSt);
+    if (semUp (semgid, sh->mutex) == -1) {
+        perror ("error on the up operation for semaphore access (SM)");
+        _exit (EXIT_FAILURE);
+    }
+    printSample (fic, time, &snap);
+}
+
+static void sampler (SHARED_DATA *sh, int semgid, unsigned int period, const char *nFic)
+{
+    struct timespec next, now;
+    FILE *fic;
+
+    if ((fic = fopen (nFic, "w")) == NULL) {
+        perror ("error on opening samples file");
+        _exit (EXIT_FAILURE);
+    }
+    printSampleHeader (fic, period);
+    clock_gettime (CLOCK_MONOTONIC, &next);
+    while (!sh->stopSampler) {
+        takeSample (fic, sh, semgid);
+        addPeriod (&next, period);
+        clock_gettime (CLOCK_MONOTONIC, &now);
+        while ((now.tv_sec > next.tv_sec) || ((now.tv_sec == next.tv_sec) && (now.tv_nsec > next.tv_nsec)))
+            addPeriod (&next, period);                                                         /* overrun: skipped */
+        while (clock_nanosleep (CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL) == EINTR)
+            ;
+    }
+    takeSample (fic, sh, semgid);                                                                   /* final state */
+    if (fclose (fic) == EOF) {
+        perror ("error on closing samples file");
+        _exit (EXIT_FAILURE);
+    }
+}
+
+/**
+ *  \brief Starting the sampler.
+ *
+ *  \param sh pointer to the shared memory region
+ *  \param semgid semaphore set identifier
+ *
+ *  \return process identifier of the sampler, upon success
+ *  \return \c 0, when sampling is not enabled
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+pid_t startSampler (SHARED_DATA *sh, int semgid)
+{
+    char *env = getenv ("AIRLIFT_SAMPLE"), *end;
+    unsigned long period;
+    pid_t pid;
+
+    if ((env == NULL) || ((period = strtoul (env, &end, 10)) == 0))
+        return 0;
+    sh->stopSampler = false;
+    if ((pid = fork ()) != 0)
+        return pid;
+    sampler (sh, semgid, (unsigned int) period, ((*end == ':') && (end[1] != '\0')) ? end + 1 : "samples");
+    _exit (EXIT_SUCCESS);                                               /* the exit handlers belong to the parent */
+}
+
+/**
+ *  \brief Stopping the sampler, after a last sample.
+ *
+ *  \param sh pointer to the shared memory region
+ *  \param pid process identifier of the sampler (nothing is done if \c 0)
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when the sampler failed (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int stopSampler (SHARED_DATA *sh, pid_t pid)
+{
+    int status;
+
+    if (pid == 0)
+        return 0;
+    sh->stopSampler = true;
+    if (waitpid (pid, &status, 0) == -1)
+        return -1;
+    if (!WIFEXITED (status) || (WEXITSTATUS (status) != EXIT_SUCCESS)) {
+        errno = ECHILD;
+        return -1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,55 @@
+/**
+ *  \file sampler.h (interface file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  Fixed-rate sampling of the full state of the problem.
+ *
+ *  When the environment variable <tt>AIRLIFT_SAMPLE</tt> is set to <tt>period[:file]</tt>, a sampler process takes
+ *  a consistent snapshot of the full state every <tt>period</tt> microseconds of real time (inside the critical
+ *  region) and writes it as a row of a time series to <tt>file</tt> (<em>samples</em> by default): time, pilot and
+ *  hostess states, number of passengers waiting, flying and boarded, flight number and passenger states.
+ *
+ *  Its cost only depends on the period, not on the number of passengers or on the rate of transitions, so it may
+ *  replace the state lines of the logging file (<tt>AIRLIFT_LOG_LEVEL=events</tt>).
+ *
+ *  Defined operations:
+ *     \li starting the sampler
+ *     \li stopping the sampler, after a last sample.
+ */
+
+#ifndef SAMPLER_H_
+#define SAMPLER_H_
+
+#include <sys/types.h>
+
+#include "sharedDataSync.h"
+
+/**
+ *  \brief Starting the sampler.
+ *
+ *  The sampler is a child process of the caller, which must already have signaled the start of operations.
+ *
+ *  \param sh pointer to the shared memory region
+ *  \param semgid semaphore set identifier
+ *
+ *  \return process identifier of the sampler, upon success
+ *  \return \c 0, when sampling is not enabled
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+extern pid_t startSampler (SHARED_DATA *sh, int semgid);
+
+/**
+ *  \brief Stopping the sampler, after a last sample.
+ *
+ *  \param sh pointer to the shared memory region
+ *  \param pid process identifier of the sampler (nothing is done if \c 0)
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when the sampler failed (the actual situation is reported in <tt>errno</tt>)
+ */
+
+extern int stopSampler (SHARED_DATA *sh, pid_t pid);
+
+#endif /* SAMPLER_H_ */
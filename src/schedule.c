@@ -0,0 +1,233 @@
+/**
+ *  \file schedule.c (implementation file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  Record and replay of the synchronization schedule.
+ *
+ *  Defined operations:
+ *     \li selecting the mode and loading a schedule to replay
+ *     \li enabling the record or the replay in an entity
+ *     \li saving a recorded schedule.
+ *
+ *  Recording, an entity returning from a <em>down</em> operation takes the next position and stores its event
+ *  there. Replaying, an entity about to execute a <em>down</em> operation waits until the next event is its own, and
+ *  moves past it once the operation returns; as only one entity is ever between both points, the operations return
+ *  in the recorded order. Every event an entity waits for was caused by events recorded before it, so the entity
+ *  whose turn it is never waits for an entity waiting for its own turn.
+ *
+ *  The schedule file is a text file: a header line with the number of passengers and one line per event, with the
+ *  entity id and the semaphore location.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <sched.h>
+
+#include "probConst.h"
+#include "probDataStruct.h"
+#include "semaphore.h"
+#include "schedule.h"
+
+/** \brief header line of a schedule file */
+#define  HEADER     "# airlift schedule: %u passengers\n"
+
+/** \brief schedule (NULL if not enabled in this process) */
+static SCHEDULE *sched = NULL;
+
+/** \brief entity id of this process */
+static unsigned int self;
+
+/** \brief turn of this process: position of the down operation under way (replay) */
+static unsigned int turn;
+
+/** \brief a down operation of this process under way in its turn (replay) */
+static bool inTurn = false;
+
+/** \brief name of the schedule file (generator) */
+static char nFic[256];
+
+/** \brief hook previously set */
+static SEM_HOOK prevHook = NULL;
+
+/* the replay given up */
+static void diverge (unsigned int pos, const char *why)
+{
+    if (!__atomic_exchange_n (&sched->diverged, true, __ATOMIC_ACQ_REL))
+        fprintf (stderr, "schedule replay given up at event %u of %u: %s\n", pos, sched->len, why);
+}
+
+/* waiting for the turn of a down operation on semaphore sindex */
+static void waitTurn (unsigned int sindex)
+{
+    unsigned int pos, last = ~0U, ev;
+    time_t since = 0;
+
+    while (!__atomic_load_n (&sched->diverged, __ATOMIC_ACQUIRE)) {
+        pos = __atomic_load_n (&sched->next, __ATOMIC_ACQUIRE);
+        if (pos >= sched->len)                                                         /* schedule over: free run */
+            return;
+        ev = sched->event[pos];
+        if ((ev >> 16) == self) {
+            if ((ev & 0xffff) != sindex)
+                diverge (pos, "another semaphore");
+            else {
+                turn = pos;
+                inTurn = true;
+            }
+            return;
+        }
+        if (pos != last) {
+            last = pos;
+            since = time (NULL);
+        }
+        else if (time (NULL) - since > SCHEDULE_STALL) {
+            diverge (pos, "stalled");
+            return;
+        }
+        sched_yield ();
+    }
+}
+
+static void hook (unsigned int point, unsigned int sindex)
+{
+    unsigned int pos;
+
+    if (prevHook != NULL)
+        prevHook (point, sindex);
+    if (sched->mode == SCHEDULE_RECORD) {
+        if (point == SEM_HOOK_DOWN_RETURN) {
+            pos = __atomic_fetch_add (&sched->next, 1, __ATOMIC_ACQ_REL);
+            if (pos < SCHEDULE_SIZE)
+                sched->event[pos] = (self << 16) | sindex;
+        }
+        return;
+    }
+    if (point == SEM_HOOK_DOWN)
+        waitTurn (sindex);
+    else if ((point == SEM_HOOK_DOWN_RETURN) && inTurn) {
+        inTurn = false;
+        __atomic_store_n (&sched->next, turn + 1, __ATOMIC_RELEASE);
+    }
+}
+
+/**
+ *  \brief Selecting the mode and loading a schedule to replay.
+ *
+ *  \param s pointer to the schedule, located in shared memory
+ *
+ *  \return \c 0, upon success (record and replay are disabled when <tt>AIRLIFT_SCHEDULE</tt> is not set)
+ *  \return -\c 1, when the mode is not known (<tt>errno</tt> is set to <tt>EINVAL</tt>), the schedule to replay can
+ *          not be read, or is not one of a run of this problem size (<tt>errno</tt> is set to <tt>EINVAL</tt>) or is
+ *          too long (<tt>errno</tt> is set to <tt>EFBIG</tt>)
+ */
+
+int scheduleSelect (SCHEDULE *s)
+{
+    char *env = getenv ("AIRLIFT_SCHEDULE");
+    unsigned int n, entity, sindex;
+    FILE *fic;
+    int r;
+
+    s->mode = 0;
+    s->len = s->next = 0;
+    s->diverged = false;
+    if ((env == NULL) || (*env == '\0'))
+        return 0;
+    if ((strncmp (env, "record:", 7) == 0) && (env[7] != '\0'))
+        s->mode = SCHEDULE_RECORD;
+    else if ((strncmp (env, "replay:", 7) == 0) && (env[7] != '\0'))
+        s->mode = SCHEDULE_REPLAY;
+    else {
+        errno = EINVAL;
+        return -1;
+    }
+    snprintf (nFic, sizeof (nFic), "%s", env + 7);
+    if (s->mode == SCHEDULE_RECORD)
+        return 0;
+
+    if ((fic = fopen (nFic, "r")) == NULL)
+        return -1;
+    if ((fscanf (fic, HEADER, &n) != 1) || (n != N)) {
+        fclose (fic);
+        errno = EINVAL;
+        return -1;
+    }
+    while ((r = fscanf (fic, "%u %u", &entity, &sindex)) == 2) {
+        if (s->len == SCHEDULE_SIZE) {
+            fclose (fic);
+            errno = EFBIG;
+            return -1;
+        }
+        if ((entity >= N + 2) || (sindex > 0xffff)) {
+            fclose (fic);
+            errno = EINVAL;
+            return -1;
+        }
+        s->event[s->len++] = (entity << 16) | sindex;
+    }
+    fclose (fic);
+    if (r != EOF) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ *  \brief Enabling the record or the replay in the calling entity.
+ *
+ *  Nothing is done when both are disabled.
+ *
+ *  \param s pointer to the schedule, located in shared memory
+ *  \param entity entity id
+ */
+
+void scheduleOpen (SCHEDULE *s, unsigned int entity)
+{
+    if (s->mode == 0)
+        return;
+    sched = s;
+    self = entity;
+    prevHook = semSetHook (hook);
+}
+
+/**
+ *  \brief Saving a recorded schedule.
+ *
+ *  Nothing is done when it is not being recorded.
+ *
+ *  \param s pointer to the schedule, located in shared memory
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when the file can not be written, or the schedule did not fit in <tt>SCHEDULE_SIZE</tt> events
+ *          (<tt>errno</tt> is set to <tt>EFBIG</tt>; the events that fit are saved)
+ */
+
+int scheduleSave (SCHEDULE *s)
+{
+    unsigned int k, len;
+    FILE *fic;
+
+    if (s->mode != SCHEDULE_RECORD)
+        return 0;
+    if ((fic = fopen (nFic, "w")) == NULL)
+        return -1;
+    len = (s->next < SCHEDULE_SIZE) ? s->next : SCHEDULE_SIZE;
+    fprintf (fic, HEADER, N);
+    for (k = 0; k < len; k++)
+        fprintf (fic, "%u %u\n", s->event[k] >> 16, s->event[k] & 0xffff);
+    if (fclose (fic) == EOF)
+        return -1;
+    if (s->next > SCHEDULE_SIZE) {
+        errno = EFBIG;
+        return -1;
+    }
+
+    return 0;
+}
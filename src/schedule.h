@@ -0,0 +1,78 @@
+/**
+ *  \file schedule.h (interface file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  Record and replay of the synchronization schedule.
+ *
+ *  When the environment variable <tt>AIRLIFT_SCHEDULE</tt> is set to <tt>record:file</tt>, the order in which the
+ *  intervening entities return from their <em>down</em> operations, so the order in which they acquire the critical
+ *  region and are woken up, is recorded (one atomic increment and one store per operation) and saved into the file
+ *  at the end of the run. When it is set to <tt>replay:file</tt>, that order is enforced on the run: an entity about
+ *  to execute a <em>down</em> operation waits for its turn in the schedule, so the shared state goes through the same
+ *  sequence of changes and a slow run, or a deadlock, can be run again under a profiler or a debugger. The travel and
+ *  flight times are not part of the schedule: running both runs with the same <tt>AIRLIFT_PERTURB</tt> seed (see
+ *  perturb.h) reproduces them too.
+ *
+ *  Should the replayed run take a different path (a program changed in between, a wait stalled for longer than
+ *  <tt>SCHEDULE_STALL</tt>), the replay is given up and the rest of the run is free.
+ *
+ *  Defined operations:
+ *     \li selecting the mode and loading a schedule to replay
+ *     \li enabling the record or the replay in an entity
+ *     \li saving a recorded schedule.
+ */
+
+#ifndef SCHEDULE_H_
+#define SCHEDULE_H_
+
+#include "probDataStruct.h"
+
+/** \brief mode: schedule recorded */
+#define  SCHEDULE_RECORD    1
+
+/** \brief mode: schedule replayed */
+#define  SCHEDULE_REPLAY    2
+
+/** \brief longest wait for a turn before the replay is given up (seconds) */
+#define  SCHEDULE_STALL     2
+
+/**
+ *  \brief Selecting the mode and loading a schedule to replay.
+ *
+ *  \param s pointer to the schedule, located in shared memory
+ *
+ *  \return \c 0, upon success (record and replay are disabled when <tt>AIRLIFT_SCHEDULE</tt> is not set)
+ *  \return -\c 1, when the mode is not known (<tt>errno</tt> is set to <tt>EINVAL</tt>), the schedule to replay can
+ *          not be read, or is not one of a run of this problem size (<tt>errno</tt> is set to <tt>EINVAL</tt>) or is
+ *          too long (<tt>errno</tt> is set to <tt>EFBIG</tt>)
+ */
+
+extern int scheduleSelect (SCHEDULE *s);
+
+/**
+ *  \brief Enabling the record or the replay in the calling entity.
+ *
+ *  Nothing is done when both are disabled.
+ *
+ *  \param s pointer to the schedule, located in shared memory
+ *  \param entity entity id
+ */
+
+extern void scheduleOpen (SCHEDULE *s, unsigned int entity);
+
+/**
+ *  \brief Saving a recorded schedule.
+ *
+ *  Nothing is done when it is not being recorded.
+ *
+ *  \param s pointer to the schedule, located in shared memory
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when the file can not be written, or the schedule did not fit in <tt>SCHEDULE_SIZE</tt> events
+ *          (<tt>errno</tt> is set to <tt>EFBIG</tt>; the events that fit are saved)
+ */
+
+extern int scheduleSave (SCHEDULE *s);
+
+#endif /* SCHEDULE_H_ */
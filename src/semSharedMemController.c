@@ -0,0 +1,403 @@
+/**
+ *  \file semSharedMemController.c (implementation file)
+ *
+ *  \brief Problem name: Air Lift
+ *
+ *  Synchronization based on semaphores and shared memory.
+ *  Implementation with SVIPC.
+ *
+ *  Definition of the operations carried out by the gate controller, a single process running the life cycles of
+ *  both the pilot and the hostess:
+ *     \li flight
+ *     \li startBoarding
+ *     \li waitForPassenger
+ *     \li checkPassport
+ *     \li endBoarding
+ *     \li dropPassengersAtTarget
+ *
+ *  The pilot and the hostess take turns within the process, so the handoffs between them (<tt>readyForBoarding</tt>
+ *  and <tt>readyToFlight</tt>) are no longer semaphore operations, and the state changes of both on each side of a
+ *  handoff are saved under a single hold of the mutex. The state transitions and the lines of the logging file are
+ *  those of the separate pilot and hostess, the probes telling the role of each. Records of the journal, stress
+ *  delays, the synchronization schedule and the latency sketches are those of the pilot entity.
+ *
+ *  It is run instead of the pilot and the hostess by the generator when <tt>AIRLIFT_FUSED</tt> is set.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <string.h>
+#include <math.h>
+
+#include "probConst.h"
+#include "probDataStruct.h"
+#include "logging.h"
+#include "probes.h"
+#include "phaseCounters.h"
+#include "causal.h"
+#include "perturb.h"
+#include "schedule.h"
+#include "sketch.h"
+#include "sharedDataSync.h"
+#include "semaphore.h"
+#include "sharedMemory.h"
+#include "journal.h"
+
+/** \brief logging file name */
+static char nFic[51];
+
+/** \brief shared memory block access identifier */
+static int shmid;
+
+/** \brief semaphore set access identifier */
+static int semgid;
+
+/** \brief pointer to shared memory region */
+static SHARED_DATA *sh;
+
+static void flight(bool go);
+static void startBoarding();
+static void waitForPassenger();
+static bool checkPassport();
+static void endBoarding();
+static void dropPassengersAtTarget();
+static void enter();
+static void leave();
+
+/**
+ *  \brief Main program.
+ *
+ *  Its role is to generate the life cycles of two of the intervening entities in the problem: the pilot and the
+ *  hostess.
+ */
+
+int main(int argc, char *argv[])
+{
+    int key;    /*access key to shared memory and semaphore set */
+    char *tinp; /* numerical parameters test flag */
+    JOURNAL *journal; /* journal of this process (NULL if none) */
+
+    /* validation of command line parameters */
+
+    if (argc != 4)
+    {
+        freopen("error_CT", "a", stderr);
+        fprintf(stderr, "Number of parameters is incorrect!\n");
+        return EXIT_FAILURE;
+    }
+    else
+        freopen(argv[3], "w", stderr);
+    strcpy(nFic, argv[1]);
+    key = (unsigned int)strtol(argv[2], &tinp, 0);
+    if (*tinp != '\0')
+    {
+        fprintf(stderr, "Error on the access key communication!\n");
+        return EXIT_FAILURE;
+    }
+
+    /* connection to the semaphore set and the shared memory region and mapping the shared region onto the
+       process address space */
+
+    if ((semgid = semConnect(key)) == -1)
+    {
+        perror("error on connecting to the semaphore set");
+        return EXIT_FAILURE;
+    }
+    if ((shmid = shmemConnect(key)) == -1)
+    {
+        perror("error on connecting to the shared memory region");
+        return EXIT_FAILURE;
+    }
+    if (shmemAttach(shmid, (void **)&sh) == -1)
+    {
+        perror("error on mapping the shared region on the process address space");
+        return EXIT_FAILURE;
+    }
+    setLogBuffer(&sh->logBuf); /* shared buffer of a compressed log */
+    if (journalOpen(sh, PILOT_ENTITY, &journal) == -1)
+    {
+        perror("error on attaching the journals (CT)");
+        exit(EXIT_FAILURE);
+    }
+    setLogJournal(journal, &sh->journalSeq); /* journal of this process, when enabled */
+    setLogControl(&sh->control); /* settings changed while running */
+    probeEntity = PILOT_ENTITY; /* entity id of the probes, switched with the role */
+    phaseOpen(sh->phase, sh->phaseEvents); /* performance counters per phase, when enabled */
+    causalOpen(&sh->causal); /* virtual speedup of causal profiling, when enabled */
+
+    srandom((unsigned int)getpid()); /* initialize random generator */
+    perturbOpen(PILOT_ENTITY); /* randomized delays of stress runs, when enabled */
+    scheduleOpen(&sh->schedule, PILOT_ENTITY); /* schedule record or replay, when enabled */
+    sketchOpen(&sh->sketches, SKETCH_PILOT); /* latency sketches, when enabled */
+
+    /* simulation of the life cycles of the pilot and the hostess */
+
+    bool lastPassengerInFlight;
+
+    enter(); /* the hostess waits for the first flight */
+    probeEntity = HOSTESS_ENTITY;
+    sh->fSt.st.hostessStat = WAIT_FOR_FLIGHT;
+    AIRLIFT_PROBE3(waitForNextFlight, probeEntity, sh->fSt.st.hostessStat, sh->fSt.nFlight);
+    saveState(nFic, &sh->fSt);
+    leave();
+
+    while (!sh->fSt.finished)
+    {
+        phaseBegin();
+        flight(false); // from target to origin
+        phaseEnd(PHASE_FLIGHT);
+        phaseBegin();
+        startBoarding();
+        phaseEnd(PHASE_SIGNALREADYFORBOARDING);
+        do
+        {
+            phaseBegin();
+            waitForPassenger();
+            phaseEnd(PHASE_WAITFORPASSENGER);
+            phaseBegin();
+            lastPassengerInFlight = checkPassport();
+            phaseEnd(PHASE_CHECKPASSPORT);
+        } while (!lastPassengerInFlight);
+        phaseBegin();
+        endBoarding();
+        phaseEnd(PHASE_SIGNALREADYTOFLIGHT);
+        phaseBegin();
+        flight(true); // from origin to target
+        phaseEnd(PHASE_FLIGHT);
+        phaseBegin();
+        dropPassengersAtTarget();
+        phaseEnd(PHASE_DROPPASSENGERS);
+    }
+
+    /* unmapping the shared region off the process address space */
+
+    if (shmemDettach(sh) == -1)
+    {
+        perror("error on unmapping the shared region off the process address space");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/**
+ *  \brief enter the critical region
+ */
+static void enter()
+{
+    waitLogRoom(nFic);
+    if (semDown(semgid, sh->mutex) == -1)
+    {
+        perror("error on the down operation for semaphore access (CT)");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ *  \brief leave the critical region
+ */
+static void leave()
+{
+    if (semUp(semgid, sh->mutex) == -1)
+    {
+        perror("error on the up operation for semaphore access (CT)");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ *  \brief flight.
+ *
+ *  The pilot takes passenger to destination (go) or
+ *  plane back to starting airport (return)
+ *  state should be saved.
+ *
+ *  \param go true if going to destination
+ */
+
+static void flight(bool go)
+{
+    double duration;
+
+    enter();
+    probeEntity = PILOT_ENTITY;
+    sh->fSt.st.pilotStat = go ? FLYING : FLYING_BACK;
+    if (go)
+        sh->sketches.tTakeoff = elapsedTime(&sh->fSt); //Takeoff, the end of the boarding wait of the passengers
+    AIRLIFT_PROBE3(flight, probeEntity, sh->fSt.st.pilotStat, sh->fSt.nFlight);
+    saveState(nFic, &sh->fSt);
+    saveControl(nFic, &sh->control); //Flight time in force, which may have been changed while running
+    duration = ((sh->control.maxFlight * random()) / RAND_MAX + 100.0) * sh->control.timeScale;
+    leave();
+
+    //Goes to sleep to simulate the travel time
+    usleep((unsigned int)floor(duration));
+}
+
+/**
+ *  \brief pilot signals ready for boarding and waits for the plane to get filled with passengers
+ *
+ *  The pilot updates its state twice, the flight number being updated in between; the hostess is the one
+ *  boarding the passengers, so there is nobody to signal nor to wait for.
+ *  The internal state should be saved after each update.
+ */
+
+static void startBoarding()
+{
+    enter();
+    probeEntity = PILOT_ENTITY;
+    sh->fSt.st.pilotStat = READY_FOR_BOARDING;
+    sh->fSt.nFlight++;
+    AIRLIFT_PROBE3(signalReadyForBoarding, probeEntity, sh->fSt.st.pilotStat, sh->fSt.nFlight);
+    saveState(nFic, &sh->fSt);
+    saveStartBoarding(nFic, &sh->fSt);
+
+    sh->fSt.st.pilotStat = WAITING_FOR_BOARDING;
+    AIRLIFT_PROBE3(waitUntilReadyToFlight, probeEntity, sh->fSt.st.pilotStat, sh->fSt.nFlight);
+    saveState(nFic, &sh->fSt);
+    leave();
+}
+
+/**
+ *  \brief hostess waits for passenger
+ *
+ *  hostess waits for passengers to arrive at airport.
+ *  The internal state should be saved.
+ */
+
+static void waitForPassenger()
+{
+    enter();
+    probeEntity = HOSTESS_ENTITY;
+    sh->fSt.st.hostessStat = WAIT_FOR_PASSENGER;
+    AIRLIFT_PROBE3(waitForPassenger, probeEntity, sh->fSt.st.hostessStat, sh->fSt.nFlight);
+    saveState(nFic, &sh->fSt);
+    leave();
+
+    //Wait till some passenger get into the queue
+    if (semDown(semgid, sh->passengersInQueue) == -1)
+    {
+        perror("error on the down operation for semaphore access (CT)");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ *  \brief passport check
+ *
+ *  The hostess checks passenger passport and waits for passenger to show id
+ *  The internal state should be saved twice.
+ *
+ *  \return should be true if this is the last passenger for this flight
+ *    that is:
+ *      - flight is at its maximum capacity
+ *      - flight is at or higher than minimum capacity and no passenger waiting
+ *      - no more passengers
+ */
+
+static bool checkPassport()
+{
+    bool last;
+
+    //Lets the first passenger of the queue show the id
+    if (semUp(semgid, sh->passengersWaitInQueue) == -1)
+    {
+        perror("error on the up operation for semaphore access (CT)");
+        exit(EXIT_FAILURE);
+    }
+    enter();
+    probeEntity = HOSTESS_ENTITY;
+    sh->fSt.st.hostessStat = CHECK_PASSPORT;
+    AIRLIFT_PROBE3(checkPassport, probeEntity, sh->fSt.st.hostessStat, sh->fSt.nFlight);
+    saveState(nFic, &sh->fSt);
+    leave();
+
+    //Wait till the passenger shows the ID
+    if (semDown(semgid, sh->idShown) == -1)
+    {
+        perror("error on the down operation for semaphore access (CT)");
+        exit(EXIT_FAILURE);
+    }
+    enter();
+    sh->fSt.totalPassBoarded++;
+    sh->fSt.nPassInQueue--;
+    sh->fSt.nPassInFlight++;
+    saveControl(nFic, &sh->control); //Capacities in force, which may have been changed while running
+    last = (sh->fSt.nPassInFlight >= sh->control.maxFC) ||
+           ((sh->control.minFC <= sh->fSt.nPassInFlight) && (sh->fSt.nPassInQueue == 0)) ||
+           (sh->fSt.totalPassBoarded == N);
+    saveState(nFic, &sh->fSt);
+    savePassengerChecked(nFic, &sh->fSt);
+    leave();
+
+    return last;
+}
+
+/**
+ *  \brief hostess signals boarding is complete and waits for the next flight
+ *
+ *  The hostess updates her state, registers the number of passengers in this flight and checks if the airlift is
+ *  finished (all passengers have boarded); the pilot takes off next, within the same process. Unless the airlift is
+ *  finished, the hostess then waits for the next flight.
+ *  The internal state should be saved after each update.
+ */
+
+static void endBoarding()
+{
+    enter();
+    probeEntity = HOSTESS_ENTITY;
+    sh->fSt.st.hostessStat = READY_TO_FLIGHT;
+    AIRLIFT_PROBE3(signalReadyToFlight, probeEntity, sh->fSt.st.hostessStat, sh->fSt.nFlight);
+    sh->fSt.nPassengersInFlight[sh->fSt.nFlight - 1] = sh->fSt.nPassInFlight;
+    if (sh->fSt.totalPassBoarded == N)
+        sh->fSt.finished = true;
+    saveState(nFic, &sh->fSt);
+    saveFlightDeparted(nFic, &sh->fSt);
+
+    if (!sh->fSt.finished)
+    {
+        sh->fSt.st.hostessStat = WAIT_FOR_FLIGHT;
+        AIRLIFT_PROBE3(waitForNextFlight, probeEntity, sh->fSt.st.hostessStat, sh->fSt.nFlight);
+        saveState(nFic, &sh->fSt);
+    }
+    leave();
+}
+
+/**
+ *  \brief pilot drops passengers at destination.
+ *
+ *  Pilot update its state and allows passengers to leave plane
+ *  Pilot must wait for all passengers to leave plane before starting to return.
+ *  The internal state should not be saved twice (after allowing passengeres to leave and after the plane is empty).
+ */
+
+static void dropPassengersAtTarget()
+{
+    enter();
+    probeEntity = PILOT_ENTITY;
+    sh->fSt.st.pilotStat = DROPING_PASSENGERS;
+    AIRLIFT_PROBE3(dropPassengersAtTarget, probeEntity, sh->fSt.st.pilotStat, sh->fSt.nFlight);
+    saveFlightArrived(nFic, &sh->fSt);
+    saveState(nFic, &sh->fSt);
+    leave();
+
+    //Lets the passengers leave the plane
+    if (semUp(semgid, sh->passengersWaitInFlight) == -1)
+    {
+        perror("error on the up operation for semaphore access (CT)");
+        exit(EXIT_FAILURE);
+    }
+
+    //Waits for the last passenger to flag it as empty
+    if (semDown(semgid, sh->planeEmpty) == -1)
+    {
+        perror("error on the down operation for semaphore access (CT)");
+        exit(EXIT_FAILURE);
+    }
+    enter();
+    saveFlightReturning(nFic, &(sh->fSt));
+    leave();
+}
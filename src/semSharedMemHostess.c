@@ -26,9 +26,16 @@
 #include "probConst.h"
 #include "probDataStruct.h"
 #include "logging.h"
+#include "probes.h"
+#include "phaseCounters.h"
+#include "causal.h"
+#include "perturb.h"
+#include "schedule.h"
+#include "sketch.h"
 #include "sharedDataSync.h"
 #include "semaphore.h"
 #include "sharedMemory.h"
+#include "journal.h"
 
 /** \brief logging file name */
 static char nFic[51];
@@ -70,6 +77,7 @@ int main(int argc, char *argv[])
 {
     int key;    /*access key to shared memory and semaphore set */
     char *tinp; /* numerical parameters test flag */
+    JOURNAL *journal; /* journal of this process (NULL if none) */
 
     /* validation of command line parameters */
 
@@ -108,8 +116,22 @@ int main(int argc, char *argv[])
         perror("error on mapping the shared region on the process address space");
         return EXIT_FAILURE;
     }
+    setLogBuffer(&sh->logBuf); /* shared buffer of a compressed log */
+    if (journalOpen(sh, HOSTESS_ENTITY, &journal) == -1)
+    {
+        perror("error on attaching the journals (HT)");
+        exit(EXIT_FAILURE);
+    }
+    setLogJournal(journal, &sh->journalSeq); /* journal of this entity, when enabled */
+    setLogControl(&sh->control); /* settings changed while running */
+    probeEntity = HOSTESS_ENTITY; /* entity id of the probes */
+    phaseOpen(sh->phase, sh->phaseEvents); /* performance counters per phase, when enabled */
+    causalOpen(&sh->causal); /* virtual speedup of causal profiling, when enabled */
 
     srandom((unsigned int)getpid()); /* initialize random generator */
+    perturbOpen(HOSTESS_ENTITY); /* randomized delays of stress runs, when enabled */
+    scheduleOpen(&sh->schedule, HOSTESS_ENTITY); /* schedule record or replay, when enabled */
+    sketchOpen(&sh->sketches, SKETCH_HOSTESS); /* latency sketches, when enabled */
 
     /* simulation of the life cycle of the hostess */
 
@@ -118,14 +140,22 @@ int main(int argc, char *argv[])
 
     while (nPassengers < N)
     {
+        phaseBegin();
         waitForNextFlight();
+        phaseEnd(PHASE_WAITFORNEXTFLIGHT);
         do
         {
+            phaseBegin();
             waitForPassenger();
+            phaseEnd(PHASE_WAITFORPASSENGER);
+            phaseBegin();
             lastPassengerInFlight = checkPassport();
+            phaseEnd(PHASE_CHECKPASSPORT);
             nPassengers++;
         } while (!lastPassengerInFlight);
+        phaseBegin();
         signalReadyToFlight();
+        phaseEnd(PHASE_SIGNALREADYTOFLIGHT);
     }
 
     /* unmapping the shared region off the process address space */
@@ -149,6 +179,7 @@ int main(int argc, char *argv[])
 
 static void waitForNextFlight()
 {   //Gonna use shared memory
+    waitLogRoom(nFic);
     if (semDown(semgid, sh->mutex) == -1)
     { 
         perror("error on the up operation for semaphore access (HT)");
@@ -156,6 +187,7 @@ static void waitForNextFlight()
     }
     //Updates the status of the hostess and save it
     sh->fSt.st.hostessStat = WAIT_FOR_FLIGHT;
+    AIRLIFT_PROBE3(waitForNextFlight, probeEntity, sh->fSt.st.hostessStat, sh->fSt.nFlight);
     saveState(nFic, &sh->fSt);
 
     //Stop using shared memory
@@ -182,6 +214,7 @@ static void waitForNextFlight()
 static void waitForPassenger()
 {
     //Gonna use memory
+    waitLogRoom(nFic);
     if (semDown(semgid, sh->mutex) == -1)
     {
         perror("error on the down operation for semaphore access (HT)");
@@ -189,6 +222,7 @@ static void waitForPassenger()
     }
     //Updates the status of the hostess and save it
     sh->fSt.st.hostessStat = WAIT_FOR_PASSENGER; 
+    AIRLIFT_PROBE3(waitForPassenger, probeEntity, sh->fSt.st.hostessStat, sh->fSt.nFlight);
     saveState(nFic, &sh->fSt);
     //Stop using shared memory
     if (semUp(semgid, sh->mutex) == -1)
@@ -228,6 +262,7 @@ static bool checkPassport()
         exit(EXIT_FAILURE);
     }
     //Gonna use shared memory
+    waitLogRoom(nFic);
     if (semDown(semgid, sh->mutex) == -1)
     {
         perror("error on the down operation for semaphore access (HT)");
@@ -235,6 +270,7 @@ static bool checkPassport()
     }
     //Updates the status of the hostess and save it
     sh->fSt.st.hostessStat = CHECK_PASSPORT;
+    AIRLIFT_PROBE3(checkPassport, probeEntity, sh->fSt.st.hostessStat, sh->fSt.nFlight);
     saveState(nFic, &sh->fSt); /* insert your code here */
 
     //Stop using shared memory
@@ -250,6 +286,7 @@ static bool checkPassport()
         exit(EXIT_FAILURE);
     }
     //Gonna use shared memory
+    waitLogRoom(nFic);
     if (semDown(semgid, sh->mutex) == -1)
     { 
         perror("error on the up operation for semaphore access (HT)");
@@ -261,7 +298,9 @@ static bool checkPassport()
     sh->fSt.nPassInFlight++;
 
     //A simple if statement to ensure that the minimum capacity of the plane will be respected
-    if (nPassengersInFlight() == MAXFC  || (MINFC  <= nPassengersInFlight() && nPassengersInQueue() == 0) || sh->fSt.totalPassBoarded == N )
+    //The capacities in force are read from the control block, which may have been changed while running
+    saveControl(nFic, &sh->control);
+    if (nPassengersInFlight() >= sh->control.maxFC  || (sh->control.minFC  <= nPassengersInFlight() && nPassengersInQueue() == 0) || sh->fSt.totalPassBoarded == N )
     {
         last = true;
     }
@@ -304,6 +343,7 @@ static int nPassengersInQueue()
 void signalReadyToFlight()
 {   
     //Gonna use shared memory
+    waitLogRoom(nFic);
     if (semDown(semgid, sh->mutex) == -1)
     {
         perror("error on the down operation for semaphore access (HT)");
@@ -311,6 +351,7 @@ void signalReadyToFlight()
     }
     //Updates some variables
     sh->fSt.st.hostessStat = READY_TO_FLIGHT; 
+    AIRLIFT_PROBE3(signalReadyToFlight, probeEntity, sh->fSt.st.hostessStat, sh->fSt.nFlight);
 
     sh->fSt.nPassengersInFlight[sh->fSt.nFlight - 1] = nPassengersInFlight();
 
@@ -25,9 +25,16 @@
 #include "probConst.h"
 #include "probDataStruct.h"
 #include "logging.h"
+#include "probes.h"
+#include "phaseCounters.h"
+#include "causal.h"
+#include "perturb.h"
+#include "schedule.h"
+#include "sketch.h"
 #include "sharedDataSync.h"
 #include "semaphore.h"
 #include "sharedMemory.h"
+#include "journal.h"
 
 /** \brief logging file name */
 static char nFic[51];
@@ -41,7 +48,10 @@ static int semgid;
 /** \brief pointer to shared memory region */
 static SHARED_DATA *sh;
 
-static bool travelToAirport();
+/** \brief time the passenger entered the queue and was called by the hostess (microseconds since the start) */
+static unsigned long long tInQueue, tChecked;
+
+static bool travelToAirport(unsigned int passengerId);
 static void waitInQueue(unsigned int passengerId);
 static void waitUntilDestination(unsigned int passengerId);
 
@@ -55,6 +65,7 @@ int main(int argc, char *argv[])
 {
     int key;    /*access key to shared memory and semaphore set */
     char *tinp; /* numerical parameters test flag */
+    JOURNAL *journal; /* journal of this process (NULL if none) */
     int n;
 
     /* validation of command line parameters */
@@ -100,14 +111,34 @@ int main(int argc, char *argv[])
         perror("error on mapping the shared region on the process address space");
         return EXIT_FAILURE;
     }
+    setLogBuffer(&sh->logBuf); /* shared buffer of a compressed log */
+    if (journalOpen(sh, PASSENGER_ENTITY(n), &journal) == -1)
+    {
+        perror("error on attaching the journals (PG)");
+        exit(EXIT_FAILURE);
+    }
+    setLogJournal(journal, &sh->journalSeq); /* journal of this entity, when enabled */
+    setLogControl(&sh->control); /* settings changed while running */
+    probeEntity = PASSENGER_ENTITY(n); /* entity id of the probes */
+    phaseOpen(sh->phase, sh->phaseEvents); /* performance counters per phase, when enabled */
+    causalOpen(&sh->causal); /* virtual speedup of causal profiling, when enabled */
 
     srandom((unsigned int)getpid()); /* initialize random generator */
+    perturbOpen(PASSENGER_ENTITY(n)); /* randomized delays of stress runs, when enabled */
+    scheduleOpen(&sh->schedule, PASSENGER_ENTITY(n)); /* schedule record or replay, when enabled */
+    sketchOpen(&sh->sketches, SKETCH_PASSENGER); /* latency sketches, when enabled */
 
     /* simulation of the life cycle of the passenger */
 
-    travelToAirport();
+    phaseBegin();
+    travelToAirport(n);
+    phaseEnd(PHASE_TRAVELTOAIRPORT);
+    phaseBegin();
     waitInQueue(n);
+    phaseEnd(PHASE_WAITINQUEUE);
+    phaseBegin();
     waitUntilDestination(n);
+    phaseEnd(PHASE_WAITUNTILDESTINATION);
 
     /* unmapping the shared region off the process address space */
 
@@ -124,12 +155,26 @@ int main(int argc, char *argv[])
 /**
  *  \brief passenger goes to airport
  *
- *  The passenger takes a random time to reach the airport
+ *  The passenger takes a random time to reach the airport, drawn from the travel time in force as it leaves,
+ *  or waits to be released by the arrival generator when it is enabled
+ *
+ *  \param passengerId passenger id
  */
 
-static bool travelToAirport()
+static bool travelToAirport(unsigned int passengerId)
 {
-    usleep((unsigned int)floor((MAXTRAVEL * random()) / RAND_MAX + 1000));
+    if (sh->arrivalTick != 0)
+    {
+        //Released at its arrival time, along with the passengers arriving in the same tick
+        if (semDown(semgid, ARRIVED(passengerId)) == -1)
+        {
+            perror("error on the down operation for semaphore access (PG)");
+            exit(EXIT_FAILURE);
+        }
+    }
+    else
+        usleep((unsigned int)floor(((sh->control.maxTravel * random()) / RAND_MAX + 1000) * sh->control.timeScale));
+    AIRLIFT_PROBE3(travelToAirport, probeEntity, GOING_TO_AIRPORT, 0);
 
     return true;
 }
@@ -154,6 +199,7 @@ static void waitInQueue(unsigned int passengerId)
     }
 
     //Gonna use the shared memory, flip the mutex down
+    waitLogRoom(nFic);
     if (semDown(semgid, sh->mutex) == -1)
     {
         perror("error on the down operation for semaphore access (PG)");
@@ -162,6 +208,8 @@ static void waitInQueue(unsigned int passengerId)
 
     sh->fSt.nPassInQueue++; //Increases the number of passenger in queue by one, themself
     sh->fSt.st.passengerStat[passengerId] = IN_QUEUE; //Changes their state to in queue
+    AIRLIFT_PROBE3(waitInQueue, probeEntity, sh->fSt.st.passengerStat[passengerId], sh->fSt.nFlight);
+    tInQueue = elapsedTime(&sh->fSt); //Time of arrival at the queue
     saveState(nFic, &sh->fSt); //Saves changes
 
     //Done with shared memory
@@ -179,6 +227,7 @@ static void waitInQueue(unsigned int passengerId)
     }
 
     //Gonna use shared memory again
+    waitLogRoom(nFic);
     if (semDown(semgid, sh->mutex) == -1)
     {
         perror("error on the down operation for semaphore access (PG)");
@@ -188,6 +237,10 @@ static void waitInQueue(unsigned int passengerId)
     //Gonna enter a flight...
     sh->fSt.passengerChecked = passengerId; //Marks down their passenger ID so the hostess knows who they are
     sh->fSt.st.passengerStat[passengerId] = IN_FLIGHT; //Changes their state
+    AIRLIFT_PROBE3(waitInQueue, probeEntity, sh->fSt.st.passengerStat[passengerId], sh->fSt.nFlight);
+    tChecked = elapsedTime(&sh->fSt); //Time of leaving the queue
+    sh->fSt.wait[passengerId] = tChecked - tInQueue;
+    sketchAdd(SKETCH_QUEUEWAIT, tChecked - tInQueue);
     saveState(nFic, &sh->fSt); //Save changes
 
     //Done with memory
@@ -226,6 +279,7 @@ static void waitUntilDestination(unsigned int passengerId)
     }
 
     //Gonna use shared memory
+    waitLogRoom(nFic);
     if (semDown(semgid, sh->mutex) == -1)
     {
         perror("error on the down operation for semaphore access (PG)");
@@ -235,6 +289,13 @@ static void waitUntilDestination(unsigned int passengerId)
     
     sh->fSt.nPassInFlight--;
     sh->fSt.st.passengerStat[passengerId] = AT_DESTINATION; /* insert your code here */
+    AIRLIFT_PROBE3(waitUntilDestination, probeEntity, sh->fSt.st.passengerStat[passengerId], sh->fSt.nFlight);
+    if (sh->sketches.enabled)
+    {
+        //Boarding wait up to the takeoff of this flight, trip from the queue to the destination
+        sketchAdd(SKETCH_BOARDINGWAIT, sh->sketches.tTakeoff - tChecked);
+        sketchAdd(SKETCH_TRIP, elapsedTime(&sh->fSt) - tInQueue);
+    }
 
     if (sh->fSt.nPassInFlight == 0)
     {
@@ -29,9 +29,16 @@
 #include "probConst.h"
 #include "probDataStruct.h"
 #include "logging.h"
+#include "probes.h"
+#include "phaseCounters.h"
+#include "causal.h"
+#include "perturb.h"
+#include "schedule.h"
+#include "sketch.h"
 #include "sharedDataSync.h"
 #include "semaphore.h"
 #include "sharedMemory.h"
+#include "journal.h"
 
 /** \brief logging file name */
 static char nFic[51];
@@ -61,6 +68,7 @@ int main(int argc, char *argv[])
 {
     int key;    /*access key to shared memory and semaphore set */
     char *tinp; /* numerical parameters test flag */
+    JOURNAL *journal; /* journal of this process (NULL if none) */
 
     /* validation of command line parameters */
 
@@ -98,18 +106,42 @@ int main(int argc, char *argv[])
         perror("error on mapping the shared region on the process address space");
         return EXIT_FAILURE;
     }
+    setLogBuffer(&sh->logBuf); /* shared buffer of a compressed log */
+    if (journalOpen(sh, PILOT_ENTITY, &journal) == -1)
+    {
+        perror("error on attaching the journals (PT)");
+        exit(EXIT_FAILURE);
+    }
+    setLogJournal(journal, &sh->journalSeq); /* journal of this entity, when enabled */
+    setLogControl(&sh->control); /* settings changed while running */
+    probeEntity = PILOT_ENTITY; /* entity id of the probes */
+    phaseOpen(sh->phase, sh->phaseEvents); /* performance counters per phase, when enabled */
+    causalOpen(&sh->causal); /* virtual speedup of causal profiling, when enabled */
 
     srandom((unsigned int)getpid()); /* initialize random generator */
+    perturbOpen(PILOT_ENTITY); /* randomized delays of stress runs, when enabled */
+    scheduleOpen(&sh->schedule, PILOT_ENTITY); /* schedule record or replay, when enabled */
+    sketchOpen(&sh->sketches, SKETCH_PILOT); /* latency sketches, when enabled */
 
     /* simulation of the life cycle of the pilot */
 
     while (!isFinished())
     {
+        phaseBegin();
         flight(false); // from target to origin
+        phaseEnd(PHASE_FLIGHT);
+        phaseBegin();
         signalReadyForBoarding();
+        phaseEnd(PHASE_SIGNALREADYFORBOARDING);
+        phaseBegin();
         waitUntilReadyToFlight();
+        phaseEnd(PHASE_WAITUNTILREADYTOFLIGHT);
+        phaseBegin();
         flight(true); // from origin to target
+        phaseEnd(PHASE_FLIGHT);
+        phaseBegin();
         dropPassengersAtTarget();
+        phaseEnd(PHASE_DROPPASSENGERS);
     }
 
     /* unmapping the shared region off the process address space */
@@ -144,7 +176,10 @@ static bool isFinished()
 
 static void flight(bool go)
 {
+    double duration;
+
     //Gonna use shared memory...
+    waitLogRoom(nFic);
     if (semDown(semgid, sh->mutex) == -1)
     {
         perror("error on the up operation for semaphore access (PT)");
@@ -153,10 +188,17 @@ static void flight(bool go)
 
     //Changes the pilots start in according to if it's going to a destination
     sh->fSt.st.pilotStat = go ? FLYING : FLYING_BACK;
+    if (go)
+        sh->sketches.tTakeoff = elapsedTime(&sh->fSt); //Takeoff, the end of the boarding wait of the passengers
+    AIRLIFT_PROBE3(flight, probeEntity, sh->fSt.st.pilotStat, sh->fSt.nFlight);
 
     //Changes the changes
     saveState(nFic, &sh->fSt);
 
+    //The flight time in force is read from the control block, which may have been changed while running
+    saveControl(nFic, &sh->control);
+    duration = ((sh->control.maxFlight * random()) / RAND_MAX + 100.0) * sh->control.timeScale;
+
     //Done with shared memory
     if (semUp(semgid, sh->mutex) == -1)
     {
@@ -165,7 +207,7 @@ static void flight(bool go)
     }
 
     //Goes to sleep to simulate the travel time
-    usleep((unsigned int)floor((MAXFLIGHT * random()) / RAND_MAX + 100.0));
+    usleep((unsigned int)floor(duration));
 }
 
 /**
@@ -179,6 +221,7 @@ static void flight(bool go)
 static void signalReadyForBoarding()
 {
     //Gonna use shared memory
+    waitLogRoom(nFic);
     if (semDown(semgid, sh->mutex) == -1)
     {
         perror("error on the up operation for semaphore access (PT)");
@@ -187,6 +230,7 @@ static void signalReadyForBoarding()
 
     sh->fSt.st.pilotStat = READY_FOR_BOARDING; //Ready for boarding, so changes the state accordingly
     sh->fSt.nFlight++; //Gonna travel some more, so increase the number of flights
+    AIRLIFT_PROBE3(signalReadyForBoarding, probeEntity, sh->fSt.st.pilotStat, sh->fSt.nFlight);
     saveState(nFic, &sh->fSt);  //save changes
     saveStartBoarding(nFic, &sh->fSt); //ditto
 
@@ -215,6 +259,7 @@ static void signalReadyForBoarding()
 static void waitUntilReadyToFlight()
 {
     //Gonna use shared memory
+    waitLogRoom(nFic);
     if (semDown(semgid, sh->mutex) == -1)
     {
         perror("error on the down operation for semaphore access (PT)");
@@ -222,6 +267,7 @@ static void waitUntilReadyToFlight()
     }
 
     sh->fSt.st.pilotStat = WAITING_FOR_BOARDING; //Changes state accordingly
+    AIRLIFT_PROBE3(waitUntilReadyToFlight, probeEntity, sh->fSt.st.pilotStat, sh->fSt.nFlight);
     saveState(nFic, &sh->fSt); //Save chanegs
 
     //DOne with shared memory for now
@@ -250,6 +296,7 @@ static void waitUntilReadyToFlight()
 static void dropPassengersAtTarget()
 {
     //Gonna use shared memory
+    waitLogRoom(nFic);
     if (semDown(semgid, sh->mutex) == -1)
     {
         perror("error on the down operation for semaphore access (PT)");
@@ -257,6 +304,7 @@ static void dropPassengersAtTarget()
     }
 
     sh->fSt.st.pilotStat = DROPING_PASSENGERS; //Changes the state accordingly
+    AIRLIFT_PROBE3(dropPassengersAtTarget, probeEntity, sh->fSt.st.pilotStat, sh->fSt.nFlight);
     saveFlightArrived(nFic, &sh->fSt); //Saves the state
     saveState(nFic, &sh->fSt); //Ditto
 
@@ -282,6 +330,7 @@ static void dropPassengersAtTarget()
     }
 
     //Gonna use shared memory again
+    waitLogRoom(nFic);
     if (semDown(semgid, sh->mutex) == -1)
     {
         perror("error on the down operation for semaphore access (PT)");
@@ -9,24 +9,160 @@
  *     \li destruction of a previously created set of semaphores
  *     \li signalling start of operations
  *     \li <em>down</em> of a semaphore within the set
- *     \li <em>up</em> of a semaphore within the set.
+ *     \li <em>up</em> of a semaphore within the set
+ *     \li batch of <em>down</em> and <em>up</em> operations within the set
+ *     \li setting the hook called around the <em>down</em> and <em>up</em> operations.
+ *
+ *  The kernel sets making up a set are found by every process: created by <tt>semCreate</tt>, probed for by
+ *  <tt>semConnect</tt> under the derived keys (the number of semaphores per kernel set being that of the first one).
+ *  The kernel limits are read with <tt>semctl (SEM_INFO)</tt>, which also tells the sets and semaphores in use.
+ *  The sets known are kept per thread, as the threads of a host process may each run a simulation (libairlift).
  *
  *  \author António Rui Borges - October 1995
  */
 
+#define _GNU_SOURCE                                                                                    /* seminfo */
+
 #include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <errno.h>
 #include <sys/types.h>
 #include <sys/ipc.h>
 #include <sys/sem.h>
 
+#include "semaphore.h"
+#include "probes.h"
+
 /** \brief access permission: user r-w */
 #define  MASK           0600
 
+/** \brief largest number of kernel sets of a set */
+#define  MAXSETS        256
+
+/** \brief largest number of sets known to a process */
+#define  MAXGROUPS      4
+
+/**
+ *  \brief Definition of <em>kernel sets</em> data type.
+ *
+ *  Kernel sets making up a set.
+ */
+typedef struct
+{ /** \brief identifier of the first kernel set: set identifier */
+    int semgid;
+    /** \brief number of semaphores per kernel set */
+    unsigned int perSet;
+    /** \brief number of kernel sets */
+    unsigned int nSets;
+    /** \brief kernel set identifiers */
+    int id[MAXSETS];
+
+} SHARDS;
+
+/** \brief sets known to this thread */
+static __thread SHARDS group[MAXGROUPS];
+
+/** \brief number of sets known to this thread */
+static __thread unsigned int nGroups = 0;
+
+/** \brief largest number of operations per call (0 if not read yet) */
+static __thread unsigned int opm = 0;
+
+/** \brief entity id carried by the probes of this process (-1 if not an intervening entity) */
+int probeEntity = -1;
+
+/** \brief hook called around the down and up operations (NULL if none) */
+static SEM_HOOK hook = NULL;
+
+/* creation key of kernel set k of a set */
+static key_t shardKey (int key, unsigned int k)
+{
+  return (key_t) ((unsigned int) key + k * 0x9e3779b9U);
+}
+
+/* kernel limits: semaphores per set, sets, semaphores, operations per call, less the sets and semaphores in use */
+static int limits (unsigned int *msl, unsigned int *mni, unsigned int *mns, unsigned int *opmax)
+{
+  struct seminfo info;
+  char *env = getenv ("AIRLIFT_SEMMSL");
+  FILE *fic;
+
+  if (semctl (0, 0, SEM_INFO, (struct seminfo *) &info) != -1)
+     { *msl = (unsigned int) info.semmsl;
+       *mni = (unsigned int) info.semmni - (unsigned int) info.semusz;
+       *mns = (unsigned int) info.semmns - (unsigned int) info.semaem;
+       *opmax = (unsigned int) info.semopm;
+     }
+     else if (((fic = fopen ("/proc/sys/kernel/sem", "r")) == NULL) ||
+              (fscanf (fic, "%u %u %u %u", msl, mns, opmax, mni) != 4))
+             { if (fic != NULL)
+                  fclose (fic);
+               return -1;
+             }
+             else fclose (fic);
+  if ((env != NULL) && (atoi (env) > 1) && ((unsigned int) atoi (env) < *msl))
+     *msl = (unsigned int) atoi (env);
+  return 0;
+}
+
+/* kernel sets of a set, NULL if not known (a single kernel set) */
+static SHARDS *shards (int semgid)
+{
+  static __thread SHARDS *last = NULL;
+  unsigned int g;
+
+  if ((last != NULL) && (last->semgid == semgid))
+     return last;
+  for (g = 0; g < nGroups; g++)
+    if (group[g].semgid == semgid)
+       return last = &group[g];
+  return NULL;
+}
+
+/* kernel set identifier and semaphore number of a semaphore location */
+static int locate (int semgid, unsigned int sindex, unsigned short *num)
+{
+  SHARDS *g = shards (semgid);
+
+  if ((g == NULL) || (sindex < g->perSet))
+     { *num = (unsigned short) sindex;
+       return semgid;
+     }
+  if (sindex / g->perSet >= g->nSets)
+     { errno = EINVAL;
+       return -1;
+     }
+  *num = (unsigned short) (sindex % g->perSet);
+  return g->id[sindex / g->perSet];
+}
+
+/* a set made known to this process */
+static SHARDS *remember (int semgid)
+{
+  SHARDS *g = shards (semgid);
+  unsigned int k;
+
+  for (k = 0; (g == NULL) && (k < nGroups); k++)                                     /* one of a destroyed set */
+    if (group[k].semgid == -1)
+       g = &group[k];
+  if (g == NULL)
+     { if (nGroups == MAXGROUPS)
+          { errno = ENOMEM;
+            return NULL;
+          }
+       g = &group[nGroups++];
+     }
+  g->semgid = semgid;
+  return g;
+}
+
 /**
  *  \brief Creation of a set of semaphores.
  *
  *  All semaphores in the set will be in set to <em>red state</em> upon creation.
- *  The function fails if there is already a semaphore set with a creation key equal to <tt>key</tt>.
+ *  The function fails if there is already a semaphore set with a creation key equal to <tt>key</tt>, and with
+ *  <tt>ENOSPC</tt> if the kernel limits can not be met.
  *
  *  \param key creation key
  *  \param snum number of semaphores in the set (>= 1)
@@ -37,7 +173,46 @@
 
 int semCreate (int key, unsigned int snum)
 {
-  return semget ((key_t) key, snum+1, MASK | IPC_CREAT | IPC_EXCL);
+  unsigned int total = snum + 1,                                      /* semaphores, with the start of operations one */
+               msl, mni, mns, perSet, nSets, k;
+  int id[MAXSETS], err;
+  SHARDS *g;
+
+  if (limits (&msl, &mni, &mns, &opm) == -1)
+     return -1;
+  perSet = (total < msl) ? total : msl;
+  nSets = (total + perSet - 1) / perSet;
+  if ((nSets > MAXSETS) || (nSets > mni) || (total > mns))
+     { errno = ENOSPC;
+       return -1;
+     }
+  if ((nSets > 1) && (key == IPC_PRIVATE))
+     { errno = EINVAL;
+       return -1;
+     }
+  for (k = 0; k < nSets; k++)
+    if ((id[k] = semget (shardKey (key, k), (k < nSets - 1) ? perSet : total - k * perSet,
+                         MASK | IPC_CREAT | IPC_EXCL)) == -1)
+       { err = errno;
+         while (k > 0)
+           semctl (id[--k], 0, IPC_RMID, NULL);
+         errno = err;
+         return -1;
+       }
+  if ((nSets > 1) && (semget (shardKey (key, nSets), 0, MASK) != -1))       /* stale kernel set past the last one */
+     err = EEXIST;
+     else if ((g = remember (id[0])) == NULL)
+             err = errno;
+             else { g->perSet = perSet;
+                    g->nSets = nSets;
+                    for (k = 0; k < nSets; k++)
+                      g->id[k] = id[k];
+                    return id[0];
+                  }
+  for (k = 0; k < nSets; k++)
+    semctl (id[k], 0, IPC_RMID, NULL);
+  errno = err;
+  return -1;
 }
 
 /**
@@ -55,12 +230,23 @@ int semConnect (int key)
 {
   int semgid;                                                                            /* semaphore set identifier */
   struct sembuf init[2] = {{ 0, -1, 0 }, {0, 1, 0}};                                     /* initialization operation */
+  struct semid_ds ds;                                                                   /* first kernel set status */
+  SHARDS *g;
+  int id;
 
   if ((semgid = semget ((key_t) key, 1, MASK)) == -1)
      return -1;
      else if (semop (semgid, init, 2) == -1)
              return -1;
-             else return semgid;
+  if (semctl (semgid, 0, IPC_STAT, &ds) == -1)
+     return -1;
+  if ((g = remember (semgid)) == NULL)
+     return -1;
+  g->perSet = (unsigned int) ds.sem_nsems;
+  g->id[0] = semgid;
+  for (g->nSets = 1; (g->nSets < MAXSETS) && ((id = semget (shardKey (key, g->nSets), 0, MASK)) != -1); g->nSets++)
+    g->id[g->nSets] = id;
+  return semgid;
 }
 
 /**
@@ -76,6 +262,14 @@ int semConnect (int key)
 
 int semDestroy (int semgid)
 {
+  SHARDS *g = shards (semgid);
+  unsigned int k;
+
+  if (g != NULL)
+     { for (k = 1; k < g->nSets; k++)
+         semctl (g->id[k], 0, IPC_RMID, NULL);
+       g->semgid = -1;
+     }
   return semctl (semgid, 0, IPC_RMID, NULL);
 }
 
@@ -112,9 +306,18 @@ int semSignal (int semgid)
 int semDown (int semgid, unsigned int sindex)
 {
   struct sembuf down = { 0, -1, 0 };                                                      /* specific down operation */
+  int id, stat;
 
-  down.sem_num = (unsigned short) sindex;
-  return semop (semgid, &down, 1);
+  if ((id = locate (semgid, sindex, &down.sem_num)) == -1)
+     return -1;
+  AIRLIFT_PROBE2 (sem_down, probeEntity, sindex);
+  if (hook != NULL)
+     hook (SEM_HOOK_DOWN, sindex);
+  stat = semop (id, &down, 1);
+  AIRLIFT_PROBE2 (sem_down_return, probeEntity, sindex);
+  if ((hook != NULL) && (stat == 0))
+     hook (SEM_HOOK_DOWN_RETURN, sindex);
+  return stat;
 }
 
 /**
@@ -132,7 +335,94 @@ int semDown (int semgid, unsigned int sindex)
 int semUp (int semgid, unsigned int sindex)
 {
   struct sembuf up = { 0, 1, 0 };                                                           /* specific up operation */
+  int id;
 
-  up.sem_num = (unsigned short) sindex;
-  return semop (semgid, &up, 1);
+  if ((id = locate (semgid, sindex, &up.sem_num)) == -1)
+     return -1;
+  AIRLIFT_PROBE2 (sem_up, probeEntity, sindex);
+  if (hook != NULL)
+     hook (SEM_HOOK_UP, sindex);
+  return semop (id, &up, 1);
+}
+
+/**
+ *  \brief Batch of <em>down</em> and <em>up</em> operations within the set.
+ *
+ *  The operations are grouped per kernel set, the groups being carried out one after the other in increasing order
+ *  of kernel set, so batches of several processes never wait on each other in a cycle. A group is carried out
+ *  atomically when it fits the kernel limit on operations per call, <tt>SEMOPM</tt>; a larger one is split in
+ *  consecutive calls, which is only allowed for groups of <em>up</em> operations (they never block, so the split
+ *  is not seen), as those of the arrival generator. The hook is not called. Batches of up to <tt>SEM_STACKOPS</tt>
+ *  operations are gathered on the stack, so no memory is allocated for them.
+ *  The function fails if there is no semaphore set with an identifier equal to <tt>semgid</tt>.
+ *
+ *  \param semgid set identifier
+ *  \param ops operations
+ *  \param nops number of operations
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>; <tt>E2BIG</tt> when a
+ *          group holding <em>down</em> operations exceeds <tt>SEMOPM</tt>)
+ */
+
+int semOps (int semgid, const SEM_OP *ops, unsigned int nops)
+{
+  SHARDS *g = shards (semgid);
+  unsigned int nSets = (g == NULL) ? 1 : g->nSets,
+               msl, mni, mns, k, s, n, done;
+  struct sembuf stackBuf[SEM_STACKOPS], *buf = stackBuf;                        /* operations on one kernel set */
+  unsigned short num;
+  int id = semgid, stat = 0;
+  bool down;
+
+  if ((opm == 0) && (limits (&msl, &mni, &mns, &opm) == -1))
+     return -1;
+  for (k = 0; k < nops; k++)
+    if ((g != NULL) && (ops[k].sindex / g->perSet >= g->nSets))
+       { errno = EINVAL;
+         return -1;
+       }
+  if ((nops > SEM_STACKOPS) && ((buf = malloc (nops * sizeof (struct sembuf))) == NULL))
+     return -1;
+  for (s = 0; (s < nSets) && (stat == 0); s++)
+    { for (k = n = 0, down = false; k < nops; k++)
+        if ((g == NULL) || (ops[k].sindex / g->perSet == s))
+           { if ((id = locate (semgid, ops[k].sindex, &num)) == -1)
+                { stat = -1;
+                  break;
+                }
+             buf[n].sem_num = num;
+             buf[n].sem_op = ops[k].op;
+             buf[n++].sem_flg = 0;
+             down = down || (ops[k].op < 0);
+           }
+      if ((stat == 0) && down && (n > opm))                                    /* would not be atomic when split */
+         { errno = E2BIG;
+           stat = -1;
+         }
+      for (done = 0; (done < n) && (stat == 0); done += opm)
+        stat = semop (id, buf + done, (n - done < opm) ? n - done : opm);
+    }
+  if (buf != stackBuf)
+     free (buf);
+  return stat;
+}
+
+/**
+ *  \brief Setting the hook called around the <em>down</em> and <em>up</em> operations.
+ *
+ *  The hook is called in the calling process only, after a <em>down</em> operation only when it succeeded. A hook
+ *  installed on top of another one is expected to call it.
+ *
+ *  \param h hook function (NULL if none)
+ *
+ *  \return hook previously set
+ */
+
+SEM_HOOK semSetHook (SEM_HOOK h)
+{
+  SEM_HOOK prev = hook;
+
+  hook = h;
+  return prev;
 }
@@ -9,7 +9,14 @@
  *     \li destruction of a previously created set of semaphores
  *     \li signalling start of operations
  *     \li <em>down</em> of a semaphore within the set
- *     \li <em>up</em> of a semaphore within the set.
+ *     \li <em>up</em> of a semaphore within the set
+ *     \li batch of <em>down</em> and <em>up</em> operations within the set
+ *     \li setting the hook called around the <em>down</em> and <em>up</em> operations.
+ *
+ *  A set is made of as many kernel semaphore sets as the kernel limits require, the semaphores being spread over
+ *  them, in order, behind a single index space and a single identifier, that of the first one. The kernel sets after
+ *  the first one are created under keys derived from the creation key. The environment variable
+ *  <tt>AIRLIFT_SEMMSL</tt> lowers the number of semaphores per kernel set, to exercise the spreading.
  *
  *  \author António Rui Borges - October 1995
  */
@@ -17,17 +24,46 @@
 #ifndef SEMAPHORE_H_
 #define SEMAPHORE_H_
 
+/* points of the hook */
+
+/** \brief before a <em>down</em> operation */
+#define  SEM_HOOK_DOWN           0
+/** \brief after a <em>down</em> operation (the caller was let through) */
+#define  SEM_HOOK_DOWN_RETURN    1
+/** \brief before an <em>up</em> operation */
+#define  SEM_HOOK_UP             2
+
+/** \brief largest batch of <tt>semOps</tt> gathered on the stack, larger ones in allocated memory */
+#define  SEM_STACKOPS           32
+
+/** \brief hook called around the <em>down</em> and <em>up</em> operations: point and semaphore location */
+typedef void (*SEM_HOOK) (unsigned int point, unsigned int sindex);
+
+/**
+ *  \brief Definition of <em>semaphore operation</em> data type.
+ */
+typedef struct
+{ /** \brief semaphore location in the set (1 .. snum) */
+    unsigned int sindex;
+    /** \brief operation: -1 (<em>down</em>) or 1 (<em>up</em>) */
+    short op;
+
+} SEM_OP;
+
 /**
  *  \brief Creation of a set of semaphores.
  *
  *  All semaphores in the set will be in set to <em>red state</em> upon creation.
- *  The function fails if there is already a semaphore set with a creation key equal to <tt>key</tt>.
+ *  The function fails if there is already a semaphore set with a creation key equal to <tt>key</tt>, or one derived
+ *  from it, and if the kernel limits on the number of semaphores per set (<tt>SEMMSL</tt>), of sets
+ *  (<tt>SEMMNI</tt>, at most 256 per set) or of semaphores (<tt>SEMMNS</tt>) can not be met.
  *
  *  \param key creation key
  *  \param snum number of semaphores in the set (>= 1)
  *
  *  \return set identifier, upon success
- *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>; <tt>ENOSPC</tt> when the
+ *          kernel limits can not be met)
  */
 
 extern int semCreate (int key, unsigned int snum);
@@ -99,4 +135,38 @@ extern int semDown (int semgid, unsigned int sindex);
 
 extern int semUp (int semgid, unsigned int sindex);
 
+/**
+ *  \brief Batch of <em>down</em> and <em>up</em> operations within the set.
+ *
+ *  The operations are grouped per kernel set, the groups being carried out one after the other in increasing order
+ *  of kernel set, so batches of several processes never wait on each other in a cycle. A group is carried out
+ *  atomically when it fits the kernel limit on operations per call, <tt>SEMOPM</tt>; a larger one is split in
+ *  consecutive calls, which is only allowed for groups of <em>up</em> operations (they never block, so the split
+ *  is not seen), as those of the arrival generator. The hook is not called.
+ *  The function fails if there is no semaphore set with an identifier equal to <tt>semgid</tt>.
+ *
+ *  \param semgid set identifier
+ *  \param ops operations
+ *  \param nops number of operations
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>; <tt>E2BIG</tt> when a
+ *          group holding <em>down</em> operations exceeds <tt>SEMOPM</tt>)
+ */
+
+extern int semOps (int semgid, const SEM_OP *ops, unsigned int nops);
+
+/**
+ *  \brief Setting the hook called around the <em>down</em> and <em>up</em> operations.
+ *
+ *  The hook is called in the calling process only, after a <em>down</em> operation only when it succeeded. A hook
+ *  installed on top of another one is expected to call it.
+ *
+ *  \param hook hook function (NULL if none)
+ *
+ *  \return hook previously set
+ */
+
+extern SEM_HOOK semSetHook (SEM_HOOK hook);
+
 #endif /* SEMAPHORE_H_ */
@@ -0,0 +1,201 @@
+/**
+ *  \file semaphoreSet.hpp (interface file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  Typed C++ layer over the semaphore set of the problem (optional, header only, C++17).
+ *
+ *  Defined entities:
+ *     \li <tt>Sem</tt>: the named semaphores of the set, as identified in sharedDataSync.h
+ *     \li <tt>Up</tt>, <tt>Down</tt>: single semaphore operations, resolved at compile time
+ *     \li <tt>Batch</tt>: a compile-time composition of operations into one <tt>semOps</tt> vector
+ *     \li <tt>SemaphoreSet</tt>: handle of a connected set, whose operations throw <tt>std::system_error</tt>
+ *     \li <tt>ScopedLock</tt>: guard holding a mutual exclusion semaphore for the lifetime of a scope.
+ *
+ *  Operation vectors are <tt>constexpr</tt> arrays of <tt>SEM_OP</tt>. A single operation is carried out by
+ *  <tt>semDown</tt> or <tt>semUp</tt> and a batch by <tt>semOps</tt>, so the code generated is the same as for a
+ *  hand-written call, no memory being allocated (a batch is not larger than <tt>SEM_STACKOPS</tt>), and the kernel
+ *  sets of a set spread over several, the probes and the hook (the latter only on single operations, as for
+ *  <tt>semOps</tt>) apply as in the C entities.
+ *
+ *  \code
+ *  airlift::SemaphoreSet sem = airlift::SemaphoreSet::connect (key);
+ *  {
+ *      airlift::ScopedLock<> lock (sem);                                   // down (mutex) ... up (mutex)
+ *      sh->fSt.nPassInQueue++;
+ *  }
+ *  sem.apply<airlift::Up<airlift::Sem::idShown>, airlift::Down<airlift::Sem::passengersWaitInFlight>> ();
+ *  \endcode
+ *
+ *  Beware that a batch is carried out atomically per kernel set (see semaphore.h): it blocks until every one of its
+ *  <em>down</em> operations on that set may proceed at once.
+ */
+
+#ifndef SEMAPHORESET_HPP_
+#define SEMAPHORESET_HPP_
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <system_error>
+
+#include "sharedDataSync.h"
+
+extern "C" {
+#include "semaphore.h"
+}
+
+namespace airlift {
+
+/**
+ *  \brief Named semaphores of the set.
+ */
+enum class Sem : unsigned short
+{ /** \brief critical region protection */
+    mutex                  = MUTEX,
+    /** \brief hostess waits for passengers */
+    passengersInQueue      = PASSENGERSINQUEUE,
+    /** \brief passengers wait for hostess */
+    passengersWaitInQueue  = PASSENGERSWAITINQUEUE,
+    /** \brief passengers wait for flight to end */
+    passengersWaitInFlight = PASSENGERSWAITINFLIGHT,
+    /** \brief hostess waits for starting boarding */
+    readyForBoarding       = READYFORBOARDING,
+    /** \brief pilot waits for boarding to complete */
+    readyToFlight          = READYTOFLIGHT,
+    /** \brief hostess waits for passenger identification */
+    idShown                = IDSHOWN,
+    /** \brief pilot waits for last passenger to leave plane */
+    planeEmpty             = PLANEEMPTY
+};
+
+/**
+ *  \brief <em>Up</em> of a named semaphore.
+ */
+template <Sem S>
+struct Up
+{ /** \brief operation */
+    static constexpr SEM_OP op = { static_cast<unsigned int> (S), 1 };
+};
+
+/**
+ *  \brief <em>Down</em> of a named semaphore.
+ */
+template <Sem S>
+struct Down
+{ /** \brief operation */
+    static constexpr SEM_OP op = { static_cast<unsigned int> (S), -1 };
+};
+
+/**
+ *  \brief Compile-time composition of operations into one <tt>semOps</tt> vector.
+ */
+template <class... Ops>
+struct Batch
+{
+    static_assert (sizeof... (Ops) > 0, "an empty batch is not an operation");
+    static_assert (sizeof... (Ops) <= SEM_STACKOPS, "a batch is gathered on the stack by semOps");
+
+    /** \brief number of operations */
+    static constexpr unsigned size = sizeof... (Ops);
+    /** \brief operation vector */
+    static constexpr SEM_OP ops[sizeof... (Ops)] = { Ops::op... };
+};
+
+/**
+ *  \brief Handle of a connected semaphore set.
+ *
+ *  The handle does not own the set: it is neither destroyed nor disconnected when the handle goes away.
+ */
+class SemaphoreSet
+{
+  public:
+    /** \brief wraps a set identifier obtained from semCreate or semConnect */
+    explicit SemaphoreSet (int semgid) noexcept : semgid_ (semgid) {}
+
+    /**
+     *  \brief Connection to a previously created set of semaphores.
+     *
+     *  \param key creation key
+     *
+     *  \throw std::system_error when the set does not exist
+     */
+    static SemaphoreSet connect (int key)
+    {
+        int semgid = semConnect (key);
+
+        if (semgid == -1)
+            throw std::system_error (errno, std::generic_category (), "error on connecting to the semaphore set");
+        return SemaphoreSet (semgid);
+    }
+
+    /** \brief set identifier */
+    int id () const noexcept { return semgid_; }
+
+    /**
+     *  \brief Carrying out a batch of operations: a single one by <tt>semDown</tt> or <tt>semUp</tt>, several by
+     *  <tt>semOps</tt>.
+     *
+     *  \throw std::system_error when the operation fails
+     */
+    template <class... Ops>
+    void apply () const
+    {
+        using B = Batch<Ops...>;
+        int stat;
+
+        if constexpr (B::size == 1)
+            stat = (B::ops[0].op < 0) ? semDown (semgid_, B::ops[0].sindex) : semUp (semgid_, B::ops[0].sindex);
+        else stat = semOps (semgid_, B::ops, B::size);
+        if (stat == -1)
+            throw std::system_error (errno, std::generic_category (), "error on a semaphore operation");
+    }
+
+    /** \brief <em>up</em> of a named semaphore */
+    template <Sem S>
+    void up () const { apply<Up<S>> (); }
+
+    /** \brief <em>down</em> of a named semaphore */
+    template <Sem S>
+    void down () const { apply<Down<S>> (); }
+
+  private:
+    /** \brief set identifier */
+    int semgid_;
+};
+
+/**
+ *  \brief Guard holding a mutual exclusion semaphore for the lifetime of a scope.
+ *
+ *  The release can not report an error by throwing, the destructor possibly running while an exception unwinds the
+ *  stack. As in the C entities, it is reported on <tt>stderr</tt> and the process terminates through <tt>exit</tt>,
+ *  on purpose: the destructors of the other objects of the enclosing scopes (and the handlers of an exception being
+ *  propagated) are skipped, since they would run with the critical region still held by the process.
+ */
+template <Sem M = Sem::mutex>
+class ScopedLock
+{
+  public:
+    /** \brief <em>down</em> of the semaphore (may throw) */
+    explicit ScopedLock (const SemaphoreSet &set) : set_ (set) { set_.down<M> (); }
+
+    /** \brief <em>up</em> of the semaphore */
+    ~ScopedLock ()
+    {
+        if (semUp (set_.id (), static_cast<unsigned int> (M)) == -1) {
+            perror ("error on the up operation for semaphore access");
+            exit (EXIT_FAILURE);
+        }
+    }
+
+    ScopedLock (const ScopedLock &) = delete;
+    ScopedLock &operator= (const ScopedLock &) = delete;
+
+  private:
+    /** \brief semaphore set */
+    const SemaphoreSet &set_;
+};
+
+} /* namespace airlift */
+
+#endif /* SEMAPHORESET_HPP_ */
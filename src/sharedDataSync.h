@@ -24,8 +24,36 @@
  *  \brief Definition of <em>shared information</em> data type.
  */
 typedef struct
-        { /** \brief full state of the problem */
+        { /** \brief journals enabled, in a segment of their own (first, whatever the number of passengers) */
+          bool journals;
+          /** \brief identification of the shared memory segment of the journals */
+          int journalShmid;
+          /** \brief full state of the problem */
           FULL_STAT fSt;
+          /** \brief lines of a compressed logging file not yet written */
+          LOG_BUFFER logBuf;
+          /** \brief request to the sampler process to take a last sample and terminate */
+          bool stopSampler;
+          /** \brief next global sequence number of a journal record */
+          unsigned long long journalSeq __attribute__ ((aligned (64)));
+          /** \brief request to the merger process to drain the journals and terminate */
+          bool stopMerger __attribute__ ((aligned (64)));
+          /** \brief events counted per lifecycle phase (0 when not enabled) */
+          unsigned int phaseEvents;
+          /** \brief performance counters of each lifecycle phase */
+          PHASE_STAT phase[NPHASES];
+          /** \brief virtual speedup of causal profiling */
+          CAUSAL causal;
+          /** \brief synchronization schedule, recorded or replayed */
+          SCHEDULE schedule;
+          /** \brief tick of the arrival generator (microseconds, 0 when the passengers sleep their travel time) */
+          unsigned int arrivalTick;
+          /** \brief seed of the arrival times drawn by the arrival generator */
+          unsigned long arrivalSeed;
+          /** \brief latency sketches */
+          SKETCHES sketches;
+          /** \brief settings changed while running */
+          CONTROL control;
 
           /* semaphores ids */
           /** \brief identification of critical region protection semaphore – val = 1 */
@@ -47,6 +75,15 @@ typedef struct
 
         } SHARED_DATA;
 
+/* entity ids: index of the journal and id carried by the probes of each intervening entity */
+
+/** \brief entity id of the pilot */
+#define  PILOT_ENTITY               0
+/** \brief entity id of the hostess */
+#define  HOSTESS_ENTITY             1
+/** \brief entity id of passenger <tt>p</tt> */
+#define  PASSENGER_ENTITY(p)        (2 + (p))
+
 /** \brief number of semaphores in the set */
 #define SEM_NU                    (8)
 
@@ -59,4 +96,7 @@ typedef struct
 #define IDSHOWN                    7
 #define PLANEEMPTY                 8
 
+/** \brief semaphore used by passenger <tt>p</tt> to wait for its release by the arrival generator - val = 0 */
+#define ARRIVED(p)                 (SEM_NU + 1 + (p))
+
 #endif /* SHAREDDATASYNC_H_ */
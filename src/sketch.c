@@ -0,0 +1,337 @@
+/**
+ *  \file sketch.c (implementation file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  Streaming latency sketches.
+ *
+ *  Defined operations:
+ *     \li selecting the sketches
+ *     \li opening the sketches of an entity
+ *     \li adding a sample
+ *     \li merging two sketches
+ *     \li quantile of a sketch
+ *     \li writing the report.
+ *
+ *  A sample is added with relaxed atomic operations: the count, the sum and its bucket are incremented, and the
+ *  extremes are updated by compare and swap, so no entity ever blocks on another. The semaphore latencies are taken
+ *  by hooking the entity to the semaphore operations.
+ *
+ *  Format of the report: a header line with the number of runs merged, and a line per sketch with samples, holding
+ *  the role, the metric, the unit, the count, the sum, the extremes, the mean and percentiles (informational, not
+ *  read back), and, after a bar, the <tt>bucket:count</tt> pairs of the buckets with samples.
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <time.h>
+
+#include "probConst.h"
+#include "probDataStruct.h"
+#include "semaphore.h"
+#include "sketch.h"
+
+/** \brief values below this bound have a bucket of their own */
+#define  EXACT           64
+
+/** \brief buckets per power of two above the exact range */
+#define  SUB             16
+
+/** \brief names of the roles */
+static const char *roleNames[NROLES] = { "pilot", "hostess", "passenger" };
+
+/** \brief names and units of the metrics */
+static const char *metricNames[NMETRICS] = { "queueWait", "boardingWait", "trip", "semWait", "mutexHold" },
+                  *metricUnits[NMETRICS] = { "us", "us", "us", "ns", "ns" };
+
+/** \brief sketches of the role of this process (NULL if not open) */
+static SKETCH *mine = NULL;
+
+/** \brief semaphore location of the critical region protection */
+static unsigned int mutexLoc;
+
+/** \brief start of the current down operation and of the current hold of the mutex */
+static unsigned long long tDown, tHeld;
+
+/** \brief hook previously set */
+static SEM_HOOK prevHook = NULL;
+
+/** \brief bucket of a value */
+static unsigned int bucketOf (unsigned int v)
+{
+    unsigned int k;
+
+    if (v < EXACT)
+        return v;
+    k = 31 - (unsigned int) __builtin_clz (v);                                              /* 6 .. 31 */
+    return EXACT + (k - 6) * SUB + ((v >> (k - 4)) & (SUB - 1));
+}
+
+/** \brief middle value of a bucket */
+static unsigned int bucketMid (unsigned int b)
+{
+    unsigned int k;
+
+    if (b < EXACT)
+        return b;
+    k = (b - EXACT) / SUB + 6;
+    return ((1u << k) | (((b - EXACT) % SUB) << (k - 4))) + ((1u << (k - 4)) - 1) / 2;
+}
+
+static unsigned long long timeNs (void)
+{
+    struct timespec t;
+
+    clock_gettime (CLOCK_MONOTONIC, &t);
+    return (unsigned long long) t.tv_sec * 1000000000ULL + (unsigned long long) t.tv_nsec;
+}
+
+static void add (SKETCH *sk, unsigned int v)
+{
+    unsigned int m;
+
+    __atomic_fetch_add (&sk->n, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add (&sk->sum, v, __ATOMIC_RELAXED);
+    __atomic_fetch_add (&sk->bucket[bucketOf (v)], 1, __ATOMIC_RELAXED);
+    m = __atomic_load_n (&sk->min, __ATOMIC_RELAXED);
+    while ((v < m) && !__atomic_compare_exchange_n (&sk->min, &m, v, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        ;
+    m = __atomic_load_n (&sk->max, __ATOMIC_RELAXED);
+    while ((v > m) && !__atomic_compare_exchange_n (&sk->max, &m, v, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        ;
+}
+
+/* nanoseconds elapsed, saturated to the range of a sample */
+static unsigned int since (unsigned long long t, unsigned long long now)
+{
+    return (now - t > UINT_MAX) ? UINT_MAX : (unsigned int) (now - t);
+}
+
+static void hook (unsigned int point, unsigned int sindex)
+{
+    unsigned long long now;
+
+    if (prevHook != NULL)
+        prevHook (point, sindex);
+    now = timeNs ();
+    switch (point) {
+        case SEM_HOOK_DOWN:
+            tDown = now;
+            break;
+        case SEM_HOOK_DOWN_RETURN:
+            add (&mine[SKETCH_SEMWAIT], since (tDown, now));
+            if (sindex == mutexLoc)
+                tHeld = now;
+            break;
+        case SEM_HOOK_UP:
+            if (sindex == mutexLoc)
+                add (&mine[SKETCH_MUTEXHOLD], since (tHeld, now));
+            break;
+    }
+}
+
+static void clear (SKETCH *sk)
+{
+    memset (sk, 0, sizeof (SKETCH));
+    sk->min = UINT_MAX;
+}
+
+/**
+ *  \brief Selecting the sketches.
+ *
+ *  \param s pointer to the sketches, located in shared memory
+ *  \param mutex semaphore location of the critical region protection
+ */
+
+void sketchSelect (SKETCHES *s, unsigned int mutex)
+{
+    char *env = getenv ("AIRLIFT_SKETCH");
+    unsigned int r, m;
+
+    for (r = 0; r < NROLES; r++)
+        for (m = 0; m < NMETRICS; m++)
+            clear (&s->sketch[r][m]);
+    s->tTakeoff = 0;
+    s->mutex = mutex;
+    s->enabled = (env != NULL) && (*env != '\0');
+}
+
+/**
+ *  \brief Opening the sketches of the calling entity.
+ *
+ *  \param s pointer to the sketches, located in shared memory
+ *  \param role role of the entity
+ */
+
+void sketchOpen (SKETCHES *s, unsigned int role)
+{
+    if (!s->enabled || (role >= NROLES))
+        return;
+    mine = s->sketch[role];
+    mutexLoc = s->mutex;
+    prevHook = semSetHook (hook);
+}
+
+/**
+ *  \brief Adding a sample to a metric of the calling entity.
+ *
+ *  \param metric metric
+ *  \param v sample, saturated to <tt>UINT_MAX</tt>
+ */
+
+void sketchAdd (unsigned int metric, unsigned long long v)
+{
+    if ((mine != NULL) && (metric < NMETRICS))
+        add (&mine[metric], (v > UINT_MAX) ? UINT_MAX : (unsigned int) v);
+}
+
+/**
+ *  \brief Merging two sketches.
+ *
+ *  \param dst pointer to the sketch the other one is added to
+ *  \param src pointer to the sketch added
+ */
+
+void sketchMerge (SKETCH *dst, const SKETCH *src)
+{
+    unsigned int b;
+
+    if (src->n == 0)
+        return;
+    dst->n += src->n;
+    dst->sum += src->sum;
+    if (src->min < dst->min)
+        dst->min = src->min;
+    if (src->max > dst->max)
+        dst->max = src->max;
+    for (b = 0; b < SKETCH_BUCKETS; b++)
+        dst->bucket[b] += src->bucket[b];
+}
+
+/**
+ *  \brief Quantile of a sketch.
+ *
+ *  \param sk pointer to the sketch
+ *  \param q order of the quantile (0 .. 1)
+ *
+ *  \return middle of the bucket holding the quantile, within the extremes (\c 0 if the sketch is empty)
+ */
+
+unsigned int sketchQuantile (const SKETCH *sk, double q)
+{
+    unsigned long long rank = (unsigned long long) (q * sk->n), acc = 0;
+    unsigned int b, v;
+
+    if (sk->n == 0)
+        return 0;
+    if ((rank < q * sk->n) || (rank == 0))                                              /* rounded up, from 1 */
+        rank++;
+    for (b = 0; b < SKETCH_BUCKETS - 1; b++)
+        if ((acc += sk->bucket[b]) >= rank)
+            break;
+    v = bucketMid (b);
+
+    return (v < sk->min) ? sk->min : (v > sk->max) ? sk->max : v;
+}
+
+/* sketches of a previous report merged in: number of runs, 0 if the file does not exist, -1 if it is not valid */
+static int load (const char *name, SKETCH (*sketch)[NMETRICS])
+{
+    FILE *fic;
+    char *line = NULL, role[16], metric[16], unit[4], *p;
+    size_t size = 0;
+    unsigned int runs = 0, r, m, b;
+    SKETCH sk;
+    int valid = 0;
+
+    if ((fic = fopen (name, "r")) == NULL)
+        return (errno == ENOENT) ? 0 : -1;
+    if ((getline (&line, &size, fic) != -1) && (sscanf (line, "# airlift latency sketches: %u runs", &runs) == 1))
+        valid = 1;
+    while (valid && (getline (&line, &size, fic) != -1)) {
+        if (line[0] == '#')
+            continue;
+        clear (&sk);
+        if ((sscanf (line, "%15s %15s %3s %llu %llu %u %u", role, metric, unit, &sk.n, &sk.sum, &sk.min,
+                     &sk.max) != 7) || ((p = strchr (line, '|')) == NULL)) {
+            valid = 0;
+            break;
+        }
+        for (r = 0; (r < NROLES) && (strcmp (role, roleNames[r]) != 0); r++)
+            ;
+        for (m = 0; (m < NMETRICS) && (strcmp (metric, metricNames[m]) != 0); m++)
+            ;
+        if ((r == NROLES) || (m == NMETRICS)) {
+            valid = 0;
+            break;
+        }
+        for (p++; (p = strchr (p, ' ')) != NULL; ) {
+            b = (unsigned int) strtoul (p + 1, &p, 10);
+            if ((*p != ':') || (b >= SKETCH_BUCKETS)) {
+                valid = 0;
+                break;
+            }
+            sk.bucket[b] = (unsigned int) strtoul (p + 1, &p, 10);
+        }
+        sketchMerge (&sketch[r][m], &sk);
+    }
+    free (line);
+    fclose (fic);
+    if (!valid) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    return (int) runs;
+}
+
+/**
+ *  \brief Writing the report.
+ *
+ *  \param s pointer to the sketches (nothing is written if they are not enabled)
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>; <tt>EINVAL</tt> if
+ *          the file exists but does not hold sketches)
+ */
+
+int sketchReport (SKETCHES *s)
+{
+    char *env = getenv ("AIRLIFT_SKETCH");
+    FILE *fic;
+    SKETCH *sk;
+    int runs;
+    unsigned int r, m, b;
+
+    if (!s->enabled || (env == NULL) || (*env == '\0'))
+        return 0;
+    if ((runs = load (env, s->sketch)) == -1)
+        return -1;
+    if ((fic = fopen (env, "w")) == NULL)
+        return -1;
+    fprintf (fic, "# airlift latency sketches: %d runs\n", runs + 1);
+    fprintf (fic, "# role metric unit n sum min max mean p50 p90 p99 p999 | bucket:count ...\n");
+    for (r = 0; r < NROLES; r++)
+        for (m = 0; m < NMETRICS; m++) {
+            if ((sk = &s->sketch[r][m])->n == 0)
+                continue;
+            fprintf (fic, "%s %s %s %llu %llu %u %u %.1f %u %u %u %u |", roleNames[r], metricNames[m],
+                     metricUnits[m], sk->n, sk->sum, sk->min, sk->max, (double) sk->sum / sk->n,
+                     sketchQuantile (sk, 0.50), sketchQuantile (sk, 0.90), sketchQuantile (sk, 0.99),
+                     sketchQuantile (sk, 0.999));
+            for (b = 0; b < SKETCH_BUCKETS; b++)
+                if (sk->bucket[b] != 0)
+                    fprintf (fic, " %u:%u", b, sk->bucket[b]);
+            fprintf (fic, "\n");
+        }
+    if (fclose (fic) == EOF)
+        return -1;
+
+    return 0;
+}
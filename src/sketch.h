@@ -0,0 +1,124 @@
+/**
+ *  \file sketch.h (interface file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  Streaming latency sketches.
+ *
+ *  When the environment variable <tt>AIRLIFT_SKETCH</tt> is set to a file name, every intervening entity adds its
+ *  latencies to log-linear histograms in shared memory, one per role and per metric, with atomic operations only:
+ *     \li passenger: wait in queue, from the arrival at the queue to the call by the hostess (us)
+ *     \li passenger: boarding wait, from the call by the hostess to the takeoff (us)
+ *     \li passenger: trip, from the arrival at the queue to the arrival at the destination (us)
+ *     \li every role: wait in a <em>down</em> operation (ns)
+ *     \li every role: hold of the critical region (ns).
+ *
+ *  The memory taken is fixed, whatever the number of passengers. Once the entities are over, the generator merges
+ *  the sketches with the ones already in the file, so the file accumulates the runs written to it, and writes
+ *  them back with their count, mean, extremes and percentiles.
+ *
+ *  Defined operations:
+ *     \li selecting the sketches
+ *     \li opening the sketches of an entity
+ *     \li adding a sample
+ *     \li merging two sketches
+ *     \li quantile of a sketch
+ *     \li writing the report.
+ */
+
+#ifndef SKETCH_H_
+#define SKETCH_H_
+
+#include "probConst.h"
+#include "probDataStruct.h"
+
+/* roles */
+
+/** \brief pilot */
+#define  SKETCH_PILOT          0
+/** \brief hostess */
+#define  SKETCH_HOSTESS        1
+/** \brief passengers */
+#define  SKETCH_PASSENGER      2
+
+/* metrics */
+
+/** \brief wait in queue (us) */
+#define  SKETCH_QUEUEWAIT      0
+/** \brief boarding wait (us) */
+#define  SKETCH_BOARDINGWAIT   1
+/** \brief trip (us) */
+#define  SKETCH_TRIP           2
+/** \brief wait in a down operation (ns) */
+#define  SKETCH_SEMWAIT        3
+/** \brief hold of the critical region (ns) */
+#define  SKETCH_MUTEXHOLD      4
+
+/**
+ *  \brief Selecting the sketches.
+ *
+ *  The sketches are emptied, and enabled when <tt>AIRLIFT_SKETCH</tt> is set.
+ *
+ *  \param s pointer to the sketches, located in shared memory
+ *  \param mutex semaphore location of the critical region protection
+ */
+
+extern void sketchSelect (SKETCHES *s, unsigned int mutex);
+
+/**
+ *  \brief Opening the sketches of the calling entity.
+ *
+ *  Nothing is done when they are not enabled.
+ *
+ *  \param s pointer to the sketches, located in shared memory
+ *  \param role role of the entity
+ */
+
+extern void sketchOpen (SKETCHES *s, unsigned int role);
+
+/**
+ *  \brief Adding a sample to a metric of the calling entity.
+ *
+ *  Nothing is done when the sketches are not open.
+ *
+ *  \param metric metric
+ *  \param v sample, saturated to <tt>UINT_MAX</tt>
+ */
+
+extern void sketchAdd (unsigned int metric, unsigned long long v);
+
+/**
+ *  \brief Merging two sketches.
+ *
+ *  \param dst pointer to the sketch the other one is added to
+ *  \param src pointer to the sketch added
+ */
+
+extern void sketchMerge (SKETCH *dst, const SKETCH *src);
+
+/**
+ *  \brief Quantile of a sketch.
+ *
+ *  \param sk pointer to the sketch
+ *  \param q order of the quantile (0 .. 1)
+ *
+ *  \return middle of the bucket holding the quantile, within the extremes (\c 0 if the sketch is empty)
+ */
+
+extern unsigned int sketchQuantile (const SKETCH *sk, double q);
+
+/**
+ *  \brief Writing the report.
+ *
+ *  The sketches are merged with the ones in the file named by <tt>AIRLIFT_SKETCH</tt>, if it exists.
+ *
+ *  \param s pointer to the sketches (nothing is written if they are not enabled)
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>; <tt>EINVAL</tt> if
+ *          the file exists but does not hold sketches)
+ */
+
+extern int sketchReport (SKETCHES *s);
+
+#endif /* SKETCH_H_ */
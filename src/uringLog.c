@@ -0,0 +1,313 @@
+/**
+ *  \file uringLog.c (implementation file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  Asynchronous writing of the logging file through io_uring.
+ *
+ *  Defined operations:
+ *     \li opening a file for asynchronous writing
+ *     \li submitting a write at a given offset
+ *     \li waiting for every write in flight to complete
+ *     \li closing the file.
+ *
+ *  A single ring per process, with <tt>QD</tt> registered buffers used round robin: write <tt>k</tt> goes to buffer
+ *  <tt>k % QD</tt>, which is only reused once write <tt>k - QD</tt> and all before it were retired.
+ *
+ *  The ring is set up for deferred task running: completions are only processed when the process waits for them
+ *  on the ring, never by notifying it, since a notification interrupts a blocked <tt>semop</tt>, which is fatal to
+ *  the intervening entities. Kernels without it (before 6.1) are reported as not supporting io_uring.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <linux/io_uring.h>
+
+#include "uringLog.h"
+
+/** \brief writes in flight */
+#define  QD              16
+
+/** \brief size of a registered buffer */
+#define  SLOT            4096
+
+/**
+ *  \brief Definition of <em>ring</em> data type.
+ */
+typedef struct
+{ /** \brief ring file descriptor */
+    int ring;
+    /** \brief file descriptor of the file written */
+    int fd;
+    /** \brief submission queue ring and entries */
+    void *sqPtr;
+    size_t sqSize;
+    unsigned int *sqTail, *sqMask, *sqArray;
+    struct io_uring_sqe *sqes;
+    size_t sqesSize;
+    /** \brief completion queue ring */
+    void *cqPtr;
+    size_t cqSize;
+    unsigned int *cqHead, *cqTail, *cqMask;
+    struct io_uring_cqe *cqes;
+    /** \brief registered buffers */
+    char *buf;
+    /** \brief writes submitted and writes retired */
+    unsigned long long submitted, retired;
+    /** \brief completion flag, length and offset of the write held by each buffer */
+    bool done[QD];
+    size_t len[QD];
+    long long off[QD];
+
+} RING;
+
+static RING r = { .ring = -1, .fd = -1 };
+
+static void release (void)
+{
+    if (r.buf != NULL)
+        munmap (r.buf, QD * SLOT);
+    if (r.sqes != NULL)
+        munmap (r.sqes, r.sqesSize);
+    if ((r.cqPtr != NULL) && (r.cqPtr != r.sqPtr))
+        munmap (r.cqPtr, r.cqSize);
+    if (r.sqPtr != NULL)
+        munmap (r.sqPtr, r.sqSize);
+    if (r.ring != -1)
+        close (r.ring);
+    if (r.fd != -1)
+        close (r.fd);
+    memset (&r, 0, sizeof (RING));
+    r.ring = r.fd = -1;
+}
+
+/* synchronous write of the whole block */
+static int writeAll (const char *data, size_t len, long long off)
+{
+    ssize_t n;
+
+    while (len > 0) {
+        if ((n = pwrite (r.fd, data, len, (off_t) off)) == -1) {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+        data += n;
+        len -= (size_t) n;
+        off += n;
+    }
+
+    return 0;
+}
+
+/* reaping the completions available; the buffers completed in submission order are retired */
+static int reap (void)
+{
+    unsigned int head = *r.cqHead, tail = __atomic_load_n (r.cqTail, __ATOMIC_ACQUIRE);
+    int stat = 0;
+
+    for (; head != tail; head++) {
+        struct io_uring_cqe *cqe = &r.cqes[head & *r.cqMask];
+        unsigned int k = (unsigned int) (cqe->user_data % QD);
+
+        if (cqe->res < 0) {
+            errno = -cqe->res;
+            stat = -1;
+        }
+        else if ((size_t) cqe->res < r.len[k])                                 /* short write: the rest in place */
+            if (writeAll (r.buf + k * SLOT + cqe->res, r.len[k] - (size_t) cqe->res, r.off[k] + cqe->res) == -1)
+                stat = -1;
+        r.done[k] = true;
+    }
+    __atomic_store_n (r.cqHead, head, __ATOMIC_RELEASE);
+    while ((r.retired < r.submitted) && r.done[r.retired % QD]) {
+        r.done[r.retired % QD] = false;
+        r.retired++;
+    }
+
+    return stat;
+}
+
+/* waiting until at most n writes are in flight */
+static int waitFor (unsigned long long n)
+{
+    while (r.submitted - r.retired > n) {
+        if (reap () == -1)
+            return -1;
+        if (r.submitted - r.retired <= n)
+            break;
+        if ((syscall (__NR_io_uring_enter, r.ring, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0) == -1) && (errno != EINTR))
+            return -1;
+    }
+
+    return 0;
+}
+
+/**
+ *  \brief Opening a file for asynchronous writing.
+ *
+ *  \param nFic name of the file
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when io_uring is not available or an error occurs (the actual situation is reported in
+ *          <tt>errno</tt>)
+ */
+
+int uringLogOpen (const char *nFic)
+{
+    struct io_uring_params p;
+    struct iovec iov[QD];
+    unsigned int k;
+    int err;
+
+    if ((r.ring != -1) && (uringLogClose () == -1))
+        return -1;
+    if ((r.fd = open (nFic, O_WRONLY | O_CLOEXEC)) == -1)
+        return -1;
+    memset (&p, 0, sizeof (p));
+    p.flags = IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_DEFER_TASKRUN;     /* completions never interrupt the process */
+    if ((r.ring = (int) syscall (__NR_io_uring_setup, QD, &p)) == -1)
+        goto fail;
+
+    /* rings and submission entries mapped in the process address space */
+
+    r.sqSize = p.sq_off.array + p.sq_entries * sizeof (unsigned int);
+    r.cqSize = p.cq_off.cqes + p.cq_entries * sizeof (struct io_uring_cqe);
+    if (p.features & IORING_FEAT_SINGLE_MMAP)
+        r.sqSize = r.cqSize = (r.sqSize > r.cqSize) ? r.sqSize : r.cqSize;
+    if ((r.sqPtr = mmap (NULL, r.sqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, r.ring,
+                         IORING_OFF_SQ_RING)) == MAP_FAILED) {
+        r.sqPtr = NULL;
+        goto fail;
+    }
+    if (p.features & IORING_FEAT_SINGLE_MMAP)
+        r.cqPtr = r.sqPtr;
+    else if ((r.cqPtr = mmap (NULL, r.cqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, r.ring,
+                              IORING_OFF_CQ_RING)) == MAP_FAILED) {
+        r.cqPtr = NULL;
+        goto fail;
+    }
+    r.sqesSize = p.sq_entries * sizeof (struct io_uring_sqe);
+    if ((r.sqes = mmap (NULL, r.sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, r.ring,
+                        IORING_OFF_SQES)) == MAP_FAILED) {
+        r.sqes = NULL;
+        goto fail;
+    }
+    r.sqTail = (unsigned int *) ((char *) r.sqPtr + p.sq_off.tail);
+    r.sqMask = (unsigned int *) ((char *) r.sqPtr + p.sq_off.ring_mask);
+    r.sqArray = (unsigned int *) ((char *) r.sqPtr + p.sq_off.array);
+    r.cqHead = (unsigned int *) ((char *) r.cqPtr + p.cq_off.head);
+    r.cqTail = (unsigned int *) ((char *) r.cqPtr + p.cq_off.tail);
+    r.cqMask = (unsigned int *) ((char *) r.cqPtr + p.cq_off.ring_mask);
+    r.cqes = (struct io_uring_cqe *) ((char *) r.cqPtr + p.cq_off.cqes);
+
+    /* registered buffers */
+
+    if ((r.buf = mmap (NULL, QD * SLOT, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)) == MAP_FAILED) {
+        r.buf = NULL;
+        goto fail;
+    }
+    for (k = 0; k < QD; k++) {
+        iov[k].iov_base = r.buf + k * SLOT;
+        iov[k].iov_len = SLOT;
+    }
+    if (syscall (__NR_io_uring_register, r.ring, IORING_REGISTER_BUFFERS, iov, QD) == -1)
+        goto fail;
+
+    return 0;
+
+fail:
+    err = errno;
+    release ();
+    errno = err;
+    return -1;
+}
+
+/**
+ *  \brief Submitting a write at a given offset.
+ *
+ *  \param data pointer to the data
+ *  \param len number of bytes
+ *  \param off offset in the file
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int uringLogWrite (const void *data, size_t len, long long off)
+{
+    struct io_uring_sqe *sqe;
+    unsigned int k, tail;
+
+    if (r.ring == -1) {
+        errno = EBADF;
+        return -1;
+    }
+    if (len > SLOT)
+        return writeAll (data, len, off);
+    if (waitFor (QD - 1) == -1)                                                          /* a free buffer */
+        return -1;
+
+    k = (unsigned int) (r.submitted % QD);
+    memcpy (r.buf + k * SLOT, data, len);
+    r.len[k] = len;
+    r.off[k] = off;
+    tail = *r.sqTail;
+    sqe = &r.sqes[tail & *r.sqMask];
+    memset (sqe, 0, sizeof (struct io_uring_sqe));
+    sqe->opcode = IORING_OP_WRITE_FIXED;
+    sqe->fd = r.fd;
+    sqe->addr = (unsigned long) (r.buf + k * SLOT);
+    sqe->len = (unsigned int) len;
+    sqe->off = (unsigned long long) off;
+    sqe->buf_index = (unsigned short) k;
+    sqe->user_data = r.submitted;
+    r.sqArray[tail & *r.sqMask] = tail & *r.sqMask;
+    __atomic_store_n (r.sqTail, tail + 1, __ATOMIC_RELEASE);
+    r.submitted++;
+    while (syscall (__NR_io_uring_enter, r.ring, 1, 0, 0, NULL, 0) == -1)
+        if (errno != EINTR)
+            return -1;
+
+    return 0;
+}
+
+/**
+ *  \brief Waiting for every write in flight to complete.
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when a write failed (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int uringLogDrain (void)
+{
+    if (r.ring == -1)
+        return 0;
+
+    return waitFor (0);
+}
+
+/**
+ *  \brief Closing the file, after every write in flight completed.
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when a write failed (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int uringLogClose (void)
+{
+    int stat = uringLogDrain (), err = errno;
+
+    release ();
+    errno = err;
+
+    return stat;
+}
@@ -0,0 +1,73 @@
+/**
+ *  \file uringLog.h (interface file)
+ *
+ *  \brief Problem name: Air Lift.
+ *
+ *  Asynchronous writing of the logging file through io_uring.
+ *
+ *  Writes are copied to one of a bounded number of registered buffers and submitted at an explicit file offset,
+ *  the caller never waiting for them unless every buffer is in flight. Buffers are retired in submission order.
+ *
+ *  Defined operations:
+ *     \li opening a file for asynchronous writing
+ *     \li submitting a write at a given offset
+ *     \li waiting for every write in flight to complete
+ *     \li closing the file.
+ *
+ *  Implemented with the raw system calls, no library is required.
+ */
+
+#ifndef URINGLOG_H_
+#define URINGLOG_H_
+
+#include <stddef.h>
+
+/**
+ *  \brief Opening a file for asynchronous writing.
+ *
+ *  The file must exist. A file previously opened is closed first.
+ *
+ *  \param nFic name of the file
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when io_uring is not available or an error occurs (the actual situation is reported in
+ *          <tt>errno</tt>)
+ */
+
+extern int uringLogOpen (const char *nFic);
+
+/**
+ *  \brief Submitting a write at a given offset.
+ *
+ *  The data is copied, so the caller may reuse it on return. Writes larger than a registered buffer are carried
+ *  out synchronously.
+ *
+ *  \param data pointer to the data
+ *  \param len number of bytes
+ *  \param off offset in the file
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+extern int uringLogWrite (const void *data, size_t len, long long off);
+
+/**
+ *  \brief Waiting for every write in flight to complete.
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when a write failed (the actual situation is reported in <tt>errno</tt>)
+ */
+
+extern int uringLogDrain (void);
+
+/**
+ *  \brief Closing the file, after every write in flight completed.
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when a write failed (the actual situation is reported in <tt>errno</tt>)
+ */
+
+extern int uringLogClose (void);
+
+#endif /* URINGLOG_H_ */